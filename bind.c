@@ -76,6 +76,9 @@ PGAPI_BindParameter(HSTMT hstmt,
 	apdopts->parameters[ipar].used =
 	apdopts->parameters[ipar].indicator = pcbValue;
 	apdopts->parameters[ipar].CType = fCType;
+	/* the type the server told us is for the former SQL type */
+	if (ipdopts->parameters[ipar].SQLType != fSqlType)
+		PIC_set_pgtype(ipdopts->parameters[ipar], 0);
 	ipdopts->parameters[ipar].SQLType = fSqlType;
 	ipdopts->parameters[ipar].paramType = fParamType;
 	ipdopts->parameters[ipar].column_size = cbColDef;
@@ -334,6 +337,8 @@ PGAPI_DescribeParam(HSTMT hstmt,
 		SC_log_error(func, "", NULL);
 		return SQL_INVALID_HANDLE;
 	}
+	if (SC_async_busy(stmt, func))
+		return SQL_ERROR;
 	conn = SC_get_conn(stmt);
 	SC_clear_error(stmt);
 
@@ -442,6 +447,8 @@ PGAPI_NumParams(HSTMT hstmt,
 		SC_log_error(func, "", NULL);
 		return SQL_INVALID_HANDLE;
 	}
+	if (SC_async_busy(stmt, func))
+		return SQL_ERROR;
 
 	if (pcpar)
 		*pcpar = 0;
@@ -1021,6 +1028,151 @@ void	reset_a_putdata_info(PutDataInfo *pdata_info, int ipar)
 	pdata_info->pdata[ipar].lobj_oid = 0;
 }
 
+void ExecParamsInfoInitialize(ExecParamsInfo *eparams)
+{
+	pg_memset(eparams, 0, sizeof(ExecParamsInfo));
+}
+
+/*
+ *	Make room for num_params parameters. The arrays are never shrunk
+ *	so that repeated executions don't malloc/free them each time.
+ */
+BOOL
+extend_execparams_info(ExecParamsInfo *self, int num_params)
+{
+	OID	*new_types;
+	char	**new_values;
+	int	*new_lengths, *new_formats;
+
+	if (self->allocated >= num_params)
+		return TRUE;
+	MYLOG(0, "entering ... self=%p, allocated=%d, num_params=%d\n", self, self->allocated, num_params);
+	if (new_types = (OID *) realloc(self->paramTypes, sizeof(OID) * num_params), NULL == new_types)
+		return FALSE;
+	self->paramTypes = new_types;
+	if (new_values = (char **) realloc(self->paramValues, sizeof(char *) * num_params), NULL == new_values)
+		return FALSE;
+	self->paramValues = new_values;
+	if (new_lengths = (int *) realloc(self->paramLengths, sizeof(int) * num_params), NULL == new_lengths)
+		return FALSE;
+	self->paramLengths = new_lengths;
+	if (new_formats = (int *) realloc(self->paramFormats, sizeof(int) * num_params), NULL == new_formats)
+		return FALSE;
+	self->paramFormats = new_formats;
+	self->allocated = num_params;
+
+	return TRUE;
+}
+
+/*
+ *	Make sure valbuf can hold size bytes. Note that valbuf may move,
+ *	so pointers into it must be (re)calculated afterwards.
+ */
+BOOL
+EPARAMS_reserve_values(ExecParamsInfo *self, size_t size)
+{
+	char	*new_buf;
+	size_t	new_size;
+
+	if (self->valbuf_size >= size)
+		return TRUE;
+	for (new_size = (self->valbuf_size > 0 ? self->valbuf_size : 128); new_size < size; new_size *= 2)
+		;
+	if (new_buf = (char *) realloc(self->valbuf, new_size), NULL == new_buf)
+		return FALSE;
+	self->valbuf = new_buf;
+	self->valbuf_size = new_size;
+
+	return TRUE;
+}
+
+void
+EPARAMS_free(ExecParamsInfo *self)
+{
+	if (self->paramTypes)
+		free(self->paramTypes);
+	if (self->paramValues)
+		free(self->paramValues);
+	if (self->paramLengths)
+		free(self->paramLengths);
+	if (self->paramFormats)
+		free(self->paramFormats);
+	if (self->valbuf)
+		free(self->valbuf);
+	if (self->vcache)
+	{
+		int	i;
+
+		for (i = 0; i < self->vcache_allocated; i++)
+		{
+			if (self->vcache[i].data)
+				free(self->vcache[i].data);
+		}
+		free(self->vcache);
+	}
+	ExecParamsInfoInitialize(self);
+}
+
+/*
+ *	Get the value cache of the ipar'th (0-based) parameter,
+ *	allocating the cache entries as needed.
+ */
+ParamValueCache *
+EPARAMS_get_vcache(ExecParamsInfo *self, int ipar)
+{
+	if (ipar < 0)
+		return NULL;
+	if (self->vcache_allocated <= ipar)
+	{
+		ParamValueCache	*new_vcache;
+		int	new_alloc = ipar + 1;
+
+		if (new_alloc < self->allocated)
+			new_alloc = self->allocated;
+		new_vcache = (ParamValueCache *) realloc(self->vcache, sizeof(ParamValueCache) * new_alloc);
+		if (!new_vcache)
+			return NULL;
+		pg_memset(&new_vcache[self->vcache_allocated], 0,
+			sizeof(ParamValueCache) * (new_alloc - self->vcache_allocated));
+		self->vcache = new_vcache;
+		self->vcache_allocated = new_alloc;
+	}
+
+	return self->vcache + ipar;
+}
+
+/*
+ *	Remember the client data (raw) of a parameter and the value
+ *	it was converted to (encoded). The caller sets the other members.
+ */
+BOOL
+PVCACHE_save(ParamValueCache *self, const char *raw, SQLLEN rawlen, const char *encoded, SQLLEN encodedlen)
+{
+	size_t	need = rawlen + encodedlen;
+
+	self->valid = FALSE;
+	if (rawlen < 0 || encodedlen < 0)
+		return FALSE;
+	if (self->allocated < need || NULL == self->data)
+	{
+		char	*new_data;
+
+		if (need < 32)
+			need = 32;
+		if (new_data = (char *) realloc(self->data, need), NULL == new_data)
+			return FALSE;
+		self->data = new_data;
+		self->allocated = need;
+	}
+	memcpy(self->data, raw, rawlen);
+	memcpy(self->data + rawlen, encoded, encodedlen);
+	self->rawlen = rawlen;
+	self->encodedlen = encodedlen;
+	self->valid = TRUE;
+
+	return TRUE;
+}
+
 void SC_param_next(const StatementClass *stmt, int *param_number, ParameterInfoClass **apara, ParameterImplClass **ipara)
 {
 	int	next;
@@ -97,6 +97,46 @@ typedef struct
 	PutDataClass	*pdata;
 }	PutDataInfo;
 
+/*
+ * ParamValueCache -- the value last sent for a parameter, together with
+ * the client data it was converted from. When CacheParamValues is on, a
+ * parameter whose client data and types are unchanged reuses the value
+ * instead of being converted again.
+ */
+typedef struct
+{
+	char	valid;
+	char	isbinary;
+	char	bypgtype;	/* converted according to the server side type */
+	SQLSMALLINT	ctype;
+	SQLSMALLINT	sqltype;
+	SQLSMALLINT	precision;
+	OID	pgtype;
+	OID	sent_pgtype;	/* the type the value was sent as */
+	SQLLEN	rawlen;		/* length of the client data */
+	SQLLEN	encodedlen;	/* length of the converted value */
+	char	*data;		/* the client data followed by the value */
+	size_t	allocated;	/* allocated size of data */
+}	ParamValueCache;
+
+/*
+ * ExecParamsInfo -- the parameter arrays passed to PQexecParams() or
+ * PQexecPrepared(). They belong to the statement and are reused across
+ * executions, growing only when a larger parameter set arrives.
+ */
+typedef struct
+{
+	int	allocated;	/* # of entries of the arrays below */
+	OID	*paramTypes;
+	char	**paramValues;	/* point into valbuf (or NULL) */
+	int	*paramLengths;
+	int	*paramFormats;
+	char	*valbuf;	/* the parameter values, each '\0' terminated */
+	size_t	valbuf_size;	/* allocated size of valbuf */
+	int	vcache_allocated;
+	ParamValueCache	*vcache;	/* per parameter (CacheParamValues) */
+}	ExecParamsInfo;
+
 #define	PARSE_PARAM_CAST	FALSE
 #define	EXEC_PARAM_CAST		TRUE
 #define	SIMPLE_PARAM_CAST	TRUE
@@ -125,10 +165,17 @@ void	PutDataInfoInitialize(PutDataInfo *pdata);
 void	extend_putdata_info(PutDataInfo *pdata, int num_params, BOOL shrink);
 void	reset_a_putdata_info(PutDataInfo *pdata, int ipar);
 void	PDATA_free_params(PutDataInfo *pdata, char option);
+void	ExecParamsInfoInitialize(ExecParamsInfo *eparams);
+BOOL	extend_execparams_info(ExecParamsInfo *eparams, int num_params);
+BOOL	EPARAMS_reserve_values(ExecParamsInfo *eparams, size_t size);
+void	EPARAMS_free(ExecParamsInfo *eparams);
+ParamValueCache	*EPARAMS_get_vcache(ExecParamsInfo *eparams, int ipar);
+BOOL	PVCACHE_save(ParamValueCache *vcache, const char *raw, SQLLEN rawlen, const char *encoded, SQLLEN encodedlen);
 void	SC_param_next(const StatementClass*, int *param_number, ParameterInfoClass **, ParameterImplClass **);
 
 RETCODE       prepareParameters(StatementClass *stmt, BOOL fake_params);
 RETCODE       prepareParametersNoDesc(StatementClass *stmt, BOOL fake_params, BOOL param_cast);
+RETCODE       desc_params_and_sync(StatementClass *stmt);
 int	decideHowToPrepare(StatementClass *stmt, BOOL force);
 
 #endif
@@ -27,11 +27,12 @@
 #include <string.h>
 #include <ctype.h>
 
-/* for htonl */
+/* for htonl and poll */
 #ifdef WIN32
 #include <Winsock2.h>
 #else
 #include <arpa/inet.h>
+#include <poll.h>
 #endif
 
 #include "environ.h"
@@ -50,10 +51,13 @@
 #define STMT_INCREMENT 16		/* how many statement holders to allocate
 								 * at a time */
 
-static SQLRETURN CC_lookup_lo(ConnectionClass *self);
 static int  CC_close_eof_cursors(ConnectionClass *self);
+static void remove_cursor_statement(ConnectionClass *self, StatementClass *stmt);
 
-static void LIBPQ_update_transaction_status(ConnectionClass *self);
+static RETCODE CC_async_query(ConnectionClass *self, const char *query, QResultClass **result);
+static int take_marked_objects(ConnectionClass *conn, PQExpBufferData *buf, BOOL ahead, char ***discardp);
+static void return_marked_objects(ConnectionClass *conn, char **discardp, int cnt, int done);
+static BOOL query_may_follow_discard(const char *query);
 
 
 static void CC_set_error_if_not_set(ConnectionClass *self, int errornumber, const char *errormsg, const char *func)
@@ -138,6 +142,10 @@ PGAPI_Connect(HDBC hdbc,
 		return SQL_INVALID_HANDLE;
 	}
 
+	/* called again to complete an asynchronous connect */
+	if (CC_is_async_connecting(conn))
+		goto connect;
+
 	ci = &conn->connInfo;
 	CC_conninfo_init(ci, INIT_GLOBALS);
 
@@ -168,12 +176,15 @@ PGAPI_Connect(HDBC hdbc,
 
 	MYLOG(0, "conn = %p (DSN='%s', UID='%s', PWD='%s')\n", conn, ci->dsn, ci->username, NAME_IS_VALID(ci->password) ? "xxxxx" : "");
 
+connect:
 	if ((fchar = CC_connect(conn, NULL)) <= 0)
 	{
 		/* Error messages are filled in */
 		CC_log_error(func, "Error on CC_connect", conn);
 		ret = SQL_ERROR;
 	}
+	else if (CONNECT_IN_PROGRESS == fchar)
+		ret = SQL_STILL_EXECUTING;
 	if (SQL_SUCCESS == ret && 2 == fchar)
 		ret = SQL_SUCCESS_WITH_INFO;
 
@@ -217,12 +228,19 @@ PGAPI_Disconnect(HDBC hdbc)
 		return SQL_INVALID_HANDLE;
 	}
 
-	if (conn->status == CONN_EXECUTING)
+	if (CC_async_busy(conn, func))
+		return SQL_ERROR;
+	if (conn->status == CONN_EXECUTING && !CC_is_async_disconnecting(conn))
 	{
 		CC_set_error(conn, CONN_IN_USE, "A transaction is currently being executed", func);
 		return SQL_ERROR;
 	}
 
+	/* reset the session for the pool without waiting for the server */
+	if (conn->async.enabled && NULL != conn->pqconn &&
+		SQL_STILL_EXECUTING == CC_async_disconnect(conn))
+		return SQL_STILL_EXECUTING;
+
 	logs_on_off(-1, conn->connInfo.drivers.debug, conn->connInfo.drivers.commlog);
 	MYLOG(0, "about to CC_cleanup\n");
 
@@ -315,7 +333,8 @@ CC_initialize(ConnectionClass *rv, BOOL lockinit)
 		goto cleanup;
 	pg_memset(rv->stmts, 0, sizeof(StatementClass *) * STMT_INCREMENT);
 
-	rv->num_stmts = STMT_INCREMENT;
+	rv->num_stmts = 0;
+	rv->stmts_allocated = STMT_INCREMENT;
 	rv->descs = (DescriptorClass **) malloc(sizeof(DescriptorClass *) * STMT_INCREMENT);
 	if (!rv->descs)
 		goto cleanup;
@@ -405,19 +424,20 @@ CC_Destructor(ConnectionClass *self)
 int
 CC_cursor_count(ConnectionClass *self)
 {
-	StatementClass *stmt;
-	int			i,
-				count = 0;
+	StatementClass *stmt, *next;
+	int			count = 0;
 	QResultClass		*res;
 
 	MYLOG(0, "self=%p, num_stmts=%d\n", self, self->num_stmts);
 
 	CONNLOCK_ACQUIRE(self);
-	for (i = 0; i < self->num_stmts; i++)
+	for (stmt = self->cursor_stmts; stmt; stmt = next)
 	{
-		stmt = self->stmts[i];
-		if (stmt && (res = SC_get_Result(stmt)) && QR_get_cursor(res))
+		next = stmt->next_cursor_stmt;
+		if ((res = SC_get_Result(stmt)) && QR_get_cursor(res))
 			count++;
+		else
+			remove_cursor_statement(self, stmt);
 	}
 	CONNLOCK_RELEASE(self);
 
@@ -522,6 +542,41 @@ CC_abort(ConnectionClass *self)
 	return ret;
 }
 
+/*
+ *	SQLEndTran() with SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE on.
+ *	Sends COMMIT or ROLLBACK without waiting for the answer and returns
+ *	SQL_STILL_EXECUTING until it has arrived.
+ */
+RETCODE
+CC_async_end_trans(ConnectionClass *self, BOOL commit)
+{
+	QResultClass	*res = NULL;
+	RETCODE		ret;
+
+	if (CONN_ASYNC_ENDTRAN != self->async.op)
+	{
+		if (commit && CC_is_in_trans(self) && !CC_is_in_error_trans(self))
+			CC_close_eof_cursors(self);
+		if (!CC_is_in_trans(self))
+			return SQL_SUCCESS;
+		MYLOG(0, "  sending %s asynchronously\n", commit ? cmtcmd : rbkcmd);
+		self->async.op = CONN_ASYNC_ENDTRAN;
+		self->status = CONN_EXECUTING;
+	}
+	if (ret = CC_async_query(self, commit ? cmtcmd : rbkcmd, &res), SQL_STILL_EXECUTING == ret)
+		return ret;
+	QR_Destructor(res);
+	self->async.op = CONN_ASYNC_NONE;
+	if (CONN_EXECUTING == self->status)
+		self->status = CONN_CONNECTED;
+	/* the server is idle either way, tell rollbacks from commits */
+	if (!commit || !SQL_SUCCEEDED(ret))
+		CC_set_in_error_trans(self);
+	LIBPQ_update_transaction_status(self);
+
+	return ret;
+}
+
 /* This is called by SQLSetConnectOption etc also */
 char
 CC_set_autocommit(ConnectionClass *self, BOOL on)
@@ -655,6 +710,236 @@ CC_send_client_encoding(ConnectionClass *self, const char * encoding)
 	return SQL_SUCCESS;
 }
 
+static void
+CC_free_pool_key(ConnectionClass *self)
+{
+	if (self->pool_key)
+	{
+		free(self->pool_key);
+		self->pool_key = NULL;
+	}
+	if (self->pool_pwhash)
+	{
+		free(self->pool_pwhash);
+		self->pool_pwhash = NULL;
+	}
+}
+
+/*
+ *	The key of the pooled connections. Only the parameters LIBPQ_connect()
+ *	passes to libpq matter, the others are applied by CC_connect() anyway.
+ *	It's made from the requested attributes before connecting, because
+ *	the user name is replaced by PQuser() once connected. The password
+ *	is kept out of the key, the pool compares its digest instead.
+ */
+static BOOL
+CC_set_pool_key(ConnectionClass *self)
+{
+	const ConnInfo	*ci = &(self->connInfo);
+	PQExpBufferData	key = {0};
+	char		*pwhash;
+
+	initPQExpBuffer(&key);
+	appendPQExpBuffer(&key, "host=%s port=%s dbname=%s user=%s sslmode=%s",
+					  ci->server, ci->port, ci->database,
+					  ci->username, ci->sslmode);
+	appendPQExpBuffer(&key, " pqopt=%s", SAFE_NAME(ci->pqopt));
+	appendPQExpBuffer(&key, " keepalives=%d,%d,%d", ci->disable_keepalive,
+					  ci->keepalive_idle, ci->keepalive_interval);
+	if (PQExpBufferDataBroken(key))
+		return FALSE;
+	/* salted with the key, so that it's no valid md5 password of the user */
+	if (pwhash = PQencryptPassword(SAFE_NAME(ci->password), key.data), NULL == pwhash)
+	{
+		termPQExpBuffer(&key);
+		return FALSE;
+	}
+	self->pool_pwhash = strdup(pwhash);
+	PQfreemem(pwhash);
+	if (NULL == self->pool_pwhash)
+	{
+		termPQExpBuffer(&key);
+		return FALSE;
+	}
+	self->pool_key = key.data;
+
+	return TRUE;
+}
+
+/*
+ *	Can the libpq connection go into the pool of the environment ?
+ */
+static BOOL
+CC_poolable(const ConnectionClass *self)
+{
+	if (self->connInfo.pool_size <= 0 || NULL == CC_get_env(self))
+		return FALSE;
+#ifdef	_HANDLE_ENLIST_IN_DTC_
+	if (self->asdum)
+		return FALSE;
+#endif /* _HANDLE_ENLIST_IN_DTC_ */
+	if (CONNECTION_OK != PQstatus(self->pqconn))
+		return FALSE;
+	switch (PQtransactionStatus(self->pqconn))
+	{
+		case PQTRANS_IDLE:
+		case PQTRANS_INTRANS:
+		case PQTRANS_INERROR:
+			return TRUE;
+		default:
+			break;
+	}
+
+	return FALSE;
+}
+
+static const char *
+CC_pool_reset_command(const ConnectionClass *self)
+{
+	if (0 != self->connInfo.pool_reset)
+		return "SET SESSION AUTHORIZATION DEFAULT;RESET ALL;DEALLOCATE ALL;CLOSE ALL;UNLISTEN *;SELECT pg_advisory_unlock_all()";
+	return "DISCARD ALL";
+}
+
+/*
+ *	Put the libpq connection, whose session has been reset, into the pool.
+ */
+static BOOL
+CC_pool_reset_pqconn(ConnectionClass *self)
+{
+	const ConnInfo	*ci = &(self->connInfo);
+	BOOL		pooled = FALSE;
+
+	if (PQTRANS_IDLE == PQtransactionStatus(self->pqconn) &&
+		NULL != self->pool_key)
+		pooled = EN_pool_conn(CC_get_env(self), self->pool_key,
+							  self->pool_pwhash, self->pqconn,
+							  self->pqconn_created, ci->pool_size,
+							  ci->pool_idle_timeout, ci->pool_lifetime);
+
+	return pooled;
+}
+
+/*
+ *	Reset the session and put the libpq connection into the pool of the
+ *	environment instead of closing it.
+ */
+static BOOL
+CC_pool_pqconn(ConnectionClass *self)
+{
+	PGconn		*pqconn = self->pqconn;
+	PGresult	*pgres;
+	const char	*resetcmd;
+	BOOL		pooled = FALSE;
+
+	if (!CC_poolable(self))
+		return FALSE;
+	if (PQTRANS_IDLE != PQtransactionStatus(pqconn))
+	{
+		/* DISCARD ALL cannot run in a transaction block */
+		QLOG(0, "PQexec: %p '%s'\n", pqconn, rbkcmd);
+		pgres = PQexec(pqconn, rbkcmd);
+		PQclear(pgres);
+	}
+	resetcmd = CC_pool_reset_command(self);
+	QLOG(0, "PQexec: %p '%s'\n", pqconn, resetcmd);
+	pgres = PQexec(pqconn, resetcmd);
+	if (NULL != pgres &&
+		(PGRES_COMMAND_OK == PQresultStatus(pgres) ||
+		 PGRES_TUPLES_OK == PQresultStatus(pgres)))
+		pooled = CC_pool_reset_pqconn(self);
+	PQclear(pgres);
+
+	return pooled;
+}
+
+/*
+ *	SQLDisconnect() with SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE on.
+ *	The round trips CC_pool_pqconn() would wait for are made without
+ *	blocking, returning SQL_STILL_EXECUTING until they are done. Then
+ *	the libpq connection has gone into the pool or is left to
+ *	CC_cleanup() to close.
+ */
+RETCODE
+CC_async_disconnect(ConnectionClass *self)
+{
+	QResultClass	*res = NULL;
+	RETCODE		ret;
+
+	if (CONN_ASYNC_NONE == self->async.op)
+	{
+		if (!CC_poolable(self))
+			return SQL_SUCCESS;
+		if (PQTRANS_IDLE == PQtransactionStatus(self->pqconn))
+			self->async.op = CONN_ASYNC_DISCONNECT_RESET;
+		else	/* DISCARD ALL cannot run in a transaction block */
+			self->async.op = CONN_ASYNC_DISCONNECT_ROLLBACK;
+		self->status = CONN_EXECUTING;
+	}
+	if (CONN_ASYNC_DISCONNECT_ROLLBACK == self->async.op)
+	{
+		if (ret = CC_async_query(self, rbkcmd, &res), SQL_STILL_EXECUTING == ret)
+			return ret;
+		QR_Destructor(res);
+		self->async.op = CONN_ASYNC_DISCONNECT_RESET;
+	}
+	if (ret = CC_async_query(self, CC_pool_reset_command(self), &res), SQL_STILL_EXECUTING == ret)
+		return ret;
+	QR_Destructor(res);
+	self->async.op = CONN_ASYNC_NONE;
+	self->status = CONN_CONNECTED;
+	if (!SQL_SUCCEEDED(ret) || !CC_pool_reset_pqconn(self))
+	{
+		QLOG(0, "PQfinish: %p\n", self->pqconn);
+		PQfinish(self->pqconn);
+	}
+	self->pqconn = NULL;
+
+	return SQL_SUCCESS;
+}
+
+/*
+ *	Take a usable connection out of the pool of the environment.
+ */
+static BOOL
+CC_get_pooled_pqconn(ConnectionClass *self)
+{
+	EnvironmentClass	*env = CC_get_env(self);
+	PGconn		*pqconn;
+	PGnotify	*notify;
+	time_t		created;
+
+	CC_free_pool_key(self);
+	if (self->connInfo.pool_size <= 0 || NULL == env)
+		return FALSE;
+	if (!CC_set_pool_key(self))
+		return FALSE;
+	while (pqconn = EN_get_pooled_conn(env, self->pool_key, self->pool_pwhash, &created), NULL != pqconn)
+	{
+		/*
+		 * Read what the server may have sent while the connection was
+		 * idle, which also notices a connection closed by the server.
+		 */
+		if (PQconsumeInput(pqconn) &&
+			CONNECTION_OK == PQstatus(pqconn) &&
+			PQTRANS_IDLE == PQtransactionStatus(pqconn))
+		{
+			while (notify = PQnotifies(pqconn), NULL != notify)
+				PQfreemem(notify);
+			break;
+		}
+		MYLOG(0, "discarding a broken pooled connection %p\n", pqconn);
+		QLOG(0, "PQfinish: %p\n", pqconn);
+		PQfinish(pqconn);
+	}
+	if (NULL == pqconn)
+		return FALSE;
+	self->pqconn = pqconn;
+	self->pqconn_created = created;
+
+	return TRUE;
+}
+
 /* This is called by SQLDisconnect also */
 char
 CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
@@ -669,13 +954,21 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 	MYLOG(0, "entering self=%p\n", self);
 
 	ENTER_CONN_CS(self);
+	/* an asynchronous operation abandoned half way */
+	QR_Destructor(self->async.res);
+	self->async.res = self->async.last_res = NULL;
+	self->async.op = CONN_ASYNC_NONE;
+	self->async.sent = FALSE;
 	/* Cancel an ongoing transaction */
 	/* We are always in the middle of a transaction, */
 	/* even if we are in auto commit. */
 	if (self->pqconn)
 	{
-		QLOG(0, "PQfinish: %p\n", self->pqconn);
-		PQfinish(self->pqconn);
+		if (keepCommunication || !CC_pool_pqconn(self))
+		{
+			QLOG(0, "PQfinish: %p\n", self->pqconn);
+			PQfinish(self->pqconn);
+		}
 		self->pqconn = NULL;
 	}
 
@@ -694,6 +987,8 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 			self->stmts[i] = NULL;
 		}
 	}
+	self->num_stmts = 0;
+	self->cursor_stmts = NULL;
 	/* Free all the descs on this connection */
 	for (i = 0; i < self->num_descs; i++)
 	{
@@ -724,6 +1019,7 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 	}
 	if (!keepCommunication)
 	{
+		CC_free_pool_key(self);
 		CC_conninfo_init(&(self->connInfo), CLEANUP_FOR_REUSE);
 		if (self->original_client_encoding)
 		{
@@ -1078,6 +1374,129 @@ static char CC_initial_log(ConnectionClass *self, const char *func)
 static int handle_show_results(const QResultClass *res);
 #define	TRANSACTION_ISOLATION "transaction_isolation"
 #define	ISOLATION_SHOW_QUERY "show " TRANSACTION_ISOLATION
+#define	MAX_IDENTIFIER_LENGTH "max_identifier_length"
+#define	CURRENT_SCHEMA	"current_schema"
+#define	LO_LOOKUP_QUERY	"select oid, typbasetype from pg_type where typname = '"  PG_TYPE_LO_NAME "'"
+static const char *isolation_set_query(UInt4 isolation);
+
+/*
+ *	Send the queries which set up a new connection as one multi-statement
+ *	query, i.e. in one round trip, and handle their results together.
+ *
+ *	They are the session settings the driver depends on, the client
+ *	encoding, the isolation level (shown and, if requested before
+ *	connecting, set), the lookup of the large object type and the values
+ *	of max_identifier_length and current_schema() which would otherwise
+ *	be queried on demand later.
+ */
+static char
+CC_send_bootstrap_query(ConnectionClass *self)
+{
+	CSTR		func = "CC_send_bootstrap_query";
+	PQExpBufferData	query_buf = {0};
+	const char	*encoding, *dbencoding;
+	const char	*isolation_query = NULL;
+	BOOL		set_encoding, get_schema;
+	QResultClass	*res = NULL;
+	const QResultClass	*qres;
+	char		ret = 0;
+
+	/*
+	 *		Multibyte handling
+	 *
+	 *	Send 'UTF8' when required Unicode behavior, otherwise send
+	 *	locale encodings.
+	 */
+	CC_determine_locale_encoding(self); /* determine the locale_encoding */
+#ifdef UNICODE_SUPPORT
+	if (CC_is_in_unicode_driver(self))
+		encoding = "UTF8";
+	else	/* for unicode drivers require ANSI behavior */
+#endif /* UNICODE_SUPPORT */
+		encoding = self->locale_encoding;
+	dbencoding = PQparameterStatus(self->pqconn, "client_encoding");
+	set_encoding = (NULL != encoding && (NULL == dbencoding || stricmp(encoding, dbencoding)));
+	if (0 != self->isolation &&
+		(PG_VERSION_GE(self, 8.0) ||
+		 (self->isolation != SQL_TXN_READ_UNCOMMITTED &&
+		  self->isolation != SQL_TXN_REPEATABLE_READ)))
+		isolation_query = isolation_set_query(self->isolation);
+	/* ConnSettings may change the search_path */
+	get_schema = (NAME_IS_NULL(self->connInfo.conn_settings) ||
+				  '\0' == GET_NAME(self->connInfo.conn_settings)[0]);
+
+	initPQExpBuffer(&query_buf);
+	appendPQExpBufferStr(&query_buf, "SET DateStyle = 'ISO';SET extra_float_digits = 2;");
+	if (set_encoding)
+		appendPQExpBuffer(&query_buf, "set client_encoding to '%s';", encoding);
+	appendPQExpBufferStr(&query_buf, ISOLATION_SHOW_QUERY ";");
+	if (isolation_query)
+		appendPQExpBuffer(&query_buf, "%s;", isolation_query);
+	appendPQExpBufferStr(&query_buf, LO_LOOKUP_QUERY ";show " MAX_IDENTIFIER_LENGTH);
+	if (get_schema)
+		appendPQExpBufferStr(&query_buf, ";select " CURRENT_SCHEMA "()");
+	if (PQExpBufferDataBroken(query_buf))
+	{
+		CC_set_error(self, CONN_NO_MEMORY_ERROR, "Couldn't alloc buffer for query.", func);
+		goto cleanup;
+	}
+
+	/*
+	 * An asynchronous connect gets here on each call until the answer
+	 * has arrived. The query is only sent on the first of them.
+	 */
+	if (CONN_ASYNC_SETUP == self->async.op)
+	{
+		if (SQL_STILL_EXECUTING == CC_async_query(self, query_buf.data, &res))
+			ret = CONNECT_IN_PROGRESS;
+	}
+	else
+		res = CC_send_query(self, query_buf.data, NULL, READ_ONLY_QUERY, NULL);
+	termPQExpBuffer(&query_buf);
+	if (CONNECT_IN_PROGRESS == ret || !QR_command_maybe_successful(res))
+		goto cleanup;
+
+	handle_show_results(res);
+	if (isolation_query)
+		self->server_isolation = self->isolation;
+	CC_set_client_encoding(self, encoding);
+	for (qres = res; qres; qres = QR_nextr(qres))
+	{
+		if (QR_NumResultCols(qres) <= 0 ||
+			QR_get_num_cached_tuples(qres) <= 0)
+			continue;
+		if (QR_NumResultCols(qres) == 2 &&
+			strcmp(QR_get_fieldname(qres, 1), "typbasetype") == 0)
+		{
+			/* a hack to get the oid of our large object oid type */
+			OID	basetype;
+
+			self->lobj_type = QR_get_value_backend_int(qres, 0, 0, NULL);
+			basetype = QR_get_value_backend_int(qres, 0, 1, NULL);
+			if (PG_TYPE_OID == basetype)
+				self->lo_is_domain = 1;
+			else if (0 != basetype)
+				self->lobj_type = 0;
+			MYLOG(0, "Got the large object oid: %d\n", self->lobj_type);
+		}
+		else if (strcmp(QR_get_fieldname(qres, 0), CURRENT_SCHEMA) == 0)
+		{
+			const char *curschema = QR_get_value_backend_text(qres, 0, 0);
+
+			reset_current_schema(self);
+			if (curschema)
+				self->current_schema = strdup(curschema);
+			if (self->current_schema)
+				self->current_schema_valid = TRUE;
+		}
+	}
+	ret = 1;
+
+cleanup:
+	QR_Destructor(res);
+
+	return ret;
+}
 
 static int LIBPQ_connect(ConnectionClass *self);
 static char
@@ -1085,26 +1504,22 @@ LIBPQ_CC_connect(ConnectionClass *self, char *salt_para)
 {
 	int		ret;
 	CSTR		func = "LIBPQ_CC_connect";
-	QResultClass	*res;
 
 	MYLOG(0, "entering...\n");
 
-	if (0 == CC_initial_log(self, func))
+	if (CONN_ASYNC_NONE == self->async.op &&
+		0 == CC_initial_log(self, func))
 		return 0;
 
-	if (ret = LIBPQ_connect(self), ret <= 0)
-		return ret;
-	res = CC_send_query(self, "SET DateStyle = 'ISO';SET extra_float_digits = 2;" ISOLATION_SHOW_QUERY, NULL, READ_ONLY_QUERY, NULL);
-	if (QR_command_maybe_successful(res))
+	if (CONN_ASYNC_SETUP != self->async.op)
 	{
-		handle_show_results(res);
-		ret = 1;
+		if (ret = LIBPQ_connect(self), ret <= 0 || CONNECT_IN_PROGRESS == ret)
+			return ret;
+		if (self->async.enabled)
+			self->async.op = CONN_ASYNC_SETUP;
 	}
-	else
-		ret = 0;
-	QR_Destructor(res);
 
-	return ret;
+	return CC_send_bootstrap_query(self);
 }
 
 char
@@ -1118,6 +1533,13 @@ CC_connect(ConnectionClass *self, char *salt_para)
 	MYLOG(0, "entering...sslmode=%s\n", self->connInfo.sslmode);
 
 	ret = LIBPQ_CC_connect(self, salt_para);
+	if (CONNECT_IN_PROGRESS == ret)
+		return ret;
+	/*
+	 * The rest is done synchronously. It normally sends nothing unless
+	 * ConnSettings is specified.
+	 */
+	self->async.op = CONN_ASYNC_NONE;
 	if (ret <= 0)
 		return ret;
 
@@ -1147,37 +1569,14 @@ CC_connect(ConnectionClass *self, char *salt_para)
 		saverr = strdup(errmsg);
 	CC_clear_error(self);			/* clear any error */
 
-	if (!SQL_SUCCEEDED(CC_lookup_lo(self)))	/* a hack to get the oid of our large object oid type */
-	{
-		ret = 0;
-		goto cleanup;
-	}
-
 	/*
-	 *		Multibyte handling
-	 *
-	 *	Send 'UTF8' when required Unicode behavior, otherwise send
-	 *	locale encodings.
+	 * The client encoding was set by LIBPQ_CC_connect(). This sends
+	 * nothing unless the Per Datasource settings changed it.
 	 */
-	CC_clear_error(self);
-	CC_determine_locale_encoding(self); /* determine the locale_encoding */
-#ifdef UNICODE_SUPPORT
-	if (CC_is_in_unicode_driver(self))
-	{
-		if (!SQL_SUCCEEDED(CC_send_client_encoding(self, "UTF8")))
-		{
-			ret = 0;
-			goto cleanup;
-		}
-	}
-	else	/* for unicode drivers require ANSI behavior */
-#endif /* UNICODE_SUPPORT */
+	if (!SQL_SUCCEEDED(CC_send_client_encoding(self, self->original_client_encoding)))
 	{
-		if (!SQL_SUCCEEDED(CC_send_client_encoding(self, self->locale_encoding)))
-		{
-			ret = 0;
-			goto cleanup;
-		}
+		ret = 0;
+		goto cleanup;
 	}
 
 	CC_clear_error(self);
@@ -1214,50 +1613,45 @@ cleanup:
 }
 
 
+/*
+ *	The statements are kept packed in self->stmts and each of them knows
+ *	its index there, so that adding and removing one take constant time.
+ */
 char
 CC_add_statement(ConnectionClass *self, StatementClass *stmt)
 {
-	int	i;
 	char	ret = TRUE;
 
 	MYLOG(0, "self=%p, stmt=%p\n", self, stmt);
 
 	CONNLOCK_ACQUIRE(self);
-	for (i = 0; i < self->num_stmts; i++)
-	{
-		if (!self->stmts[i])
-		{
-			stmt->hdbc = self;
-			self->stmts[i] = stmt;
-			break;
-		}
-	}
-
-	if (i >= self->num_stmts) /* no more room -- allocate more memory */
+	if (self->num_stmts >= self->stmts_allocated) /* no more room -- allocate more memory */
 	{
 		StatementClass **newstmts;
-		Int2 new_num_stmts;
+		Int4 new_stmts_allocated;
 
-		new_num_stmts = STMT_INCREMENT + self->num_stmts;
+		new_stmts_allocated = 2 * self->stmts_allocated;
 
-		if (new_num_stmts > 0)
+		if (new_stmts_allocated > 0)
 			newstmts = (StatementClass **)
-				realloc(self->stmts, sizeof(StatementClass *) * new_num_stmts);
+				realloc(self->stmts, sizeof(StatementClass *) * new_stmts_allocated);
 		else
-			newstmts = NULL; /* num_stmts overflowed */
+			newstmts = NULL; /* stmts_allocated overflowed */
 		if (!newstmts)
 			ret = FALSE;
 		else
 		{
 			self->stmts = newstmts;
-			pg_memset(&self->stmts[self->num_stmts], 0, sizeof(StatementClass *) * STMT_INCREMENT);
-
-			stmt->hdbc = self;
-			self->stmts[self->num_stmts] = stmt;
-
-			self->num_stmts = new_num_stmts;
+			pg_memset(&self->stmts[self->stmts_allocated], 0, sizeof(StatementClass *) * (new_stmts_allocated - self->stmts_allocated));
+			self->stmts_allocated = new_stmts_allocated;
 		}
 	}
+	if (ret)
+	{
+		stmt->hdbc = self;
+		stmt->conn_index = self->num_stmts;
+		self->stmts[self->num_stmts++] = stmt;
+	}
 	CONNLOCK_RELEASE(self);
 
 	return ret;
@@ -1285,30 +1679,69 @@ CC_remove_statement(ConnectionClass *self, StatementClass *stmt)
 	char	ret = FALSE;
 
 	CONNLOCK_ACQUIRE(self);
-	for (i = 0; i < self->num_stmts; i++)
-	{
-		if (self->stmts[i] == stmt && stmt->status != STMT_EXECUTING)
-		{
-			self->stmts[i] = NULL;
-			ret = TRUE;
-			break;
-		}
+	i = stmt->conn_index;
+	if (i >= 0 && i < self->num_stmts &&
+		self->stmts[i] == stmt && stmt->status != STMT_EXECUTING)
+	{
+		/* move the last one to the vacated slot */
+		self->stmts[i] = self->stmts[--self->num_stmts];
+		self->stmts[i]->conn_index = i;
+		self->stmts[self->num_stmts] = NULL;
+		stmt->conn_index = -1;
+		remove_cursor_statement(self, stmt);
+		ret = TRUE;
 	}
 	CONNLOCK_RELEASE(self);
 
 	return ret;
 }
 
-char CC_get_escape(const ConnectionClass *self)
+/*
+ *	Statements whose result may hold a cursor are linked in
+ *	self->cursor_stmts, so that commit/rollback processing doesn't have to
+ *	visit every statement. The list is pruned lazily: a statement whose
+ *	result turns out to have no cursor is unlinked when it's visited.
+ */
+void
+CC_add_cursor_statement(ConnectionClass *self, StatementClass *stmt)
 {
-	const char	   *scf;
-	static const ConnectionClass *conn = NULL;
-
-	scf = PQparameterStatus(self->pqconn, "standard_conforming_strings");
-	if (self != conn)
+	CONNLOCK_ACQUIRE(self);
+	if (stmt->conn_index >= 0 &&
+		self->cursor_stmts != stmt && NULL == stmt->prev_cursor_stmt)
 	{
-		QLOG(0, "PQparameterStatus(%p, \"standard_conforming_strings\")=%s\n", self->pqconn, SAFE_STR(scf));
-		conn = self;
+		stmt->next_cursor_stmt = self->cursor_stmts;
+		if (self->cursor_stmts)
+			self->cursor_stmts->prev_cursor_stmt = stmt;
+		self->cursor_stmts = stmt;
+	}
+	CONNLOCK_RELEASE(self);
+}
+
+/* Must be called with the connection lock held */
+static void
+remove_cursor_statement(ConnectionClass *self, StatementClass *stmt)
+{
+	if (stmt->prev_cursor_stmt)
+		stmt->prev_cursor_stmt->next_cursor_stmt = stmt->next_cursor_stmt;
+	else if (self->cursor_stmts == stmt)
+		self->cursor_stmts = stmt->next_cursor_stmt;
+	else
+		return;		/* not in the list */
+	if (stmt->next_cursor_stmt)
+		stmt->next_cursor_stmt->prev_cursor_stmt = stmt->prev_cursor_stmt;
+	stmt->prev_cursor_stmt = stmt->next_cursor_stmt = NULL;
+}
+
+char CC_get_escape(const ConnectionClass *self)
+{
+	const char	   *scf;
+	static const ConnectionClass *conn = NULL;
+
+	scf = PQparameterStatus(self->pqconn, "standard_conforming_strings");
+	if (self != conn)
+	{
+		QLOG(0, "PQparameterStatus(%p, \"standard_conforming_strings\")=%s\n", self->pqconn, SAFE_STR(scf));
+		conn = self;
 	}
 	if (scf == NULL)
 	{
@@ -1321,6 +1754,17 @@ char CC_get_escape(const ConnectionClass *self)
 		return '\0';
 }
 
+/*
+ * Are date/time values of the server 8-byte integers ?
+ * (the binary format of time and timestamp types depends on it)
+ */
+BOOL CC_integer_datetimes(const ConnectionClass *self)
+{
+	const char	   *idt;
+
+	idt = PQparameterStatus(self->pqconn, "integer_datetimes");
+	return (NULL != idt && strcmp(idt, "on") == 0);
+}
 
 int	CC_get_max_idlen(ConnectionClass *self)
 {
@@ -1330,7 +1774,7 @@ int	CC_get_max_idlen(ConnectionClass *self)
 	{
 		QResultClass	*res;
 
-		res = CC_send_query(self, "show max_identifier_length", NULL, READ_ONLY_QUERY, NULL);
+		res = CC_send_query(self, "show " MAX_IDENTIFIER_LENGTH, NULL, READ_ONLY_QUERY, NULL);
 		if (QR_command_maybe_successful(res))
 			len = self->max_identifier_length = QR_get_value_backend_int(res, 0, 0, FALSE);
 		QR_Destructor(res);
@@ -1377,13 +1821,18 @@ static int handle_show_results(const QResultClass *res)
 				conn->default_isolation = conn->server_isolation;
 			count++;
 		}
+		else if (strcmp(QR_get_fieldname(qres, 0), MAX_IDENTIFIER_LENGTH) == 0)
+		{
+			conn->max_identifier_length = QR_get_value_backend_int(qres, 0, 0, FALSE);
+			count++;
+		}
 	}
 
 	return count;
 }
 /*
  *	This function may not be called as long as ISOLATION_SHOW_QUERY is
- *	issued in LIBPQ_CC_connect.
+ *	issued in CC_send_bootstrap_query.
  */
 SQLUINTEGER	CC_get_isolation(ConnectionClass *self)
 {
@@ -1454,28 +1903,36 @@ CC_get_error(ConnectionClass *self, int *number, char **message)
 
 static int CC_close_eof_cursors(ConnectionClass *self)
 {
-	int	i, ccount = 0;
-	StatementClass	*stmt;
+	int	ccount = 0;
+	StatementClass	*stmt, *next;
 	QResultClass	*res;
 
 	if (!self->ncursors)
 		return ccount;
 	CONNLOCK_ACQUIRE(self);
-	for (i = 0; i < self->num_stmts; i++)
+	for (stmt = self->cursor_stmts; stmt; stmt = next)
 	{
-		if (stmt = self->stmts[i], NULL == stmt)
-			continue;
-		if (res = SC_get_Result(stmt), NULL == res)
+		next = stmt->next_cursor_stmt;
+		if (res = SC_get_Result(stmt), NULL == res ||
+			NULL == QR_get_cursor(res))
+		{
+			remove_cursor_statement(self, stmt);
 			continue;
-		if (NULL != QR_get_cursor(res) &&
-		    QR_is_withhold(res) &&
+		}
+		if (QR_is_withhold(res) &&
 		    QR_once_reached_eof(res))
 		{
 			if (QR_get_num_cached_tuples(res) >= QR_get_num_total_tuples(res) ||
 				SQL_CURSOR_FORWARD_ONLY == stmt->options.cursor_type)
 			{
-				QR_close(res);
-				ccount++;
+				/* CLOSEd all together before the COMMIT */
+				if (CC_mark_a_object_to_discard(self, 'p', QR_get_cursor(res)) > 0)
+				{
+					QR_on_close_cursor(res);
+					ccount++;
+				}
+				else
+					QR_close(res);
 			}
 		}
 	}
@@ -1485,18 +1942,19 @@ static int CC_close_eof_cursors(ConnectionClass *self)
 
 static void CC_clear_cursors(ConnectionClass *self, BOOL on_abort)
 {
-	int	i;
-	StatementClass	*stmt;
+	StatementClass	*stmt, *next;
 	QResultClass	*res;
 
 	if (!self->ncursors)
 		return;
 	CONNLOCK_ACQUIRE(self);
-	for (i = 0; i < self->num_stmts; i++)
+	for (stmt = self->cursor_stmts; stmt; stmt = next)
 	{
-		stmt = self->stmts[i];
-		if (stmt && (res = SC_get_Result(stmt)) &&
-			 (NULL != QR_get_cursor(res)))
+		next = stmt->next_cursor_stmt;
+		if (res = SC_get_Result(stmt), NULL == res ||
+			NULL == QR_get_cursor(res))
+			remove_cursor_statement(self, stmt);
+		else
 		{
 			/*
 			 * non-holdable cursors are automatically closed
@@ -1528,6 +1986,11 @@ static void CC_clear_cursors(ConnectionClass *self, BOOL on_abort)
 					QR_Destructor(wres);
 					CONNLOCK_ACQUIRE(self);
 MYLOG(DETAIL_LOG_LEVEL, "%p->permanent -> %d %p\n", res, QR_is_permanent(res), QR_get_cursor(res));
+					/*
+					 * The list may have changed while the lock was released.
+					 * Start over, the cursors processed are skipped then.
+					 */
+					next = self->cursor_stmts;
 				}
 				else
 					QR_set_permanent(res);
@@ -1539,20 +2002,19 @@ MYLOG(DETAIL_LOG_LEVEL, "%p->permanent -> %d %p\n", res, QR_is_permanent(res), Q
 
 static void CC_mark_cursors_doubtful(ConnectionClass *self)
 {
-	int	i;
-	StatementClass	*stmt;
+	StatementClass	*stmt, *next;
 	QResultClass	*res;
 
 	if (!self->ncursors)
 		return;
 	CONNLOCK_ACQUIRE(self);
-	for (i = 0; i < self->num_stmts; i++)
+	for (stmt = self->cursor_stmts; stmt; stmt = next)
 	{
-		stmt = self->stmts[i];
-		if (NULL != stmt &&
-		    NULL != (res = SC_get_Result(stmt)) &&
-		    NULL != QR_get_cursor(res) &&
-		    !QR_is_permanent(res))
+		next = stmt->next_cursor_stmt;
+		if (NULL == (res = SC_get_Result(stmt)) ||
+		    NULL == QR_get_cursor(res))
+			remove_cursor_statement(self, stmt);
+		else if (!QR_is_permanent(res))
 			QR_set_survival_check(res);
 	}
 	CONNLOCK_RELEASE(self);
@@ -1572,9 +2034,7 @@ void	CC_on_commit(ConnectionClass *conn)
 	CC_svp_init(conn);
 	CC_start_stmt(conn);
 	CC_clear_cursors(conn, FALSE);
-	CONNLOCK_RELEASE(conn);
-	CC_discard_marked_objects(conn);
-	CONNLOCK_ACQUIRE(conn);
+	/* the marked objects are discarded before the next query */
 	if (conn->result_uncommitted)
 	{
 		CONNLOCK_RELEASE(conn);
@@ -1587,8 +2047,6 @@ void	CC_on_commit(ConnectionClass *conn)
 }
 void	CC_on_abort(ConnectionClass *conn, unsigned int opt)
 {
-	BOOL	set_no_trans = FALSE;
-
 MYLOG(0, "entering opt=%x\n", opt);
 	CONNLOCK_ACQUIRE(conn);
 	if (0 != (opt & CONN_DEAD)) /* CONN_DEAD implies NO_TRANS also */
@@ -1599,7 +2057,6 @@ MYLOG(0, "entering opt=%x\n", opt);
 		{
 			CC_set_no_trans(conn);
 			CC_set_no_manual_trans(conn);
-			set_no_trans = TRUE;
 		}
 	}
 	CC_svp_init(conn);
@@ -1617,12 +2074,6 @@ MYLOG(0, "entering opt=%x\n", opt);
 			conn->pqconn = NULL;
 		}
 	}
-	else if (set_no_trans)
-	{
-		CONNLOCK_RELEASE(conn);
-		CC_discard_marked_objects(conn);
-		CONNLOCK_ACQUIRE(conn);
-	}
 	if (conn->result_uncommitted)
 	{
 		CONNLOCK_RELEASE(conn);
@@ -1815,8 +2266,13 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 			consider_rollback;
 	BOOL	discardTheRest = FALSE;
 	int		func_cs_count = 0;
+	int		icursor = 0;
 	PQExpBufferData		query_buf = {0};
 	size_t		query_len;
+	char	**discardp = NULL;
+	int		discard_cnt = 0, discard_left = 0, discard_done = 0;
+	BOOL	discard_ahead = FALSE, discard_behind = FALSE,
+			discard_failed = FALSE;
 
 	/* QR_set_command() dups this string so doesn't need static */
 	char	   *cmdbuffer;
@@ -1878,6 +2334,24 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 	rollback_on_error = (flag & ROLLBACK_ON_ERROR) != 0;
 	end_with_commit = (flag & END_WITH_COMMIT) != 0;
 	read_only = (flag & READ_ONLY_QUERY) != 0;
+
+	/*
+	 *	The marked objects are discarded in the same command string,
+	 *	ahead of a query which starts no transaction of its own or
+	 *	behind a COMMIT. Where their failure would abort the transaction
+	 *	in progress, or the query must be sent alone, they still take a
+	 *	round trip of their own.
+	 */
+	if (CC_discard_pending(self))
+	{
+		if (end_with_commit || stricmp(query, cmtcmd) == 0)
+			discard_behind = TRUE;
+		else if (!CC_is_in_trans(self) &&
+				 (issue_begin || query_may_follow_discard(query)))
+			discard_ahead = TRUE;
+		else
+			CC_discard_marked_objects(self);
+	}
 #define	return DONT_CALL_RETURN_FROM_HERE???
 	consider_rollback = (issue_begin || (CC_is_in_trans(self) && !CC_is_in_error_trans(self)) || strnicmp(query, "begin", 5) == 0);
 	if (rollback_on_error)
@@ -1914,6 +2388,8 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 	MYLOG(0, "query_len=" FORMAT_SIZE_T "\n", query_len);
 
 	initPQExpBuffer(&query_buf);
+	if (discard_ahead)
+		discard_cnt = take_marked_objects(self, &query_buf, TRUE, &discardp);
 	/* issue_begin, query_rollback and prepend_savepoint are exclusive */
 	if (issue_begin)
 	{
@@ -1942,6 +2418,8 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 	{
 		appendPQExpBuffer(&query_buf, ";%s %s", rlscmd, per_query_svp);
 	}
+	if (discard_behind)
+		discard_cnt = take_marked_objects(self, &query_buf, FALSE, &discardp);
 	if (PQExpBufferDataBroken(query_buf))
 	{
 		CC_set_error(self, CONN_NO_MEMORY_ERROR, "Couldn't alloc buffer for query.", "");
@@ -1984,6 +2462,8 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 		res->cache_size = qi->row_size;
 	}
 	nrarg.res = res;
+	if (discard_ahead)
+		discard_left = discard_cnt;
 
 	while (self->pqconn && (pgres = PQgetResult(self->pqconn)) != NULL)
 	{
@@ -1991,6 +2471,21 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 
 		if (discardTheRest)
 			continue;
+		if (discard_left > 0)
+		{
+			/* a DEALLOCATE/CLOSE of the marked objects, not for the caller */
+			discard_left--;
+			discard_done++;
+			if (PGRES_COMMAND_OK != status)
+			{
+				MYLOG(0, "discarding a marked object failed\n");
+				discard_failed = TRUE;
+				discard_left = 0;	/* the rest is skipped */
+			}
+			PQclear(pgres);
+			pgres = NULL;
+			continue;
+		}
 		switch (status)
 		{
 			case PGRES_COMMAND_OK:
@@ -2016,6 +2511,12 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 				MYLOG(0, " setting cmdbuffer = '%s'\n", cmdbuffer);
 
 				my_trim(cmdbuffer); /* get rid of trailing space */
+				if (discard_behind &&
+					strnicmp(cmdbuffer, cmtcmd, strlen(cmtcmd)) == 0)
+				{
+					/* the marked objects follow */
+					discard_left = discard_cnt;
+				}
 				if (strnicmp(cmdbuffer, bgncmd, strlen(bgncmd)) == 0)
 				{
 					CC_set_in_trans(self);
@@ -2155,6 +2656,13 @@ MYLOG(DETAIL_LOG_LEVEL, "Discarded a RELEASE result\n");
 				if (!used_passed_result_object)
 				{
 					const char *cursor = qi ? qi->cursor : NULL;
+
+					if (qi && qi->cursors)
+					{
+						cursor = qi->cursors[icursor];
+						if (NULL != cursor)
+							icursor++;
+					}
 					if (create_keyset)
 					{
 						QR_set_haskeyset(res);
@@ -2285,6 +2793,9 @@ MYLOG(DETAIL_LOG_LEVEL, " rollback_on_error=%d CC_is_in_trans=%d discard_next_sa
 		}
 	}
 
+	if (discardp)
+		return_marked_objects(self, discardp, discard_cnt, discard_done);
+
 	CLEANUP_FUNC_CONN_CS(func_cs_count, self);
 #undef	return
 	/*
@@ -2361,6 +2872,15 @@ MYLOG(DETAIL_LOG_LEVEL, " ignored abort_on_conn\n");
 	 */
 	LIBPQ_update_transaction_status(self);
 
+	if (discard_ahead && discard_failed)
+	{
+		/* nothing after the failed command ran, send the query again */
+		MYLOG(0, "sending the query again\n");
+		if (retres && !used_passed_result_object)
+			QR_Destructor(retres);
+		return CC_send_query_append(self, query, qi, flag, stmt, appendq);
+	}
+
 	if (retres)
 		QR_set_conn(retres, self);
 	rhold.first = retres;
@@ -2518,6 +3038,129 @@ cleanup:
 	return ret;
 }
 
+/*
+ *	Prepare a query as the protocol level prepared statement plan_name.
+ */
+BOOL
+CC_prepare_query(ConnectionClass *self, const char *plan_name, const char *query, int nParams, const Oid *paramTypes)
+{
+	PGresult	*pgres;
+	BOOL		ret = TRUE;
+	int		func_cs_count = 0;
+
+#define	return DONT_CALL_RETURN_FROM_HERE???
+	ENTER_INNER_CONN_CS(self, func_cs_count);
+	CC_discard_marked_objects(self);
+	QLOG(0, "PQprepare: %p '%s' plan=%s nParams=%d\n", self->pqconn, query, plan_name, nParams);
+	pgres = PQprepare(self->pqconn, plan_name, query, nParams, paramTypes);
+	if (PGRES_COMMAND_OK == PQresultStatus(pgres))
+	{
+		QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+		LIBPQ_update_transaction_status(self);
+	}
+	else
+	{
+		handle_pgres_error(self, pgres, "CC_prepare_query", NULL, TRUE);
+		ret = FALSE;
+	}
+#undef	return
+	CLEANUP_FUNC_CONN_CS(func_cs_count, self);
+	if (pgres)
+		PQclear(pgres);
+	return ret;
+}
+
+static char *
+put_uint4(char *ptr, UInt4 val)
+{
+	val = htonl(val);
+	memcpy(ptr, &val, sizeof(val));
+	return ptr + sizeof(val);
+}
+
+/*
+ *	Execute the prepared statement plan_name whose only parameter is
+ *	a tid array, e.g. "... where ctid = ANY($1::tid[])".
+ *	The tids of keyset[idx[0]] .. keyset[idx[ntids - 1]] are sent as
+ *	one binary array, so the number of the tids is unlimited.
+ */
+QResultClass *
+CC_send_tid_array(ConnectionClass *self, const char *plan_name, const KeySet *keyset, const SQLLEN *idx, int ntids, UDWORD flag, StatementClass *stmt)
+{
+	CSTR	func = "CC_send_tid_array";
+	QResultClass	*res = NULL;
+	PGresult	*pgres = NULL;
+	char		*array = NULL, *ptr;
+	const char	*paramValues[1];
+	int		paramLengths[1], paramFormats[1] = {1};
+	UInt2		offset;
+	int		i, func_cs_count = 0;
+
+	/* header, dimension, and (length, blocknum, offset) per element */
+	paramLengths[0] = 5 * 4 + ntids * (4 + 4 + 2);
+	if (NULL == (array = malloc(paramLengths[0])))
+	{
+		CC_set_error(self, CONN_NO_MEMORY_ERROR, "Could not allocate a tid array", func);
+		return NULL;
+	}
+	ptr = put_uint4(array, 1);		/* ndim */
+	ptr = put_uint4(ptr, 0);		/* no nulls */
+	ptr = put_uint4(ptr, PG_TYPE_TID);	/* element type */
+	ptr = put_uint4(ptr, ntids);		/* dimension */
+	ptr = put_uint4(ptr, 1);		/* lower bound */
+	for (i = 0; i < ntids; i++)
+	{
+		ptr = put_uint4(ptr, 4 + 2);
+		ptr = put_uint4(ptr, keyset[idx[i]].blocknum);
+		offset = htons(keyset[idx[i]].offset);
+		memcpy(ptr, &offset, sizeof(offset));
+		ptr += sizeof(offset);
+	}
+	paramValues[0] = array;
+
+#define	return DONT_CALL_RETURN_FROM_HERE???
+	ENTER_INNER_CONN_CS(self, func_cs_count);
+	if (res = QR_Constructor(), NULL == res)
+	{
+		CC_set_error(self, CONN_NO_MEMORY_ERROR, "Could not create result info in send_tid_array.", func);
+		goto cleanup;
+	}
+	QR_set_conn(res, self);
+	if ((flag & CREATE_KEYSET) != 0)
+	{
+		QR_set_haskeyset(res);
+		if (stmt)
+		{
+			if (stmt->num_key_fields < 0) /* for safety */
+				CheckPgClassInfo(stmt);
+			res->num_key_fields = stmt->num_key_fields;
+		}
+	}
+	CC_discard_marked_objects(self);
+	QLOG(0, "PQexecPrepared: %p plan=%s ntids=%d\n", self->pqconn, plan_name, ntids);
+	pgres = PQexecPrepared(self->pqconn, plan_name, 1,
+						   paramValues, paramLengths, paramFormats, 0);
+	switch (PQresultStatus(pgres))
+	{
+		case PGRES_TUPLES_OK:
+			QLOG(0, "\tok: - 'T' - %s\n", PQcmdStatus(pgres));
+			CC_from_PGresult(res, stmt, self, NULL, &pgres);
+			LIBPQ_update_transaction_status(self);
+			break;
+		default:
+			handle_pgres_error(self, pgres, func, res, TRUE);
+			break;
+	}
+
+cleanup:
+#undef	return
+	CLEANUP_FUNC_CONN_CS(func_cs_count, self);
+	if (pgres)
+		PQclear(pgres);
+	free(array);
+	return res;
+}
+
 
 char
 CC_send_settings(ConnectionClass *self, const char *set_query)
@@ -2582,41 +3225,6 @@ CC_send_settings(ConnectionClass *self, const char *set_query)
 }
 
 
-/*
- *	This function is just a hack to get the oid of our Large Object oid type.
- *	If a real Large Object oid type is made part of Postgres, this function
- *	will go away and the define 'PG_TYPE_LO' will be updated.
- */
-static SQLRETURN
-CC_lookup_lo(ConnectionClass *self)
-{
-	SQLRETURN	ret = SQL_SUCCESS;
-	QResultClass	*res;
-
-	MYLOG(0, "entering...\n");
-
-	res = CC_send_query(self, "select oid, typbasetype from pg_type where typname = '"  PG_TYPE_LO_NAME "'",
-		NULL, READ_ONLY_QUERY, NULL);
-
-	if (!QR_command_maybe_successful(res))
-		ret = SQL_ERROR;
-	else if (QR_command_maybe_successful(res) && QR_get_num_cached_tuples(res) > 0)
-	{
-		OID	basetype;
-
-		self->lobj_type = QR_get_value_backend_int(res, 0, 0, NULL);
-		basetype = QR_get_value_backend_int(res, 0, 1, NULL);
-		if (PG_TYPE_OID == basetype)
-			self->lo_is_domain = 1;
-		else if (0 != basetype)
-			self->lobj_type = 0;
-	}
-	QR_Destructor(res);
-	MYLOG(0, "Got the large object oid: %d\n", self->lobj_type);
-	return ret;
-}
-
-
 /*
  *	This function initializes the version of PostgreSQL from
  *	connInfo.protocol that we're connected to.
@@ -2693,31 +3301,165 @@ int	CC_mark_a_object_to_discard(ConnectionClass *conn, int type, const char *pla
 	return 1;
 }
 
+static void
+discard_command(char *cmd, size_t cmdsize, const char *pname)
+{
+	if ('s' == pname[0])
+		snprintf(cmd, cmdsize, "DEALLOCATE \"%s\"", pname + 1);
+	else
+		snprintf(cmd, cmdsize, "CLOSE \"%s\"", pname + 1);
+}
+
+/*
+ *	Take the marked objects to discard them in the command string buf,
+ *	ahead of the query or behind it. Returns the number of the commands
+ *	appended; *discardp receives the objects in reverse order of the
+ *	commands, to be given back by return_marked_objects().
+ */
+static int
+take_marked_objects(ConnectionClass *conn, PQExpBufferData *buf, BOOL ahead, char ***discardp)
+{
+	int	i, cnt;
+	char	cmd[64];
+
+	cnt = conn->num_discardp;
+	*discardp = conn->discardp;
+	conn->num_discardp = 0;
+	conn->discardp = NULL;
+	for (i = cnt - 1; i >= 0; i--)
+	{
+		discard_command(cmd, sizeof(cmd), (*discardp)[i]);
+		if (ahead)
+			appendPQExpBuffer(buf, "%s;", cmd);
+		else
+			appendPQExpBuffer(buf, ";%s", cmd);
+	}
+
+	return cnt;
+}
+
+/*
+ *	Free the objects taken by take_marked_objects() whose commands got
+ *	a result, and mark the rest, which weren't executed, again.
+ */
+static void
+return_marked_objects(ConnectionClass *conn, char **discardp, int cnt, int done)
+{
+	int	i;
+
+	for (i = 0; i < cnt; i++)
+	{
+		if (i < cnt - done)
+			CC_mark_a_object_to_discard(conn, discardp[i][0], discardp[i] + 1);
+		free(discardp[i]);
+	}
+	free(discardp);
+}
+
+/*
+ *	Can the query follow the commands discarding the marked objects in
+ *	one command string ? Not, for example, VACUUM, which can't run in the
+ *	implicit transaction block of such a string.
+ */
+static BOOL
+query_may_follow_discard(const char *query)
+{
+	const char *q = query;
+
+	while (isspace((UCHAR) *q))
+		q++;
+	return (strnicmp(q, "select", 6) == 0 ||
+			strnicmp(q, "with", 4) == 0 ||
+			strnicmp(q, "declare", 7) == 0 ||
+			strnicmp(q, bgncmd, strlen(bgncmd)) == 0);
+}
+
+/*
+ *	The marked objects are not discarded one by one as soon as possible
+ *	but wait for the next query, so that objects named the same can be
+ *	created again. Mostly they go in the command string of the query
+ *	(see CC_send_query_append()) or in the pipeline of the execution
+ *	(see CC_pipeline_marked_objects()). Otherwise this sends all of them
+ *	in one command string of their own. They are kept while the
+ *	transaction is in error, where they would fail anyway.
+ */
 int	CC_discard_marked_objects(ConnectionClass *conn)
 {
 	int	i, cnt;
 	QResultClass *res;
-	char	*pname, cmd[64];
+	char	**discardp, cmd[64];
+	PQExpBufferData	cmds = {0};
+	BOOL	discarded = FALSE;
 
-	if ((cnt = conn->num_discardp) <= 0)
+	if (!CC_discard_pending(conn))
 		return 0;
+	/* take them, CC_send_query() is called below */
+	cnt = conn->num_discardp;
+	discardp = conn->discardp;
+	conn->num_discardp = 0;
+	conn->discardp = NULL;
+	initPQExpBuffer(&cmds);
 	for (i = cnt - 1; i >= 0; i--)
 	{
-		pname = conn->discardp[i];
-		if ('s' == pname[0])
-			SPRINTF_FIXED(cmd, "DEALLOCATE \"%s\"", pname + 1);
-		else
-			SPRINTF_FIXED(cmd, "CLOSE \"%s\"", pname + 1);
-		res = CC_send_query(conn, cmd, NULL, ROLLBACK_ON_ERROR | IGNORE_ABORT_ON_CONN | READ_ONLY_QUERY, NULL);
+		discard_command(cmd, sizeof(cmd), discardp[i]);
+		appendPQExpBuffer(&cmds, "%s%s", cmd, i > 0 ? ";" : "");
+	}
+	if (!PQExpBufferDataBroken(cmds))
+	{
+		res = CC_send_query(conn, cmds.data, NULL, ROLLBACK_ON_ERROR | IGNORE_ABORT_ON_CONN | READ_ONLY_QUERY, NULL);
+		discarded = QR_command_maybe_successful(res);
 		QR_Destructor(res);
-		free(conn->discardp[i]);
-		conn->num_discardp--;
 	}
+	termPQExpBuffer(&cmds);
+	for (i = cnt - 1; i >= 0; i--)
+	{
+		/* one of them failed, the others may be still there */
+		if (!discarded && cnt > 1)
+		{
+			discard_command(cmd, sizeof(cmd), discardp[i]);
+			res = CC_send_query(conn, cmd, NULL, ROLLBACK_ON_ERROR | IGNORE_ABORT_ON_CONN | READ_ONLY_QUERY, NULL);
+			QR_Destructor(res);
+		}
+		free(discardp[i]);
+	}
+	free(discardp);
 
 	return 1;
 }
 
-static void
+#ifdef	HAVE_PQENTERPIPELINEMODE
+/*
+ *	Put the DEALLOCATE/CLOSE commands for the marked objects into the
+ *	pipeline ahead of an execution, each followed by a Sync so that a
+ *	failure of one of them affects nothing else. Only when no
+ *	transaction is in progress. Returns the number of the commands, or
+ *	-1 if sending failed.
+ */
+int	CC_pipeline_marked_objects(ConnectionClass *conn)
+{
+	PGconn	*pqconn = conn->pqconn;
+	int	i, cnt;
+	char	cmd[64];
+	BOOL	sent = TRUE;
+
+	if (CC_is_in_trans(conn) || !CC_discard_pending(conn))
+		return 0;
+	cnt = conn->num_discardp;
+	for (i = cnt - 1; i >= 0; i--)
+	{
+		discard_command(cmd, sizeof(cmd), conn->discardp[i]);
+		QLOG(0, "PQsendQueryParams: %p '%s' (pipelined)\n", pqconn, cmd);
+		sent = sent && PQsendQueryParams(pqconn, cmd, 0, NULL, NULL, NULL, NULL, 0);
+		sent = sent && PQpipelineSync(pqconn);
+		free(conn->discardp[i]);
+	}
+	conn->num_discardp = 0;
+
+	return sent ? cnt : -1;
+}
+#endif /* HAVE_PQENTERPIPELINEMODE */
+
+void
 LIBPQ_update_transaction_status(ConnectionClass *self)
 {
 	if (!self->pqconn)
@@ -2762,6 +3504,223 @@ LIBPQ_update_transaction_status(ConnectionClass *self)
 	}
 }
 
+/*
+ *	Is the socket of the connection ready for reading (or writing) ?
+ *	Never blocks.
+ */
+BOOL
+CC_socket_ready(const ConnectionClass *self, BOOL for_write)
+{
+	int		sock = PQsocket(self->pqconn);
+	int		ret;
+#ifdef	WIN32
+	WSAPOLLFD	pfd;
+#else
+	struct pollfd	pfd;
+#endif /* WIN32 */
+
+	if (sock < 0)
+		return TRUE;	/* let libpq report the error */
+	/* not select(), the descriptor may well be beyond FD_SETSIZE */
+	pfd.fd = sock;
+	pfd.events = for_write ? POLLOUT : POLLIN;
+	pfd.revents = 0;
+#ifdef	WIN32
+	ret = WSAPoll(&pfd, 1, 0);
+#else
+	ret = poll(&pfd, 1, 0);
+#endif /* WIN32 */
+	if (ret < 0)
+	{
+		MYLOG(0, "poll() failed\n");
+		return FALSE;	/* retried on the next call */
+	}
+	return ret > 0;
+}
+
+/*
+ *	Send a query and collect its results without blocking. Returns
+ *	SQL_STILL_EXECUTING until the whole response has arrived; the query
+ *	is only looked at on the first call. Then *result holds the results
+ *	chained the same as CC_send_query() would return them. Only for the
+ *	asynchronous connection functions: no cursors, savepoints nor
+ *	statements are involved and the transaction status is left to the
+ *	caller.
+ */
+static RETCODE
+CC_async_query(ConnectionClass *self, const char *query, QResultClass **result)
+{
+	CSTR		func = "CC_async_query";
+	PGconn		*pqconn = self->pqconn;
+	PGresult	*pgres;
+	QResultClass	*res;
+	notice_receiver_arg	nrarg;
+	RETCODE		ret = SQL_STILL_EXECUTING;
+
+	*result = NULL;
+	if (NULL == pqconn)
+	{
+		CC_set_error(self, CONNECTION_COMMUNICATION_ERROR, "The connection has been lost", func);
+		return SQL_ERROR;
+	}
+	if (!self->async.sent)
+	{
+		QLOG(0, "PQsendQuery: %p '%s'\n", pqconn, query);
+		if (0 != PQsetnonblocking(pqconn, 1) ||
+			!PQsendQuery(pqconn, query))
+		{
+			CC_set_error(self, CONNECTION_COMMUNICATION_ERROR, PQerrorMessage(pqconn), func);
+			PQsetnonblocking(pqconn, 0);
+			return SQL_ERROR;
+		}
+		self->async.sent = TRUE;
+		self->async.flushed = FALSE;
+	}
+	if (!self->async.flushed)
+	{
+		if (PQflush(pqconn) > 0)
+		{
+			/* the server may be waiting for us to read */
+			if (CC_socket_ready(self, FALSE))
+				PQconsumeInput(pqconn);
+			return SQL_STILL_EXECUTING;
+		}
+		self->async.flushed = TRUE;
+	}
+
+	nrarg.conn = self;
+	nrarg.comment = func;
+	nrarg.res = self->async.last_res;
+	nrarg.stmt = NULL;
+	PQsetNoticeReceiver(pqconn, receive_libpq_notice, &nrarg);
+	for (;;)
+	{
+		if (PQisBusy(pqconn))
+		{
+			if (!CC_socket_ready(self, FALSE))
+				break;
+			/* on failure PQgetResult() returns the error at once */
+			if (PQconsumeInput(pqconn) && PQisBusy(pqconn))
+				break;
+		}
+		if (pgres = PQgetResult(pqconn), NULL == pgres)
+		{
+			ret = SQL_SUCCESS;
+			break;
+		}
+		if (res = QR_Constructor(), NULL == res)
+		{
+			CC_set_error(self, CONN_NO_MEMORY_ERROR, "Could not create result info in send_query.", func);
+			PQclear(pgres);
+			continue;
+		}
+		if (NULL == self->async.res)
+			self->async.res = res;
+		else
+			QR_concat(self->async.last_res, res);
+		self->async.last_res = res;
+		nrarg.res = res;
+		switch (PQresultStatus(pgres))
+		{
+			case PGRES_COMMAND_OK:
+				QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+				QR_set_command(res, PQcmdStatus(pgres));
+				QR_set_rstatus(res, PORES_COMMAND_OK);
+				break;
+			case PGRES_TUPLES_OK:
+				CC_from_PGresult(res, NULL, self, NULL, &pgres);
+				break;
+			case PGRES_EMPTY_QUERY:
+				QR_set_rstatus(res, PORES_EMPTY_QUERY);
+				break;
+			case PGRES_NONFATAL_ERROR:
+				handle_pgres_error(self, pgres, func, res, FALSE);
+				break;
+			default:
+				handle_pgres_error(self, pgres, func, res, TRUE);
+				break;
+		}
+		if (NULL != pgres)
+			PQclear(pgres);
+		/* CC_send_query() reports an error in the head of the results */
+		if (!QR_command_maybe_successful(res) &&
+			res != self->async.res &&
+			QR_command_maybe_successful(self->async.res))
+		{
+			QR_set_rstatus(self->async.res, QR_get_rstatus(res));
+			QR_set_message(self->async.res, QR_get_message(res));
+		}
+	}
+	PQsetNoticeReceiver(pqconn, receive_libpq_notice, NULL);
+	if (SQL_STILL_EXECUTING == ret)
+		return ret;
+
+	PQsetnonblocking(pqconn, 0);
+	self->async.sent = FALSE;
+	*result = res = self->async.res;
+	self->async.res = self->async.last_res = NULL;
+	if (NULL == res)
+	{
+		CC_set_error(self, CONN_NO_MEMORY_ERROR, "Could not create result info in send_query.", func);
+		return SQL_ERROR;
+	}
+	if (!QR_command_maybe_successful(res))
+	{
+		CC_set_error_if_not_set(self, CONN_EXEC_ERROR, QR_get_message(res), func);
+		ret = SQL_ERROR;
+	}
+	else if (CONN_NO_MEMORY_ERROR == CC_get_errornumber(self))
+		ret = SQL_ERROR;
+	if (CONNECTION_BAD == PQstatus(pqconn))
+	{
+		self->status = CONN_DOWN;
+		ret = SQL_ERROR;
+	}
+
+	return ret;
+}
+
+/*
+ *	Make progress with a connection started by PQconnectStartParams()
+ *	without blocking. Returns TRUE when libpq has either established
+ *	the connection or failed, FALSE if we have to be called again.
+ */
+static BOOL
+CC_poll_connect(ConnectionClass *self)
+{
+	for (;;)
+	{
+		switch (self->async.poll_status)
+		{
+			case PGRES_POLLING_OK:
+			case PGRES_POLLING_FAILED:
+				return TRUE;
+			case PGRES_POLLING_READING:
+				if (!CC_socket_ready(self, FALSE))
+					goto not_ready;
+				break;
+			case PGRES_POLLING_WRITING:
+				if (!CC_socket_ready(self, TRUE))
+					goto not_ready;
+				break;
+			default:
+				break;
+		}
+		self->async.poll_status = PQconnectPoll(self->pqconn);
+	}
+
+not_ready:
+	if (self->login_timeout > 0 &&
+		time(NULL) - self->pqconn_created >= (time_t) self->login_timeout)
+	{
+		MYLOG(0, "login timeout expired\n");
+		self->async.poll_status = PGRES_POLLING_FAILED;
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
 #define        PROTOCOL3_OPTS_MAX      30
 
 static int
@@ -2781,8 +3740,20 @@ LIBPQ_connect(ConnectionClass *self)
 	char		keepalive_interval_str[20];
 	char		*errmsg = NULL;
 
+	/* called again to complete an asynchronous connect */
+	if (CONN_ASYNC_CONNECT == self->async.op)
+	{
+		pqconn = self->pqconn;
+		goto poll_connect;
+	}
 	MYLOG(0, "connecting to the database using %s as the server and pqopt={%s}\n", self->connInfo.server, SAFE_NAME(ci->pqopt));
 
+	if (CC_get_pooled_pqconn(self))
+	{
+		pqconn = self->pqconn;
+		QLOG(0, "reusing a pooled connection %p\n", pqconn);
+		goto established;
+	}
 	if (NULL == (conninfoOption = PQconninfoParse(SAFE_NAME(ci->pqopt), &errmsg)))
 	{
 		char emsg[200];
@@ -2892,18 +3863,41 @@ LIBPQ_connect(ConnectionClass *self)
 	{
 		const char **popt, **pval;
 
-		QLOG(0, "PQconnectdbParams:");
+		QLOG(0, "%s:", self->async.enabled ? "PQconnectStartParams" : "PQconnectdbParams");
 		for (popt = opts, pval = vals; *popt; popt++, pval++)
 			QPRINTF(0, " %s='%s'", *popt, *pval);
 		QPRINTF(0, "\n");
 	}
-	pqconn = PQconnectdbParams(opts, vals, FALSE);
+	if (self->async.enabled)
+		pqconn = PQconnectStartParams(opts, vals, FALSE);
+	else
+		pqconn = PQconnectdbParams(opts, vals, FALSE);
 	if (!pqconn)
 	{
 		CC_set_error(self, CONN_OPENDB_ERROR, "PQconnectdb error", func);
 		goto cleanup;
 	}
 	self->pqconn = pqconn;
+	self->pqconn_created = time(NULL);
+
+	if (self->async.enabled && CONNECTION_BAD != PQstatus(pqconn))
+	{
+		self->async.op = CONN_ASYNC_CONNECT;
+		self->async.poll_status = PGRES_POLLING_WRITING;
+poll_connect:
+		if (!CC_poll_connect(self))
+		{
+			ret = CONNECT_IN_PROGRESS;
+			goto cleanup;
+		}
+		/* PQconnectPoll() doesn't care about connect_timeout */
+		if (PGRES_POLLING_FAILED == self->async.poll_status &&
+			CONNECTION_BAD != PQstatus(pqconn))
+		{
+			CC_set_error(self, CONNECTION_SERVER_NOT_REACHED, "timeout expired", func);
+			goto cleanup;
+		}
+	}
 
 	pqret = PQstatus(pqconn);
 	if (pqret == CONNECTION_BAD && PQconnectionNeedsPassword(pqconn))
@@ -2931,6 +3925,7 @@ MYLOG(DETAIL_LOG_LEVEL, "status=%d\n", pqret);
 		goto cleanup;
 	}
 
+established:
 	MYLOG(0, "libpq connection to the database established.\n");
 	pversion = PQprotocolVersion(pqconn);
 	if (pversion < 3)
@@ -2959,7 +3954,7 @@ cleanup:
 	if (errmsg != NULL)
 		free(errmsg);
 	PQconninfoFree(conninfoOption);
-	if (ret != 1)
+	if (ret != 1 && ret != CONNECT_IN_PROGRESS)
 	{
 		if (self->pqconn)
 		{
@@ -2973,6 +3968,20 @@ cleanup:
 	return ret;
 }
 
+/*
+ *	The connection can't be used until the asynchronous execution
+ *	of a statement ends.
+ */
+BOOL
+CC_async_busy(ConnectionClass *self, const char *func)
+{
+	if (!CC_async_pending(self))
+		return FALSE;
+	CC_set_error(self, CONN_STILL_EXECUTING, "An asynchronous execution is in progress on the connection.", func);
+
+	return TRUE;
+}
+
 int
 CC_send_cancel_request(const ConnectionClass *conn)
 {
@@ -3575,10 +4584,25 @@ PgDtc_isolate(void *self, DWORD option)
 
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
 
+static const char *
+isolation_set_query(UInt4 isolation)
+{
+	switch (isolation)
+	{
+		case SQL_TXN_SERIALIZABLE:
+			return "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL SERIALIZABLE";
+		case SQL_TXN_REPEATABLE_READ:
+			return "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL REPEATABLE READ";
+		case SQL_TXN_READ_UNCOMMITTED:
+			return "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL READ UNCOMMITTED";
+	}
+	return "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL READ COMMITTED";
+}
+
 BOOL
 CC_set_transact(ConnectionClass *self, UInt4 isolation)
 {
-	char *query;
+	const char *query;
 	QResultClass *res;
 	BOOL	bShow = FALSE;
 
@@ -3590,21 +4614,7 @@ CC_set_transact(ConnectionClass *self, UInt4 isolation)
 		return FALSE;
 	}
 
-	switch (isolation)
-	{
-		case SQL_TXN_SERIALIZABLE:
-			query = "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL SERIALIZABLE";
-						break;
-		case SQL_TXN_REPEATABLE_READ:
-			query = "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL REPEATABLE READ";
-			break;
-		case SQL_TXN_READ_UNCOMMITTED:
-			query = "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL READ UNCOMMITTED";
-			break;
-		default:
-			query = "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL READ COMMITTED";
-			break;
-	}
+	query = isolation_set_query(isolation);
 	if (self->default_isolation == 0)
 		bShow = TRUE;
 	if (bShow)
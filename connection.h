@@ -13,6 +13,14 @@
 #include <libpq-fe.h>
 #include "pqexpbuffer.h"
 
+/*
+ * Windows builds don't run configure. libpq-fe.h of PostgreSQL 14 or
+ * later defines LIBPQ_HAS_PIPELINING instead.
+ */
+#if	defined(WIN32) && defined(LIBPQ_HAS_PIPELINING) && !defined(NO_PIPELINE_MODE) && !defined(HAVE_PQENTERPIPELINEMODE)
+#define	HAVE_PQENTERPIPELINEMODE	1
+#endif
+
 #include <time.h>
 
 #include <stdlib.h>
@@ -71,6 +79,7 @@ typedef enum
 
 #define CONN_OPTION_NOT_FOR_THE_DRIVER					216
 #define CONN_EXEC_ERROR							217
+#define CONN_STILL_EXECUTING						218
 
 /* Conn_status defines */
 #define CONN_IN_AUTOCOMMIT		1L
@@ -80,6 +89,11 @@ typedef enum
 
 /* not connected yet || already disconnected */
 #define	CC_not_connected(x)	(!(x) || CONN_DOWN == (x)->status || CONN_NOT_CONNECTED == (x)->status)
+/* are there marked objects which can be discarded now ? */
+#define	CC_discard_pending(x)	((x)->num_discardp > 0 && !CC_is_in_error_trans(x))
+#define	CC_is_async_connecting(x)	(CONN_ASYNC_CONNECT == (x)->async.op || CONN_ASYNC_SETUP == (x)->async.op)
+#define	CC_async_pending(x)	(NULL != (x)->async_stmt)
+#define	CC_is_async_disconnecting(x)	(CONN_ASYNC_DISCONNECT_ROLLBACK == (x)->async.op || CONN_ASYNC_DISCONNECT_RESET == (x)->async.op)
 
 /* AutoCommit functions */
 #define CC_is_in_autocommit(x)		(x->transact_status & CONN_IN_AUTOCOMMIT)
@@ -274,11 +288,40 @@ typedef BOOL (WINAPI * DriverToDataSourceProc) (UDWORD, SWORD, PTR,
 		SDWORD, PTR, SDWORD, SDWORD *, UCHAR *, SWORD,
 		SWORD *);
 
+/*
+ *	The operation in progress with SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE on.
+ *	The function which started it is called again with the same
+ *	arguments until it returns something other than SQL_STILL_EXECUTING.
+ */
+enum {
+	CONN_ASYNC_NONE = 0
+	,CONN_ASYNC_CONNECT	/* PQconnectPoll() in progress */
+	,CONN_ASYNC_SETUP	/* the bootstrap query in progress */
+	,CONN_ASYNC_ENDTRAN	/* COMMIT or ROLLBACK in progress */
+	,CONN_ASYNC_DISCONNECT_ROLLBACK	/* ROLLBACK before pooling */
+	,CONN_ASYNC_DISCONNECT_RESET	/* resetting the session before pooling */
+};
+typedef struct
+{
+	char		enabled;	/* SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE */
+	char		op;		/* CONN_ASYNC_xxxx */
+	char		sent;		/* the query has been sent */
+	char		flushed;	/* and has left the output buffer */
+	int		poll_status;	/* of PQconnectPoll() */
+	QResultClass	*res;		/* the results received so far */
+	QResultClass	*last_res;
+} ConnAsyncInfo;
+
+/* return value of CC_connect() while an asynchronous connect is in progress */
+#define	CONNECT_IN_PROGRESS	3
+
 /*******	The Connection handle	************/
 struct ConnectionClass_
 {
 	HENV		henv;		/* environment this connection was
 					 * created on */
+	ConnectionClass	*prev_in_env;	/* the connections of henv */
+	ConnectionClass	*next_in_env;
 	SQLUINTEGER	login_timeout;
 	signed char	autocommit_public;
 	StatementOptions stmtOptions;
@@ -289,10 +332,15 @@ struct ConnectionClass_
 	char		sqlstate[8];
 	CONN_Status	status;
 	ConnInfo	connInfo;
-	StatementClass	**stmts;
-	Int2		num_stmts;
+	StatementClass	**stmts;	/* the statements, packed in [0, num_stmts) */
+	Int4		num_stmts;
+	Int4		stmts_allocated;
+	StatementClass	*cursor_stmts;	/* the statements which may hold cursors */
 	Int2		ncursors;
 	PGconn	   *pqconn;
+	time_t		pqconn_created;	/* kept across reuse from the pool */
+	char	   *pool_key;	/* the pool key of the requested connection */
+	char	   *pool_pwhash;	/* and the digest of its password */
 	Int4		lobj_type;
 	Int2		coli_allocated;
 	Int2		ntables;
@@ -342,6 +390,9 @@ struct ConnectionClass_
 	pgNAME		schemaIns;
 	pgNAME		tableIns;
 	SQLULEN		stmt_timeout_in_effect;
+	ConnAsyncInfo	async;
+	StatementClass	*async_stmt;	/* the statement whose asynchronous
+								 * execution is in flight */
 #if defined(WIN_MULTITHREAD_SUPPORT)
 	CRITICAL_SECTION	cs;
 	CRITICAL_SECTION	slock;
@@ -411,9 +462,13 @@ char		CC_abort(ConnectionClass *self);
 char		CC_set_autocommit(ConnectionClass *self, BOOL on);
 int		CC_set_translation(ConnectionClass *self);
 char		CC_connect(ConnectionClass *self, char *salt);
+RETCODE		CC_async_end_trans(ConnectionClass *self, BOOL commit);
+RETCODE		CC_async_disconnect(ConnectionClass *self);
+BOOL		CC_socket_ready(const ConnectionClass *self, BOOL for_write);
 char		CC_add_statement(ConnectionClass *self, StatementClass *stmt);
 char		CC_remove_statement(ConnectionClass *self, StatementClass *stmt)
 ;
+void		CC_add_cursor_statement(ConnectionClass *self, StatementClass *stmt);
 char		CC_add_descriptor(ConnectionClass *self, DescriptorClass *desc);
 char		CC_remove_descriptor(ConnectionClass *self, DescriptorClass *desc);
 void		CC_set_error(ConnectionClass *self, int number, const char *message, const char *func);
@@ -426,10 +481,14 @@ void		handle_pgres_error(ConnectionClass *self, const PGresult *pgres,
 				   QResultClass *res, BOOL error_not_a_notice);
 void		CC_clear_error(ConnectionClass *self);
 int		CC_send_function(ConnectionClass *conn, const char *fn_name, void *result_buf, int *actual_result_len, int result_is_int, LO_ARG *argv, int nargs);
+BOOL		CC_prepare_query(ConnectionClass *self, const char *plan_name, const char *query, int nParams, const Oid *paramTypes);
+QResultClass	*CC_send_tid_array(ConnectionClass *self, const char *plan_name, const KeySet *keyset, const SQLLEN *idx, int ntids, UDWORD flag, StatementClass *stmt);
 char		CC_send_settings(ConnectionClass *self, const char *set_query);
 void		CC_initialize_pg_version(ConnectionClass *conn);
 void		CC_log_error(const char *func, const char *desc, const ConnectionClass *self);
 int			CC_send_cancel_request(const ConnectionClass *conn);
+BOOL		CC_async_busy(ConnectionClass *self, const char *func);
+void		LIBPQ_update_transaction_status(ConnectionClass *self);
 void		CC_on_commit(ConnectionClass *conn);
 void		CC_on_abort(ConnectionClass *conn, unsigned int opt);
 void		CC_on_abort_partial(ConnectionClass *conn);
@@ -437,9 +496,13 @@ void		ProcessRollback(ConnectionClass *conn, BOOL undo, BOOL partial);
 const char	*CC_get_current_schema(ConnectionClass *conn);
 int             CC_mark_a_object_to_discard(ConnectionClass *conn, int type, const char *plan);
 int             CC_discard_marked_objects(ConnectionClass *conn);
+#ifdef	HAVE_PQENTERPIPELINEMODE
+int		CC_pipeline_marked_objects(ConnectionClass *conn);
+#endif /* HAVE_PQENTERPIPELINEMODE */
 
 int		CC_get_max_idlen(ConnectionClass *self);
 char	CC_get_escape(const ConnectionClass *self);
+BOOL	CC_integer_datetimes(const ConnectionClass *self);
 char *		identifierEscape(const SQLCHAR *src, SQLLEN srclen, const ConnectionClass *conn, char *buf, size_t bufsize, BOOL double_quote);
 int		findIdentifier(const UCHAR *str, int ccsc, const UCHAR **next_token);
 int		eatTableIdentifiers(const UCHAR *str, int ccsc, pgNAME *table, pgNAME *schema);
@@ -2138,6 +2138,8 @@ typedef enum
 #define	FLGB_LITERAL_EXTENSION	(1L << 10)
 #define	FLGB_HEX_BIN_FORMAT	(1L << 11)
 #define	FLGB_PARAM_CAST		(1L << 12)
+#define	FLGB_CACHE_PARAM_VALUES	(1L << 13)
+#define	FLGB_BINARY_BY_PGTYPE	(1L << 14)
 typedef struct _QueryBuild {
 	char   *query_statement;
 	size_t	str_alsize;
@@ -2846,7 +2848,7 @@ cleanup:
 /*
  * Describe the parameters and portal for given query.
  */
-static RETCODE
+RETCODE
 desc_params_and_sync(StatementClass *stmt)
 {
 	CSTR		func = "desc_params_and_sync";
@@ -3077,7 +3079,7 @@ MYLOG(DETAIL_LOG_LEVEL, "type=" FORMAT_UINTEGER " concur=" FORMAT_UINTEGER "\n",
 	{
 		const char *opt_scroll = NULL_STRING, *opt_hold = NULL_STRING;
 
-		if (ci->drivers.use_declarefetch
+		if (SC_should_use_cursor(stmt, ci)
 			 /** && SQL_CONCUR_READ_ONLY == stmt->options.scroll_concurrency **/
 			)
 		{
@@ -4042,6 +4044,10 @@ cleanup:
 /*
  * Build an array of parameters to pass to libpq's PQexecPrepared
  * function.
+ *
+ * The arrays returned point into stmt->exec_params, which is kept with
+ * the statement and reused by the next execution. The caller must not
+ * free them.
  */
 BOOL
 build_libpq_bind_params(StatementClass *stmt,
@@ -4060,6 +4066,7 @@ build_libpq_bind_params(StatementClass *stmt,
 	BOOL		ret = FALSE, discard_output;
 	RETCODE		retval;
 	const		IPDFields *ipdopts = SC_get_IPDF(stmt);
+	ExecParamsInfo	*eparams = SC_get_EPRM(stmt);
 
 	*paramTypes = NULL;
 	*paramValues = NULL;
@@ -4090,22 +4097,26 @@ build_libpq_bind_params(StatementClass *stmt,
 
 	if (num_params > 0)
 	{
-		*paramTypes = malloc(sizeof(OID) * num_params);
-		if (*paramTypes == NULL)
-			goto cleanup;
-		*paramValues = malloc(sizeof(char *) * num_params);
-		if (*paramValues == NULL)
-			goto cleanup;
-		pg_memset(*paramValues, 0, sizeof(char *) * num_params);
-		*paramLengths = malloc(sizeof(int) * num_params);
-		if (*paramLengths == NULL)
-			goto cleanup;
-		*paramFormats = malloc(sizeof(int) * num_params);
-		if (*paramFormats == NULL)
+		if (!extend_execparams_info(eparams, num_params))
 			goto cleanup;
+		*paramTypes = eparams->paramTypes;
+		*paramValues = eparams->paramValues;
+		*paramLengths = eparams->paramLengths;
+		*paramFormats = eparams->paramFormats;
 	}
 
 	qb.flags |= FLGB_BINARY_AS_POSSIBLE;
+	if (conn->connInfo.cache_param_values > 0)
+		qb.flags |= FLGB_CACHE_PARAM_VALUES;
+	/*
+	 * The parameter types of an already prepared (and described) plan
+	 * are known, so values can be sent in their binary format.
+	 */
+	if ((stmt->prepared == PREPARED_PERMANENTLY ||
+	     (stmt->prepared == PREPARED_TEMPORARILY && conn->unnamed_prepared_stmt == stmt)) &&
+	    NULL != stmt->processed_statements &&
+	    NULL == stmt->processed_statements->next)
+		qb.flags |= FLGB_BINARY_BY_PGTYPE;
 
 	MYLOG(DETAIL_LOG_LEVEL, "num_params=%d proc_return=%d\n", num_params, stmt->proc_return);
 	num_p = num_params - qb.num_discard_params;
@@ -4116,14 +4127,17 @@ MYLOG(DETAIL_LOG_LEVEL, "num_p=%d\n", num_p);
 	{
 		ParameterImplClass	*parameters = ipdopts->parameters;
 		int	pno;
+		size_t	valpos = 0;
 
 		BOOL	isnull;
 		BOOL	isbinary;
-		char	*val_copy;
 		OID	pgType;
 
 		/*
 		 * Now build the parameter values.
+		 * The values are packed into eparams->valbuf one after another.
+		 * A null value is marked with the length -1 until all values
+		 * are in place, because valbuf may move while it grows.
 		 */
 		for (i = 0, pno = 0; i < stmt->num_params; i++)
 		{
@@ -4145,31 +4159,28 @@ MYLOG(DETAIL_LOG_LEVEL, "num_p=%d\n", num_p);
 				if (discard_output)
 					continue;
 				(*paramTypes)[pno] = PG_TYPE_VOID;
-				(*paramValues)[pno] = NULL;
-				(*paramLengths)[pno] = 0;
+				(*paramLengths)[pno] = -1;
 				(*paramFormats)[pno] = 0;
 				pno++;
 				continue;
 			}
 			if (!isnull)
 			{
-				val_copy = malloc(qb.npos + 1);
-				if (!val_copy)
+				if (qb.npos > INT_MAX)
+					goto cleanup;
+				if (!EPARAMS_reserve_values(eparams, valpos + qb.npos + 1))
 					goto cleanup;
-				memcpy(val_copy, qb.query_statement, qb.npos);
-				val_copy[qb.npos] = '\0';
+				memcpy(eparams->valbuf + valpos, qb.query_statement, qb.npos);
+				eparams->valbuf[valpos + qb.npos] = '\0';
+				valpos += qb.npos + 1;
 
 				(*paramTypes)[pno] = pgType;
-				(*paramValues)[pno] = val_copy;
-				if (qb.npos > INT_MAX)
-					goto cleanup;
 				(*paramLengths)[pno] = (int) qb.npos;
 			}
 			else
 			{
 				(*paramTypes)[pno] = pgType;
-				(*paramValues)[pno] = NULL;
-				(*paramLengths)[pno] = 0;
+				(*paramLengths)[pno] = -1;
 			}
 			if (isbinary)
 				MYLOG(0, "%dth parameter is of binary format\n", pno);
@@ -4178,6 +4189,21 @@ MYLOG(DETAIL_LOG_LEVEL, "num_p=%d\n", num_p);
 			pno++;
 		}
 		*nParams = pno;
+
+		/* Now that valbuf doesn't move any longer, set the value pointers */
+		for (i = 0, valpos = 0; i < pno; i++)
+		{
+			if ((*paramLengths)[i] < 0)
+			{
+				(*paramValues)[i] = NULL;
+				(*paramLengths)[i] = 0;
+			}
+			else
+			{
+				(*paramValues)[i] = eparams->valbuf + valpos;
+				valpos += (*paramLengths)[i] + 1;
+			}
+		}
 	}
 
 	/* result format is text */
@@ -4465,6 +4491,461 @@ handle_lu_onvert_error(QueryBuild *qb, int flag, char *buffer, SQLLEN paralen)
 }
 #endif /* UNICODE_SUPPORT */
 
+/*
+ * Helper functions to build the binary format of parameters.
+ * PostgreSQL sends integers in network byte order.
+ */
+static void
+put_int_be(char *buf, SQLUBIGINT val, int len)
+{
+	int	i;
+
+	for (i = len - 1; i >= 0; i--)
+	{
+		buf[i] = (char) (val & 0xff);
+		val >>= 8;
+	}
+}
+
+#define	POSTGRES_EPOCH_JDATE	2451545	/* date2j(2000, 1, 1) */
+#define	USECS_PER_DAY	((Int8) 86400 * 1000000)
+
+/* the same as date2j() of the server */
+static int
+date2j(int y, int m, int d)
+{
+	int	julian, century;
+
+	if (m > 2)
+	{
+		m += 1;
+		y += 4800;
+	}
+	else
+	{
+		m += 13;
+		y += 4799;
+	}
+
+	century = y / 100;
+	julian = y * 365 - 32167;
+	julian += y / 4 - century + century / 4;
+	julian += 7834 * m / 256 + d;
+
+	return julian;
+}
+
+static BOOL
+valid_ymd(int y, int m, int d)
+{
+	static const int mdays[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+	if (y < 1 || y > 9999 || m < 1 || m > 12 || d < 1 || d > mdays[m - 1])
+		return FALSE;
+	if (2 == m && 29 == d &&
+	    (0 != y % 4 || (0 == y % 100 && 0 != y % 400)))
+		return FALSE;
+	return TRUE;
+}
+
+static BOOL
+valid_hms(int hh, int mm, int ss)
+{
+	return (hh >= 0 && hh < 24 && mm >= 0 && mm < 60 && ss >= 0 && ss < 60);
+}
+
+/*
+ * Convert a numeric string (as made by ResolveNumericParam) into
+ * the binary format of numeric type, i.e. base 10000 digits preceded
+ * by ndigits, weight, sign and dscale.
+ */
+static SQLLEN
+numeric_to_binary(const char *num, char *binbuf, size_t bufsize)
+{
+	const char	*intp, *fracp = NULL;
+	size_t	intlen, fraclen = 0;
+	int	ngroups, nint, weight, i, j, start, end;
+	BOOL	negative = FALSE;
+	Int2	*digits;
+	char	*p;
+
+	if ('-' == *num)
+	{
+		negative = TRUE;
+		num++;
+	}
+	for (; '0' == *num; num++)
+		;
+	intp = num;
+	for (; isdigit((unsigned char) *num); num++)
+		;
+	intlen = num - intp;
+	if ('.' == *num)
+	{
+		fracp = ++num;
+		for (; isdigit((unsigned char) *num); num++)
+			;
+		fraclen = num - fracp;
+	}
+	if ('\0' != *num)
+		return -1;
+
+	nint = (int) ((intlen + 3) / 4);
+	ngroups = nint + (int) ((fraclen + 3) / 4);
+	if (8 + ngroups * 2 > bufsize)
+		return -1;
+	digits = (Int2 *) malloc(sizeof(Int2) * (ngroups + 1));
+	if (NULL == digits)
+		return -1;
+	/* the integral part is aligned to the right, the fraction to the left */
+	for (i = 0; i < ngroups; i++)
+		digits[i] = 0;
+	for (i = 0; i < (int) intlen; i++)
+	{
+		j = nint - 1 - (int) (intlen - 1 - i) / 4;
+		digits[j] = digits[j] * 10 + (intp[i] - '0');
+	}
+	for (i = 0; i < (int) ((fraclen + 3) / 4) * 4; i++)
+	{
+		j = nint + i / 4;
+		digits[j] = digits[j] * 10 + (i < (int) fraclen ? fracp[i] - '0' : 0);
+	}
+
+	/* strip leading and trailing zero digits */
+	weight = nint - 1;
+	for (start = 0; start < ngroups && 0 == digits[start]; start++)
+		weight--;
+	for (end = ngroups; end > start && 0 == digits[end - 1]; end--)
+		;
+	if (start == end)
+	{
+		weight = 0;
+		negative = FALSE;
+	}
+
+	p = binbuf;
+	put_int_be(p, end - start, 2);
+	put_int_be(p + 2, (UInt2) weight, 2);
+	put_int_be(p + 4, negative ? 0x4000 : 0, 2);
+	put_int_be(p + 6, fraclen, 2);
+	p += 8;
+	for (i = start; i < end; i++, p += 2)
+		put_int_be(p, digits[i], 2);
+	free(digits);
+
+	return p - binbuf;
+}
+
+/*
+ * Get the value of a parameter of an integer C type.
+ */
+static BOOL
+get_integer_param(const char *buffer, SQLSMALLINT ctype, Int8 *ival)
+{
+	switch (ctype)
+	{
+		case SQL_C_SLONG:
+		case SQL_C_LONG:
+			*ival = *((SQLINTEGER *) buffer);
+			break;
+		case SQL_C_ULONG:
+			*ival = *((SQLUINTEGER *) buffer);
+			break;
+		case SQL_C_SSHORT:
+		case SQL_C_SHORT:
+			*ival = *((SQLSMALLINT *) buffer);
+			break;
+		case SQL_C_USHORT:
+			*ival = *((SQLUSMALLINT *) buffer);
+			break;
+		case SQL_C_STINYINT:
+		case SQL_C_TINYINT:
+			*ival = *((SCHAR *) buffer);
+			break;
+		case SQL_C_UTINYINT:
+			*ival = *((UCHAR *) buffer);
+			break;
+#ifdef ODBCINT64
+		case SQL_C_SBIGINT:
+			*ival = *((SQLBIGINT *) buffer);
+			break;
+		case SQL_C_UBIGINT:
+			if (*((SQLUBIGINT *) buffer) > (SQLUBIGINT) INT64_MAX)
+				return FALSE;
+			*ival = (Int8) *((SQLUBIGINT *) buffer);
+			break;
+#endif /* ODBCINT64 */
+		default:
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/*
+ * Convert a parameter into the binary format of pgtype, the type the
+ * server resolved for the parameter. The value must be the same as the
+ * server would get from the text format.
+ *
+ * Returns the length of the value stored in binbuf, or -1 if the text
+ * format should be used.
+ */
+static SQLLEN
+ResolveBinaryParam(const ConnectionClass *conn, const char *buffer,
+				   SQLSMALLINT ctype, SQLSMALLINT sqltype, OID pgtype,
+				   char *binbuf, size_t bufsize)
+{
+	Int8	ival;
+	int	y, m, d, hh = 0, mm = 0, ss = 0;
+	SQLUINTEGER	fr = 0;
+	BOOL	has_date = FALSE, has_time = FALSE;
+
+	if (bufsize < 16)
+		return -1;
+	switch (pgtype)
+	{
+		case PG_TYPE_INT2:
+		case PG_TYPE_INT4:
+		case PG_TYPE_INT8:
+			switch (sqltype)
+			{
+				case SQL_TINYINT:
+				case SQL_SMALLINT:
+				case SQL_INTEGER:
+				case SQL_BIGINT:
+				case SQL_NUMERIC:
+				case SQL_DECIMAL:
+					break;
+				default:
+					return -1;
+			}
+			if (!get_integer_param(buffer, ctype, &ival))
+				return -1;
+			switch (pgtype)
+			{
+				case PG_TYPE_INT2:
+					if (ival < SHRT_MIN || ival > SHRT_MAX)
+						return -1;
+					put_int_be(binbuf, (SQLUBIGINT) ival, 2);
+					return 2;
+				case PG_TYPE_INT4:
+					if (ival < INT_MIN || ival > INT_MAX)
+						return -1;
+					put_int_be(binbuf, (SQLUBIGINT) ival, 4);
+					return 4;
+			}
+			put_int_be(binbuf, (SQLUBIGINT) ival, 8);
+			return 8;
+
+		case PG_TYPE_FLOAT4:
+		case PG_TYPE_FLOAT8:
+			switch (sqltype)
+			{
+				case SQL_REAL:
+				case SQL_FLOAT:
+				case SQL_DOUBLE:
+				case SQL_NUMERIC:
+				case SQL_DECIMAL:
+					break;
+				default:
+					return -1;
+			}
+			/*
+			 * The text format is precise enough to get the same float
+			 * back, but e.g. a float printed with %g isn't the same
+			 * double as the float itself.
+			 */
+			if (SQL_C_DOUBLE == ctype && PG_TYPE_FLOAT8 == pgtype)
+			{
+				SDOUBLE		dbv = *((SDOUBLE *) buffer);
+				SQLUBIGINT	bits;
+
+				memcpy(&bits, &dbv, sizeof(bits));
+				put_int_be(binbuf, bits, 8);
+				return 8;
+			}
+			if (SQL_C_FLOAT == ctype && PG_TYPE_FLOAT4 == pgtype)
+			{
+				SFLOAT	flv = *((SFLOAT *) buffer);
+				UInt4	bits;
+
+				memcpy(&bits, &flv, sizeof(bits));
+				put_int_be(binbuf, bits, 4);
+				return 4;
+			}
+			return -1;
+
+		case PG_TYPE_NUMERIC:
+			if (SQL_C_NUMERIC != ctype ||
+			    (SQL_NUMERIC != sqltype && SQL_DECIMAL != sqltype))
+				return -1;
+			{
+				char	numstr[150];
+
+				ResolveNumericParam((SQL_NUMERIC_STRUCT *) buffer, numstr);
+				return numeric_to_binary(numstr, binbuf, bufsize);
+			}
+
+		case PG_TYPE_UUID:
+			if (SQL_C_GUID != ctype || SQL_GUID != sqltype)
+				return -1;
+			{
+				const SQLGUID *g = (const SQLGUID *) buffer;
+
+				put_int_be(binbuf, g->Data1, 4);
+				put_int_be(binbuf + 4, g->Data2, 2);
+				put_int_be(binbuf + 6, g->Data3, 2);
+				memcpy(binbuf + 8, g->Data4, 8);
+				return 16;
+			}
+
+		case PG_TYPE_DATE:
+			if (SQL_DATE != sqltype && SQL_TYPE_DATE != sqltype)
+				return -1;
+			has_date = TRUE;
+			break;
+		case PG_TYPE_TIME:
+			if (SQL_TIME != sqltype && SQL_TYPE_TIME != sqltype)
+				return -1;
+			has_time = TRUE;
+			break;
+		case PG_TYPE_TIMESTAMP_NO_TMZONE:
+			if (SQL_TIMESTAMP != sqltype && SQL_TYPE_TIMESTAMP != sqltype)
+				return -1;
+			has_date = has_time = TRUE;
+			break;
+		default:
+			return -1;
+	}
+
+	/* date/time types */
+	if (has_time && !CC_integer_datetimes(conn))
+		return -1;
+	switch (ctype)
+	{
+		case SQL_C_DATE:
+		case SQL_C_TYPE_DATE:
+			{
+				const DATE_STRUCT *ds = (const DATE_STRUCT *) buffer;
+
+				if (PG_TYPE_TIME == pgtype)
+					return -1;
+				y = ds->year;
+				m = ds->month;
+				d = ds->day;
+			}
+			break;
+		case SQL_C_TIME:
+		case SQL_C_TYPE_TIME:
+			{
+				const TIME_STRUCT *ts = (const TIME_STRUCT *) buffer;
+
+				/* the date part would be taken from the current time */
+				if (has_date)
+					return -1;
+				y = 2000;
+				m = d = 1;
+				hh = ts->hour;
+				mm = ts->minute;
+				ss = ts->second;
+			}
+			break;
+		case SQL_C_TIMESTAMP:
+		case SQL_C_TYPE_TIMESTAMP:
+			{
+				const TIMESTAMP_STRUCT *tss = (const TIMESTAMP_STRUCT *) buffer;
+
+				y = tss->year;
+				m = tss->month;
+				d = tss->day;
+				hh = tss->hour;
+				mm = tss->minute;
+				ss = tss->second;
+				fr = tss->fraction;
+			}
+			break;
+		default:
+			return -1;
+	}
+	if (!valid_ymd(y, m, d) || !valid_hms(hh, mm, ss) || fr >= 1000000000)
+		return -1;
+
+	if (!has_time)
+	{
+		put_int_be(binbuf, (SQLUBIGINT) (Int8) (date2j(y, m, d) - POSTGRES_EPOCH_JDATE), 4);
+		return 4;
+	}
+	else
+	{
+		Int8	usecs = ((Int8) (hh * 60 + mm) * 60 + ss) * 1000000;
+
+		if (has_date)
+		{
+			/* the text format is truncated to microseconds */
+			usecs += fr / 1000;
+			usecs += (Int8) (date2j(y, m, d) - POSTGRES_EPOCH_JDATE) * USECS_PER_DAY;
+		}
+		else
+		{
+			/* the server would round the fraction */
+			if (0 != fr % 1000)
+				return -1;
+			usecs += fr / 1000;
+		}
+		put_int_be(binbuf, (SQLUBIGINT) usecs, 8);
+		return 8;
+	}
+}
+
+/*
+ * Length of the client data of a bound parameter which can be compared
+ * with the previous execution, or -1 if the converted value mustn't be
+ * reused (e.g. it depends on the current time or creates a large object).
+ */
+static SQLLEN
+cacheable_param_length(const char *buffer, SQLLEN used, SQLSMALLINT ctype,
+					   SQLSMALLINT sqltype, OID pgtype)
+{
+	SQLLEN	ctypelen;
+
+	switch (sqltype)
+	{
+		case SQL_BINARY:
+		case SQL_VARBINARY:
+		case SQL_LONGVARBINARY:
+			if (PG_TYPE_BYTEA != pgtype)
+				return -1;
+			break;
+	}
+	switch (ctype)
+	{
+		case SQL_C_TIME:
+#if (ODBCVER >= 0x0300)
+		case SQL_C_TYPE_TIME:
+#endif /* ODBCVER */
+			return -1;	/* SQL_TIMESTAMP takes the current date */
+		case SQL_C_CHAR:
+			if (used >= 0)
+				return used;
+			if (SQL_NTS == used)
+				return strlen(buffer);
+			return -1;
+#ifdef	UNICODE_SUPPORT
+		case SQL_C_WCHAR:
+			if (used >= 0)
+				return used;
+			if (SQL_NTS == used)
+				return ucs2strlen((SQLWCHAR *) buffer) * WCLEN;
+			return -1;
+#endif /* UNICODE_SUPPORT */
+		case SQL_C_BINARY:
+			return used >= 0 ? used : -1;
+	}
+	if (ctypelen = ctype_length(ctype), ctypelen > 0)
+		return ctypelen;
+	return -1;
+}
+
 /*
  * Resolve one parameter.
  *
@@ -4495,6 +4976,8 @@ ResolveOneParam(QueryBuild *qb, QueryParse *qp, BOOL *isnull, BOOL *isbinary,
 	const char	*send_buf;
 
 	char		*buffer, *allocbuf = NULL, *lastadd = NULL;
+	ParamValueCache	*vcache = NULL;
+	SQLLEN		rawlen = -1;
 	OID			lobj_oid;
 	int			lobj_fd;
 	SQLULEN		offset = apdopts->param_offset_ptr ? *apdopts->param_offset_ptr : 0;
@@ -4750,6 +5233,63 @@ MYLOG(DETAIL_LOG_LEVEL, "ipara=%p paramName=%s paramType=%d %d proc_return=%d\n"
 #endif
 	}
 
+	/*
+	 * Reuse the value converted in the previous execution if the client
+	 * data hasn't changed since then.
+	 */
+	if (req_bind &&
+	    0 != (qb->flags & FLGB_CACHE_PARAM_VALUES) &&
+	    NULL != qb->stmt &&
+	    !apara->data_at_exec &&
+	    NULL != buffer &&
+	    (rawlen = cacheable_param_length(buffer, used, param_ctype, param_sqltype, param_pgtype)) >= 0 &&
+	    NULL != (vcache = EPARAMS_get_vcache(SC_get_EPRM(qb->stmt), param_number)))
+	{
+		if (vcache->valid &&
+		    vcache->bypgtype == (0 != (qb->flags & FLGB_BINARY_BY_PGTYPE)) &&
+		    vcache->ctype == param_ctype &&
+		    vcache->sqltype == param_sqltype &&
+		    vcache->pgtype == param_pgtype &&
+		    vcache->precision == apara->precision &&
+		    vcache->rawlen == rawlen &&
+		    memcmp(vcache->data, buffer, rawlen) == 0)
+		{
+			MYLOG(DETAIL_LOG_LEVEL, "reusing the converted value of param %d\n", param_number);
+			*isbinary = vcache->isbinary;
+			*pgType = vcache->sent_pgtype;
+			CVT_APPEND_DATA(qb, vcache->data + vcache->rawlen, vcache->encodedlen);
+			retval = SQL_SUCCESS;
+			goto cleanup;
+		}
+		vcache->valid = FALSE;
+	}
+
+	/*
+	 * Use the binary format if the server told us the type of the
+	 * parameter and the value can be converted to it directly.
+	 */
+	if (req_bind &&
+	    0 != (qb->flags & FLGB_BINARY_BY_PGTYPE) &&
+	    SQL_PARAM_INPUT == ipara->paramType &&
+	    0 != PIC_get_pgtype(*ipara) &&
+	    NULL != buffer &&
+	    !handling_large_object)
+	{
+		OID	bin_pgtype = PIC_get_pgtype(*ipara);
+		SQLLEN	binlen;
+
+		binlen = ResolveBinaryParam(conn, buffer, param_ctype, param_sqltype, bin_pgtype, cbuf, sizeof(cbuf));
+		if (binlen >= 0)
+		{
+			MYLOG(DETAIL_LOG_LEVEL, "sending param %d as binary pgtype=%u leng=" FORMAT_LEN "\n", param_number, bin_pgtype, binlen);
+			*isbinary = TRUE;
+			*pgType = bin_pgtype;
+			send_buf = cbuf;
+			used = binlen;
+			goto bind_value;
+		}
+	}
+
 	allocbuf = NULL;
 	send_buf = NULL;
 	param_string[0] = '\0';
@@ -5385,8 +5925,22 @@ MYLOG(0, "cvt_null_date_string=%d pgtype=%d send_buf=%p\n", conn->connInfo.cvt_n
 	 *
 	 * In bind-mode, we don't need to do any quoting.
 	 */
+bind_value:
 	if (req_bind)
+	{
 		CVT_APPEND_DATA(qb, send_buf, used);
+		if (vcache &&
+		    PVCACHE_save(vcache, buffer, rawlen, send_buf, used))
+		{
+			vcache->isbinary = *isbinary;
+			vcache->bypgtype = (0 != (qb->flags & FLGB_BINARY_BY_PGTYPE));
+			vcache->ctype = param_ctype;
+			vcache->sqltype = param_sqltype;
+			vcache->pgtype = param_pgtype;
+			vcache->sent_pgtype = *pgType;
+			vcache->precision = apara->precision;
+		}
+	}
 	else
 	{
 		if (add_parens)
@@ -6459,7 +7013,6 @@ convert_lo(StatementClass *stmt, const void *value, SQLSMALLINT fCType, PTR rgbV
 	Int8		left64 = -1;
 	struct GetBlobDataClass *gdata_blob = NULL;
 	ConnectionClass *conn = SC_get_conn(stmt);
-	ConnInfo   *ci = &(conn->connInfo);
 	GetDataInfo	*gdata_info = SC_get_GDTI(stmt);
 	int			factor;
 
@@ -6544,7 +7097,7 @@ convert_lo(StatementClass *stmt, const void *value, SQLSMALLINT fCType, PTR rgbV
 		odbc_lo_close(conn, stmt->lobj_fd);
 
 		/* commit transaction if needed */
-		if (!ci->drivers.use_declarefetch && CC_does_autocommit(conn))
+		if (!SC_is_fetchcursor(stmt) && CC_does_autocommit(conn))
 		{
 			if (!CC_commit(conn))
 			{
@@ -6580,7 +7133,7 @@ convert_lo(StatementClass *stmt, const void *value, SQLSMALLINT fCType, PTR rgbV
 		odbc_lo_close(conn, stmt->lobj_fd);
 
 		/* commit transaction if needed */
-		if (!ci->drivers.use_declarefetch && CC_does_autocommit(conn))
+		if (!SC_is_fetchcursor(stmt) && CC_does_autocommit(conn))
 		{
 			if (!CC_commit(conn))
 			{
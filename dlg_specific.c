@@ -18,8 +18,12 @@
 /* Multibyte support	Eiji Tokuya 2001-03-15 */
 
 #include <ctype.h>
+#ifndef	WIN32
+#include <sys/stat.h>
+#endif /* WIN32 */
 #include "dlg_specific.h"
 #include "misc.h"
+#include "environ.h"
 
 #include "pgapifunc.h"
 
@@ -293,6 +297,68 @@ makeXaOptConnectString(char *target, int buflen, const ConnInfo *ci, BOOL abbrev
 }
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
 
+static char *
+makeCacheParamConnectString(char *target, int buflen, const ConnInfo *ci, BOOL abbrev)
+{
+	char	*buf = target;
+	*buf = '\0';
+
+	if (DEFAULT_CACHEPARAMVALUES != ci->cache_param_values)
+	{
+		if (abbrev)
+			snprintf(buf, buflen, ABBR_CACHEPARAMVALUES "=%d;", ci->cache_param_values);
+		else
+			snprintf(buf, buflen, INI_CACHEPARAMVALUES "=%d;", ci->cache_param_values);
+	}
+	return target;
+}
+
+static char *
+makePoolConnectString(char *target, int buflen, const ConnInfo *ci, BOOL abbrev)
+{
+	char	*buf = target;
+	*buf = '\0';
+
+	if (DEFAULT_POOLSIZE != ci->pool_size)
+		snprintfcat(buf, buflen, "%s=%d;", abbrev ? ABBR_POOLSIZE : INI_POOLSIZE, ci->pool_size);
+	if (DEFAULT_POOLRESET != ci->pool_reset)
+		snprintfcat(buf, buflen, "%s=%d;", abbrev ? ABBR_POOLRESET : INI_POOLRESET, ci->pool_reset);
+	if (DEFAULT_POOLIDLETIMEOUT != ci->pool_idle_timeout)
+		snprintfcat(buf, buflen, "%s=%d;", abbrev ? ABBR_POOLIDLETIMEOUT : INI_POOLIDLETIMEOUT, ci->pool_idle_timeout);
+	if (DEFAULT_POOLLIFETIME != ci->pool_lifetime)
+		snprintfcat(buf, buflen, "%s=%d;", abbrev ? ABBR_POOLLIFETIME : INI_POOLLIFETIME, ci->pool_lifetime);
+	return target;
+}
+
+static char *
+makeScrollCacheConnectString(char *target, int buflen, const ConnInfo *ci, BOOL abbrev)
+{
+	char	*buf = target;
+	*buf = '\0';
+
+	if (DEFAULT_SCROLLCACHEWINDOWS != ci->scroll_cache_windows)
+		snprintfcat(buf, buflen, "%s=%d;", abbrev ? ABBR_SCROLLCACHEWINDOWS : INI_SCROLLCACHEWINDOWS, ci->scroll_cache_windows);
+	if (DEFAULT_SCROLLCACHESIZE != ci->scroll_cache_size)
+		snprintfcat(buf, buflen, "%s=%d;", abbrev ? ABBR_SCROLLCACHESIZE : INI_SCROLLCACHESIZE, ci->scroll_cache_size);
+	return target;
+}
+
+static char *
+makeServerStaticConnectString(char *target, int buflen, const ConnInfo *ci, BOOL abbrev)
+{
+	char	*buf = target;
+	*buf = '\0';
+
+	if (DEFAULT_SERVERSTATICCURSORS != ci->server_static_cursors)
+	{
+		if (abbrev)
+			snprintf(buf, buflen, ABBR_SERVERSTATICCURSORS "=%d;", ci->server_static_cursors);
+		else
+			snprintf(buf, buflen, INI_SERVERSTATICCURSORS "=%d;", ci->server_static_cursors);
+	}
+	return target;
+}
+
 void
 makeConnectString(char *connect_string, const ConnInfo *ci, UWORD len)
 {
@@ -301,6 +367,10 @@ makeConnectString(char *connect_string, const ConnInfo *ci, UWORD len)
 	char		*connsetStr = NULL;
 	char		*pqoptStr = NULL;
 	char		keepaliveStr[64];
+	char		cacheParamStr[32];
+	char		poolStr[96];
+	char		scrollCacheStr[64];
+	char		serverStaticStr[32];
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	char		xaOptStr[16];
 #endif
@@ -380,6 +450,10 @@ MYLOG(DETAIL_LOG_LEVEL, "hlen=" FORMAT_SSIZE_T "\n", hlen);
 			ABBR_NUMERIC_AS "=%d;"
 			INI_OPTIONAL_ERRORS "=%d;"
 			INI_FETCHREFCURSORS "=%d;"
+			"%s"		/* INI_CACHEPARAMVALUES */
+			"%s"		/* INI_POOL options */
+			"%s"		/* INI_SCROLLCACHE options */
+			"%s"		/* INI_SERVERSTATICCURSORS */
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 			INI_XAOPT "=%d"	/* XAOPT */
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
@@ -415,6 +489,10 @@ MYLOG(DETAIL_LOG_LEVEL, "hlen=" FORMAT_SSIZE_T "\n", hlen);
 			,ci->numeric_as
 			,ci->optional_errors
 			,ci->fetch_refcursors
+			,makeCacheParamConnectString(cacheParamStr, sizeof(cacheParamStr), ci, FALSE)
+			,makePoolConnectString(poolStr, sizeof(poolStr), ci, FALSE)
+			,makeScrollCacheConnectString(scrollCacheStr, sizeof(scrollCacheStr), ci, FALSE)
+			,makeServerStaticConnectString(serverStaticStr, sizeof(serverStaticStr), ci, FALSE)
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 			,ci->xa_opt
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
@@ -495,6 +573,10 @@ MYLOG(DETAIL_LOG_LEVEL, "hlen=" FORMAT_SSIZE_T "\n", hlen);
 				"%s"		/* ABBR_PQOPT */
 				"%s"		/* ABBRKEEPALIVE TIME/INTERVAL */
 				ABBR_NUMERIC_AS "=%d;"
+				"%s"		/* ABBR_CACHEPARAMVALUES */
+				"%s"		/* ABBR_POOL options */
+				"%s"		/* ABBR_SCROLLCACHE options */
+				"%s"		/* ABBR_SERVERSTATICCURSORS */
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 				"%s"
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
@@ -508,6 +590,10 @@ MYLOG(DETAIL_LOG_LEVEL, "hlen=" FORMAT_SSIZE_T "\n", hlen);
 				makeBracketConnectString(ci->pqopt_in_str, &pqoptStr, ci->pqopt, ABBR_PQOPT),
 				makeKeepaliveConnectString(keepaliveStr, sizeof(keepaliveStr), ci, TRUE),
 				ci->numeric_as,
+				makeCacheParamConnectString(cacheParamStr, sizeof(cacheParamStr), ci, TRUE),
+				makePoolConnectString(poolStr, sizeof(poolStr), ci, TRUE),
+				makeScrollCacheConnectString(scrollCacheStr, sizeof(scrollCacheStr), ci, TRUE),
+				makeServerStaticConnectString(serverStaticStr, sizeof(serverStaticStr), ci, TRUE),
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 				makeXaOptConnectString(xaOptStr, sizeof(xaOptStr), ci, TRUE),
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
@@ -816,6 +902,22 @@ copyConnAttributes(ConnInfo *ci, const char *attribute, const char *value)
 		STRCPY_FIXED(ci->drivers.extra_systable_prefixes, value);
 	else if (stricmp(attribute, INI_FETCHREFCURSORS) == 0 || stricmp(attribute, ABBR_FETCHREFCURSORS) == 0)
 		ci->fetch_refcursors = pg_atoi(value);
+	else if (stricmp(attribute, INI_CACHEPARAMVALUES) == 0 || stricmp(attribute, ABBR_CACHEPARAMVALUES) == 0)
+		ci->cache_param_values = pg_atoi(value);
+	else if (stricmp(attribute, INI_POOLSIZE) == 0 || stricmp(attribute, ABBR_POOLSIZE) == 0)
+		ci->pool_size = pg_atoi(value);
+	else if (stricmp(attribute, INI_POOLRESET) == 0 || stricmp(attribute, ABBR_POOLRESET) == 0)
+		ci->pool_reset = pg_atoi(value);
+	else if (stricmp(attribute, INI_POOLIDLETIMEOUT) == 0 || stricmp(attribute, ABBR_POOLIDLETIMEOUT) == 0)
+		ci->pool_idle_timeout = pg_atoi(value);
+	else if (stricmp(attribute, INI_POOLLIFETIME) == 0 || stricmp(attribute, ABBR_POOLLIFETIME) == 0)
+		ci->pool_lifetime = pg_atoi(value);
+	else if (stricmp(attribute, INI_SCROLLCACHEWINDOWS) == 0 || stricmp(attribute, ABBR_SCROLLCACHEWINDOWS) == 0)
+		ci->scroll_cache_windows = pg_atoi(value);
+	else if (stricmp(attribute, INI_SCROLLCACHESIZE) == 0 || stricmp(attribute, ABBR_SCROLLCACHESIZE) == 0)
+		ci->scroll_cache_size = pg_atoi(value);
+	else if (stricmp(attribute, INI_SERVERSTATICCURSORS) == 0 || stricmp(attribute, ABBR_SERVERSTATICCURSORS) == 0)
+		ci->server_static_cursors = pg_atoi(value);
 	else
 		found = FALSE;
 
@@ -866,6 +968,14 @@ getCiDefaults(ConnInfo *ci)
 	}
 	ci->disable_convert_func = 0;
 	ci->fetch_refcursors = DEFAULT_FETCHREFCURSORS;
+	ci->cache_param_values = DEFAULT_CACHEPARAMVALUES;
+	ci->pool_size = DEFAULT_POOLSIZE;
+	ci->pool_reset = DEFAULT_POOLRESET;
+	ci->pool_idle_timeout = DEFAULT_POOLIDLETIMEOUT;
+	ci->pool_lifetime = DEFAULT_POOLLIFETIME;
+	ci->scroll_cache_windows = DEFAULT_SCROLLCACHEWINDOWS;
+	ci->scroll_cache_size = DEFAULT_SCROLLCACHESIZE;
+	ci->server_static_cursors = DEFAULT_SERVERSTATICCURSORS;
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	ci->xa_opt = DEFAULT_XAOPT;
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
@@ -927,8 +1037,232 @@ getCiAllDefaults(ConnInfo *ci)
 	getCiDefaults(ci);
 }
 
+static void readDSNinfo(ConnInfo *ci, const char *configDrvrname);
+
+#ifndef	WIN32
+/*
+ *	Cache of the ConnInfo getDSNinfo() makes per DSN and driver name, so
+ *	that connecting doesn't have to read the ini files again. It's
+ *	discarded when any of the ini files which may be read changes.
+ */
+typedef struct DSNInfo_
+{
+	struct DSNInfo_ *next;
+	char		dsn[MEDIUM_REGISTRY_LEN];
+	char		drivername[MEDIUM_REGISTRY_LEN];
+	ConnInfo	ci;
+} DSNInfo;
+
+static DSNInfo	*dsninfo_cache = NULL;
+static char		*dsninfo_signature = NULL;
+
+/*
+ *	Names, modification times and sizes of the ini files the driver
+ *	managers (unixODBC or iODBC) may read.
+ *	Returns NULL when no odbc.ini is found, which means the driver
+ *	manager reads the files from where we don't know.
+ */
+static char *
+ini_files_signature(void)
+{
+	char		signature[4096], path[1024];
+	const char	*envs[] = {"ODBCINI", "ODBCINSTINI", "SYSODBCINI", "SYSODBCINSTINI"};
+	const char	*dirs[] = {"/etc", "/usr/local/etc", NULL};
+	const char	*files[] = {"odbc.ini", ODBCINST_INI};
+	const char	*val;
+	struct stat	st;
+	int			i, j;
+	BOOL		odbcini_found = FALSE;
+
+	signature[0] = '\0';
+	dirs[2] = getenv("ODBCSYSINI");
+	for (i = 0; i < sizeof(envs) / sizeof(envs[0]); i++)
+	{
+		if (val = getenv(envs[i]), NULL != val)
+			snprintfcat(signature, sizeof(signature), "%s;", val);
+	}
+	if (val = getenv("HOME"), NULL != val)
+	{
+		snprintfcat(signature, sizeof(signature), "%s/" ODBC_INI ";", val);
+		snprintfcat(signature, sizeof(signature), "%s/." ODBCINST_INI ";", val);
+#ifdef	__APPLE__
+		/* iODBC on macOS */
+		snprintfcat(signature, sizeof(signature), "%s/Library/ODBC/odbc.ini;", val);
+		snprintfcat(signature, sizeof(signature), "%s/Library/ODBC/" ODBCINST_INI ";", val);
+#endif /* __APPLE__ */
+	}
+	for (i = 0; i < sizeof(dirs) / sizeof(dirs[0]); i++)
+	{
+		if (NULL == dirs[i])
+			continue;
+		for (j = 0; j < sizeof(files) / sizeof(files[0]); j++)
+			snprintfcat(signature, sizeof(signature), "%s/%s;", dirs[i], files[j]);
+	}
+#ifdef	__APPLE__
+	snprintfcat(signature, sizeof(signature), "/Library/ODBC/odbc.ini;");
+	snprintfcat(signature, sizeof(signature), "/Library/ODBC/" ODBCINST_INI ";");
+#endif /* __APPLE__ */
+	/* the driver manager's own sysconfdir, see configure */
+#ifdef	ODBC_SYS_INI
+	snprintfcat(signature, sizeof(signature), ODBC_SYS_INI ";");
+#endif /* ODBC_SYS_INI */
+#ifdef	ODBC_SYS_INSTINI
+	snprintfcat(signature, sizeof(signature), ODBC_SYS_INSTINI ";");
+#endif /* ODBC_SYS_INSTINI */
+	if (strlen(signature) >= sizeof(signature) / 2)
+	{
+		MYLOG(0, "too long names of the ini files\n");
+		return NULL;
+	}
+
+	/* append the status of each file */
+	{
+		char	*ptr, *sep, names[sizeof(signature)];
+
+		STRCPY_FIXED(names, signature);
+		for (ptr = names; sep = strchr(ptr, ';'), NULL != sep; ptr = sep + 1)
+		{
+			*sep = '\0';
+			STRCPY_FIXED(path, ptr);
+			if (stat(path, &st) == 0)
+			{
+				snprintfcat(signature, sizeof(signature), "%ld,%ld;", (long) st.st_mtime, (long) st.st_size);
+				if (NULL == strstr(path, "odbcinst"))
+					odbcini_found = TRUE;
+			}
+			else
+				snprintfcat(signature, sizeof(signature), "-;");
+		}
+	}
+	if (!odbcini_found)
+	{
+		MYLOG(0, "no odbc.ini found, the DSN info isn't cached\n");
+		return NULL;
+	}
+
+	return strdup(signature);
+}
+
+static void
+copy_whole_conninfo(ConnInfo *to, const ConnInfo *from)
+{
+	*to = *from;
+	SET_NAME_DIRECTLY(to->password, NULL);
+	SET_NAME_DIRECTLY(to->conn_settings, NULL);
+	SET_NAME_DIRECTLY(to->pqopt, NULL);
+	SET_NAME_DIRECTLY(to->drivers.drivername, NULL);
+	NAME_TO_NAME(to->password, from->password);
+	NAME_TO_NAME(to->conn_settings, from->conn_settings);
+	NAME_TO_NAME(to->pqopt, from->pqopt);
+	NAME_TO_NAME(to->drivers.drivername, from->drivers.drivername);
+}
+
+static void
+free_dsninfo_cache(void)
+{
+	DSNInfo	*entry;
+
+	while (entry = dsninfo_cache, NULL != entry)
+	{
+		dsninfo_cache = entry->next;
+		CC_conninfo_release(&entry->ci);
+		free(entry);
+	}
+}
+
+/*
+ *	Find the cached ConnInfo for the DSN and driver name in ci.
+ *	signature is the current one of the ini files.
+ */
+static BOOL
+getCachedDSNinfo(ConnInfo *ci, const char *signature)
+{
+	DSNInfo	*entry;
+	BOOL	found = FALSE;
+
+	shortterm_common_lock();
+	if (NULL == dsninfo_signature ||
+		strcmp(dsninfo_signature, signature) != 0)
+	{
+		MYLOG(0, "the ini files were changed\n");
+		free_dsninfo_cache();
+		if (dsninfo_signature)
+			free(dsninfo_signature);
+		dsninfo_signature = strdup(signature);
+	}
+	for (entry = dsninfo_cache; entry; entry = entry->next)
+	{
+		if (strcmp(entry->dsn, ci->dsn) == 0 &&
+			strcmp(entry->drivername, ci->drivername) == 0)
+		{
+			CC_conninfo_release(ci);
+			copy_whole_conninfo(ci, &entry->ci);
+			found = TRUE;
+			break;
+		}
+	}
+	shortterm_common_unlock();
+
+	return found;
+}
+
+static void
+cacheDSNinfo(const char *dsn, const char *drivername, const ConnInfo *ci, const char *signature)
+{
+	DSNInfo	*entry;
+
+	if (entry = (DSNInfo *) malloc(sizeof(DSNInfo)), NULL == entry)
+		return;
+	STRCPY_FIXED(entry->dsn, dsn);
+	STRCPY_FIXED(entry->drivername, drivername);
+	copy_whole_conninfo(&entry->ci, ci);
+	shortterm_common_lock();
+	/* don't cache what may have been read from the changed files */
+	if (NULL != dsninfo_signature &&
+		strcmp(dsninfo_signature, signature) == 0)
+	{
+		entry->next = dsninfo_cache;
+		dsninfo_cache = entry;
+		entry = NULL;
+	}
+	shortterm_common_unlock();
+	if (entry)
+	{
+		CC_conninfo_release(&entry->ci);
+		free(entry);
+	}
+}
+#endif /* WIN32 */
+
 void
 getDSNinfo(ConnInfo *ci, const char *configDrvrname)
+{
+#ifndef	WIN32
+	char	dsn[MEDIUM_REGISTRY_LEN], drivername[MEDIUM_REGISTRY_LEN];
+	char	*signature;
+
+	/* ConfigDSN() always reads the ini files */
+	if (NULL == configDrvrname &&
+		NULL != (signature = ini_files_signature()))
+	{
+		if (!getCachedDSNinfo(ci, signature))
+		{
+			STRCPY_FIXED(dsn, ci->dsn);
+			STRCPY_FIXED(drivername, ci->drivername);
+			readDSNinfo(ci, NULL);
+			cacheDSNinfo(dsn, drivername, ci, signature);
+		}
+		else
+			MYLOG(0, "DSN=%s driver=%s from the cache\n", ci->dsn, ci->drivername);
+		free(signature);
+		return;
+	}
+#endif /* WIN32 */
+	readDSNinfo(ci, configDrvrname);
+}
+
+static void
+readDSNinfo(ConnInfo *ci, const char *configDrvrname)
 {
 	char	   *DSN = ci->dsn;
 	char	temp[LARGE_REGISTRY_LEN];
@@ -1109,6 +1443,26 @@ MYLOG(0, "drivername=%s\n", drivername);
 	if (SQLGetPrivateProfileString(DSN, INI_FETCHREFCURSORS, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
 		ci->fetch_refcursors = pg_atoi(temp);
 
+	if (SQLGetPrivateProfileString(DSN, INI_CACHEPARAMVALUES, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->cache_param_values = pg_atoi(temp);
+
+	if (SQLGetPrivateProfileString(DSN, INI_POOLSIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->pool_size = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_POOLRESET, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->pool_reset = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_POOLIDLETIMEOUT, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->pool_idle_timeout = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_POOLLIFETIME, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->pool_lifetime = pg_atoi(temp);
+
+	if (SQLGetPrivateProfileString(DSN, INI_SCROLLCACHEWINDOWS, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->scroll_cache_windows = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_SCROLLCACHESIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->scroll_cache_size = pg_atoi(temp);
+
+	if (SQLGetPrivateProfileString(DSN, INI_SERVERSTATICCURSORS, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->server_static_cursors = pg_atoi(temp);
+
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	if (SQLGetPrivateProfileString(DSN, INI_XAOPT, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
 		ci->xa_opt = pg_atoi(temp);
@@ -1407,6 +1761,46 @@ writeDSNinfo(const ConnInfo *ci)
 								 INI_FETCHREFCURSORS,
 								 temp,
 								 ODBC_INI);
+	ITOA_FIXED(temp, ci->cache_param_values);
+	SQLWritePrivateProfileString(DSN,
+								 INI_CACHEPARAMVALUES,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->pool_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_POOLSIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->pool_reset);
+	SQLWritePrivateProfileString(DSN,
+								 INI_POOLRESET,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->pool_idle_timeout);
+	SQLWritePrivateProfileString(DSN,
+								 INI_POOLIDLETIMEOUT,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->pool_lifetime);
+	SQLWritePrivateProfileString(DSN,
+								 INI_POOLLIFETIME,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->scroll_cache_windows);
+	SQLWritePrivateProfileString(DSN,
+								 INI_SCROLLCACHEWINDOWS,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->scroll_cache_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_SCROLLCACHESIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->server_static_cursors);
+	SQLWritePrivateProfileString(DSN,
+								 INI_SERVERSTATICCURSORS,
+								 temp,
+								 ODBC_INI);
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	ITOA_FIXED(temp, ci->xa_opt);
 	SQLWritePrivateProfileString(DSN, INI_XAOPT, temp, ODBC_INI);
@@ -1823,6 +2217,14 @@ CC_conninfo_init(ConnInfo *conninfo, UInt4 option)
 	conninfo->ignore_timeout = DEFAULT_IGNORETIMEOUT;
 	conninfo->wcs_debug = -1;
 	conninfo->fetch_refcursors = -1;
+	conninfo->cache_param_values = DEFAULT_CACHEPARAMVALUES;
+	conninfo->pool_size = DEFAULT_POOLSIZE;
+	conninfo->pool_reset = DEFAULT_POOLRESET;
+	conninfo->pool_idle_timeout = DEFAULT_POOLIDLETIMEOUT;
+	conninfo->pool_lifetime = DEFAULT_POOLLIFETIME;
+	conninfo->scroll_cache_windows = DEFAULT_SCROLLCACHEWINDOWS;
+	conninfo->scroll_cache_size = DEFAULT_SCROLLCACHESIZE;
+	conninfo->server_static_cursors = DEFAULT_SERVERSTATICCURSORS;
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	conninfo->xa_opt = -1;
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
@@ -1925,6 +2327,14 @@ CC_copy_conninfo(ConnInfo *ci, const ConnInfo *sci)
 	CORR_VALCPY(batch_size);
 	CORR_VALCPY(ignore_timeout);
 	CORR_VALCPY(fetch_refcursors);
+	CORR_VALCPY(cache_param_values);
+	CORR_VALCPY(pool_size);
+	CORR_VALCPY(pool_reset);
+	CORR_VALCPY(pool_idle_timeout);
+	CORR_VALCPY(pool_lifetime);
+	CORR_VALCPY(scroll_cache_windows);
+	CORR_VALCPY(scroll_cache_size);
+	CORR_VALCPY(server_static_cursors);
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	CORR_VALCPY(xa_opt);
 #endif
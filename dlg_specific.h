@@ -175,6 +175,22 @@ extern "C" {
 #define INI_DTCLOG			"Dtclog"
 #define INI_FETCHREFCURSORS		"FetchRefcursors"
 #define ABBR_FETCHREFCURSORS		"DA"
+#define INI_CACHEPARAMVALUES		"CacheParamValues"
+#define ABBR_CACHEPARAMVALUES		"DB"
+#define INI_POOLSIZE			"PoolSize"
+#define ABBR_POOLSIZE			"DC"
+#define INI_POOLRESET			"PoolReset"
+#define ABBR_POOLRESET			"DD"
+#define INI_POOLIDLETIMEOUT		"PoolIdleTimeout"
+#define ABBR_POOLIDLETIMEOUT		"DE"
+#define INI_POOLLIFETIME		"PoolLifetime"
+#define ABBR_POOLLIFETIME		"DF"
+#define INI_SCROLLCACHEWINDOWS		"ScrollCacheWindows"
+#define ABBR_SCROLLCACHEWINDOWS		"DG"
+#define INI_SCROLLCACHESIZE		"ScrollCacheSize"
+#define ABBR_SCROLLCACHESIZE		"DH"
+#define INI_SERVERSTATICCURSORS		"ServerStaticCursors"
+#define ABBR_SERVERSTATICCURSORS	"DI"
 /* "PreferLibpq", abbreviated "D4", used to mean whether to prefer libpq.
  * libpq is now required
 #define INI_PREFERLIBPQ			"PreferLibpq"
@@ -278,6 +294,14 @@ extern "C" {
 #define DEFAULT_BATCH_SIZE		100
 #define DEFAULT_IGNORETIMEOUT		0
 #define DEFAULT_FETCHREFCURSORS		0
+#define DEFAULT_CACHEPARAMVALUES	0
+#define DEFAULT_POOLSIZE		0
+#define DEFAULT_POOLRESET		0
+#define DEFAULT_POOLIDLETIMEOUT		300
+#define DEFAULT_POOLLIFETIME		0
+#define DEFAULT_SCROLLCACHEWINDOWS	0
+#define DEFAULT_SCROLLCACHESIZE		4096
+#define DEFAULT_SERVERSTATICCURSORS	0
 
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 #define DEFAULT_XAOPT			1
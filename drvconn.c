@@ -124,6 +124,14 @@ PGAPI_DriverConnect(HDBC hdbc,
 		return SQL_INVALID_HANDLE;
 	}
 
+	/* called again to complete an asynchronous connect */
+	if (CC_is_async_connecting(conn))
+	{
+		ci = &(conn->connInfo);
+		pg_memset(salt, 0, sizeof(salt));
+		goto connect;
+	}
+
 	connStrIn = make_string(szConnStrIn, cbConnStrIn, NULL, 0);
 
 #ifdef	FORCE_PASSWORD_DISPLAY
@@ -229,8 +237,11 @@ MYLOG(DETAIL_LOG_LEVEL, "DriverCompletion=%d\n", fDriverCompletion);
 	reqs = 0;
 
 MYLOG(DETAIL_LOG_LEVEL, "before CC_connect\n");
+connect:
 	/* do the actual connect */
 	retval = CC_connect(conn, salt);
+	if (CONNECT_IN_PROGRESS == retval)
+		return SQL_STILL_EXECUTING;
 	if (retval < 0)
 	{							/* need a password */
 		if (fDriverCompletion == SQL_DRIVER_NOPROMPT)
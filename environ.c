@@ -29,16 +29,10 @@
 #include "loadlib.h"
 
 
-/* The one instance of the handles */
-static int conns_count = 0;
-static ConnectionClass **conns = NULL;
-
 #if defined(WIN_MULTITHREAD_SUPPORT)
-CRITICAL_SECTION	conns_cs;
 CRITICAL_SECTION	common_cs; /* commonly used for short term blocking */
 CRITICAL_SECTION	common_lcs; /* commonly used for not necessarily short term blocking */
 #elif defined(POSIX_MULTITHREAD_SUPPORT)
-pthread_mutex_t     conns_cs;
 pthread_mutex_t     common_cs;
 pthread_mutex_t     common_lcs;
 #endif /* WIN_MULTITHREAD_SUPPORT */
@@ -52,14 +46,6 @@ void	shortterm_common_unlock(void)
 	LEAVE_COMMON_CS;
 }
 
-int	getConnCount(void)
-{
-	return conns_count;
-}
-ConnectionClass * const *getConnList(void)
-{
-	return conns;
-}
 
 RETCODE		SQL_API
 PGAPI_AllocEnv(HENV * phenv)
@@ -372,6 +358,9 @@ PGAPI_ConnectError(HDBC hdbc,
 			case CONN_ILLEGAL_TRANSACT_STATE:
 				pg_sqlstate_set(env, szSqlState, "25000", "S1010");
 				break;
+			case CONN_STILL_EXECUTING:
+				pg_sqlstate_set(env, szSqlState, "HY010", "S1010");
+				break;
 			case CONN_VALUE_OUT_OF_RANGE:
 				pg_sqlstate_set(env, szSqlState, "HY019", "22003");
 				break;
@@ -500,7 +489,10 @@ EN_Constructor(void)
 	rv->errormsg = 0;
 	rv->errornumber = 0;
 	rv->flag = 0;
+	rv->conns = NULL;
+	rv->pool = NULL;
 	INIT_ENV_CS(rv);
+	INIT_CONNS_CS(rv);
 cleanup:
 #ifdef WIN32
 	if (NULL == rv)
@@ -516,7 +508,7 @@ cleanup:
 char
 EN_Destructor(EnvironmentClass *self)
 {
-	int		lf, nullcnt;
+	ConnectionClass	*conn, *next;
 	char		rv = 1;
 
 	MYLOG(0, "entering self=%p\n", self);
@@ -529,28 +521,21 @@ EN_Destructor(EnvironmentClass *self)
 	 */
 
 	/* Free any connections belonging to this environment */
-	ENTER_CONNS_CS;
-	for (lf = 0, nullcnt = 0; lf < conns_count; lf++)
+	ENTER_CONNS_CS(self);
+	conn = self->conns;
+	self->conns = NULL;
+	LEAVE_CONNS_CS(self);
+	for (; conn; conn = next)
 	{
-		if (NULL == conns[lf])
-			nullcnt++;
-		else if (conns[lf]->henv == self)
-		{
-			if (CC_Destructor(conns[lf]))
-				conns[lf] = NULL;
-			else
-				rv = 0;
-			nullcnt++;
-		}
-	}
-	if (conns && nullcnt >= conns_count)
-	{
-		MYLOG(0, "clearing conns count=%d\n", conns_count);
-		free(conns);
-		conns = NULL;
-		conns_count = 0;
+		next = conn->next_in_env;
+		conn->prev_in_env = conn->next_in_env = NULL;
+		conn->henv = NULL;
+		if (!CC_Destructor(conn))
+			rv = 0;
 	}
-	LEAVE_CONNS_CS;
+	/* Close the pooled connections */
+	EN_pool_conn(self, NULL, NULL, NULL, 0, 0, 0, 0);
+	DELETE_CONNS_CS(self);
 	DELETE_ENV_CS(self);
 	free(self);
 
@@ -580,64 +565,78 @@ EN_get_error(EnvironmentClass *self, int *number, char **message)
 		return 0;
 }
 
-#define	INIT_CONN_COUNT	128
-
+/*
+ *	The connections are linked in the list of their environment, so that
+ *	adding and removing one take constant time.  The list has a lock of
+ *	its own because the callers of SQLAllocHandle(SQL_HANDLE_DBC) and
+ *	SQLEndTran(SQL_HANDLE_ENV) already hold the environment's one.
+ */
 char
 EN_add_connection(EnvironmentClass *self, ConnectionClass *conn)
 {
-	int	i, alloc;
-	ConnectionClass	**newa;
-	char	ret = FALSE;
-
 	MYLOG(0, "entering self = %p, conn = %p\n", self, conn);
 
-	ENTER_CONNS_CS;
-	for (i = 0; i < conns_count; i++)
-	{
-		if (!conns[i])
-		{
-			conn->henv = self;
-			conns[i] = conn;
-			ret = TRUE;
-			MYLOG(0, "       added at i=%d, conn->henv = %p, conns[i]->henv = %p\n", i, conn->henv, conns[i]->henv);
-			goto cleanup;
-		}
-	}
-	if (conns_count > 0)
-		alloc = 2 * conns_count;
-	else
-		alloc = INIT_CONN_COUNT;
-	if (newa = (ConnectionClass **) realloc(conns, alloc * sizeof(ConnectionClass *)), NULL == newa)
-		goto cleanup;
+	ENTER_CONNS_CS(self);
 	conn->henv = self;
-	newa[conns_count] = conn;
-	conns = newa;
-	ret = TRUE;
-	MYLOG(0, "       added at %d, conn->henv = %p, conns[%d]->henv = %p\n", conns_count, conn->henv, conns_count, conns[conns_count]->henv);
-	for (i = conns_count + 1; i < alloc; i++)
-		conns[i] = NULL;
-	conns_count = alloc;
-cleanup:
-	LEAVE_CONNS_CS;
-	return ret;
+	conn->prev_in_env = NULL;
+	conn->next_in_env = self->conns;
+	if (self->conns)
+		self->conns->prev_in_env = conn;
+	self->conns = conn;
+	LEAVE_CONNS_CS(self);
+
+	return TRUE;
 }
 
 
 char
 EN_remove_connection(EnvironmentClass *self, ConnectionClass *conn)
 {
-	int			i;
+	char	ret = FALSE;
 
-	for (i = 0; i < conns_count; i++)
-		if (conns[i] == conn && conns[i]->status != CONN_EXECUTING)
-		{
-			ENTER_CONNS_CS;
-			conns[i] = NULL;
-			LEAVE_CONNS_CS;
-			return TRUE;
-		}
+	ENTER_CONNS_CS(self);
+	if (conn->henv == self && conn->status != CONN_EXECUTING &&
+		(self->conns == conn || NULL != conn->prev_in_env))
+	{
+		if (conn->prev_in_env)
+			conn->prev_in_env->next_in_env = conn->next_in_env;
+		else
+			self->conns = conn->next_in_env;
+		if (conn->next_in_env)
+			conn->next_in_env->prev_in_env = conn->prev_in_env;
+		conn->prev_in_env = conn->next_in_env = NULL;
+		ret = TRUE;
+	}
+	LEAVE_CONNS_CS(self);
+
+	return ret;
+}
+
+
+/*
+ *	Return a copy of the list of the connections of the environment,
+ *	which the caller may walk without holding any lock. The caller frees
+ *	it.
+ */
+ConnectionClass **
+EN_get_connections(EnvironmentClass *self, int *count)
+{
+	ConnectionClass	**list = NULL, *conn;
+	int	cnt = 0, i;
+
+	ENTER_CONNS_CS(self);
+	for (conn = self->conns; conn; conn = conn->next_in_env)
+		cnt++;
+	if (cnt > 0 &&
+		NULL != (list = (ConnectionClass **) malloc(sizeof(ConnectionClass *) * cnt)))
+	{
+		for (conn = self->conns, i = 0; conn; conn = conn->next_in_env)
+			list[i++] = conn;
+	}
+	LEAVE_CONNS_CS(self);
+	*count = (NULL != list ? cnt : 0);
 
-	return FALSE;
+	return list;
 }
 
 
@@ -649,3 +648,153 @@ EN_log_error(const char *func, char *desc, EnvironmentClass *self)
 	else
 		MYLOG(0, "INVALID ENVIRON HANDLE ERROR: func=%s, desc='%s'\n", func, desc);
 }
+
+
+/*
+ *	Connection pool
+ *
+ *	Connections released by CC_cleanup() are kept in the environment
+ *	they belong to, keyed by the normalized connection parameters, and
+ *	handed out again by EN_get_pooled_conn() instead of connecting anew.
+ */
+static void
+free_pooled_conns(PooledConn *list)
+{
+	PooledConn	*entry;
+
+	while (entry = list, NULL != entry)
+	{
+		list = entry->next;
+		QLOG(0, "PQfinish: %p\n", entry->pqconn);
+		PQfinish(entry->pqconn);
+		free(entry->key);
+		free(entry->pwhash);
+		free(entry);
+	}
+}
+
+/*
+ *	Unlink the expired entries (all of them if all is TRUE) from the
+ *	pool and return them as a list. Must be called in the environment's
+ *	critical section.
+ */
+static PooledConn *
+remove_expired_conns(EnvironmentClass *self, BOOL all)
+{
+	PooledConn	**pentry, *entry, *expired = NULL;
+	time_t		now = time(NULL);
+
+	for (pentry = &self->pool; entry = *pentry, NULL != entry;)
+	{
+		if (all || (0 != entry->expires && entry->expires <= now))
+		{
+			*pentry = entry->next;
+			entry->next = expired;
+			expired = entry;
+		}
+		else
+			pentry = &entry->next;
+	}
+
+	return expired;
+}
+
+/*
+ *	The password isn't part of the key, so that it doesn't go into
+ *	the pool in plain text. Its digest is compared instead.
+ */
+static BOOL
+pooled_conn_matches(const PooledConn *entry, const char *key, const char *pwhash)
+{
+	return strcmp(entry->key, key) == 0 &&
+		   strcmp(entry->pwhash, pwhash) == 0;
+}
+
+/*
+ *	Take an idle connection for key out of the pool. The caller checks
+ *	that it's still usable.
+ */
+void *
+EN_get_pooled_conn(EnvironmentClass *self, const char *key, const char *pwhash, time_t *created)
+{
+	PooledConn	**pentry, *entry, *expired;
+	void		*pqconn = NULL;
+
+	ENTER_ENV_CS(self);
+	expired = remove_expired_conns(self, FALSE);
+	for (pentry = &self->pool; entry = *pentry, NULL != entry; pentry = &entry->next)
+	{
+		if (pooled_conn_matches(entry, key, pwhash))
+		{
+			*pentry = entry->next;
+			pqconn = entry->pqconn;
+			*created = entry->created;
+			free(entry->key);
+			free(entry->pwhash);
+			free(entry);
+			break;
+		}
+	}
+	LEAVE_ENV_CS(self);
+	free_pooled_conns(expired);
+	MYLOG(0, "pooled connection=%p\n", pqconn);
+
+	return pqconn;
+}
+
+/*
+ *	Put a connection which was reset by the caller into the pool, unless
+ *	max_idle connections for key are already there or the connection is
+ *	older than lifetime seconds.
+ *
+ *	Returns TRUE if the pool took the connection, otherwise the caller
+ *	closes it. Passing NULL for key empties the pool.
+ */
+BOOL
+EN_pool_conn(EnvironmentClass *self, const char *key, const char *pwhash, void *pqconn, time_t created, int max_idle, int idle_timeout, int lifetime)
+{
+	PooledConn	*entry, *expired;
+	time_t		now = time(NULL);
+	int			count = 0;
+	BOOL		pooled = FALSE;
+
+	ENTER_ENV_CS(self);
+	expired = remove_expired_conns(self, NULL == key);
+	if (NULL == key)
+		goto cleanup;
+	if (lifetime > 0 && created + lifetime <= now)
+		goto cleanup;
+	for (entry = self->pool; entry; entry = entry->next)
+	{
+		if (pooled_conn_matches(entry, key, pwhash))
+			count++;
+	}
+	if (count >= max_idle)
+		goto cleanup;
+	if (entry = (PooledConn *) malloc(sizeof(PooledConn)), NULL == entry)
+		goto cleanup;
+	entry->key = strdup(key);
+	entry->pwhash = strdup(pwhash);
+	if (NULL == entry->key || NULL == entry->pwhash)
+	{
+		free(entry->key);
+		free(entry->pwhash);
+		free(entry);
+		goto cleanup;
+	}
+	entry->pqconn = pqconn;
+	entry->created = created;
+	entry->expires = (idle_timeout > 0 ? now + idle_timeout : 0);
+	if (lifetime > 0 &&
+	    (0 == entry->expires || created + lifetime < entry->expires))
+		entry->expires = created + lifetime;
+	entry->next = self->pool;
+	self->pool = entry;
+	pooled = TRUE;
+cleanup:
+	LEAVE_ENV_CS(self);
+	free_pooled_conns(expired);
+	MYLOG(0, "connection=%p pooled=%d\n", pqconn, pooled);
+
+	return pooled;
+}
@@ -14,6 +14,7 @@ extern "C" {
 #endif
 
 #include "psqlodbc.h"
+#include <time.h>
 
 #if defined (POSIX_MULTITHREAD_SUPPORT)
 #include <pthread.h>
@@ -21,16 +22,31 @@ extern "C" {
 
 #define ENV_ALLOC_ERROR 1
 
+/*	An idle libpq connection kept for reuse (see EN_pool_conn) */
+typedef struct PooledConn_
+{
+	struct PooledConn_ *next;
+	char	   *key;		/* the normalized connection parameters */
+	char	   *pwhash;		/* the digest of the password */
+	void	   *pqconn;
+	time_t		created;	/* when the connection was established */
+	time_t		expires;	/* idle timeout or end of lifetime, 0 if none */
+} PooledConn;
+
 /**********		Environment Handle	*************/
 struct EnvironmentClass_
 {
 	char	   *errormsg;
 	int		errornumber;
 	Int4	flag;
+	ConnectionClass	*conns;	/* the connections allocated on this */
+	PooledConn	*pool;
 #if defined(WIN_MULTITHREAD_SUPPORT)
 	CRITICAL_SECTION	cs;
+	CRITICAL_SECTION	conns_cs;	/* protects conns only */
 #elif defined(POSIX_MULTITHREAD_SUPPORT)
 	pthread_mutex_t		cs;
+	pthread_mutex_t		conns_cs;	/* protects conns only */
 #endif /* WIN_MULTITHREAD_SUPPORT */
 };
 
@@ -41,8 +57,9 @@ char		EN_get_error(EnvironmentClass *self, int *number, char **message);
 char		EN_add_connection(EnvironmentClass *self, ConnectionClass *conn);
 char		EN_remove_connection(EnvironmentClass *self, ConnectionClass *conn);
 void		EN_log_error(const char *func, char *desc, EnvironmentClass *self);
-int	getConnCount(void);
-ConnectionClass * const *getConnList(void);
+void		*EN_get_pooled_conn(EnvironmentClass *self, const char *key, const char *pwhash, time_t *created);
+BOOL		EN_pool_conn(EnvironmentClass *self, const char *key, const char *pwhash, void *pqconn, time_t created, int max_idle, int idle_timeout, int lifetime);
+ConnectionClass	**EN_get_connections(EnvironmentClass *self, int *count);
 
 #define	EN_OV_ODBC2	1L
 #define	EN_CONN_POOLING	(1L<<1)
@@ -56,40 +73,40 @@ ConnectionClass * const *getConnList(void);
 
 /* For Multi-thread */
 #if defined( WIN_MULTITHREAD_SUPPORT)
-#define	INIT_CONNS_CS	InitializeCriticalSection(&conns_cs)
-#define	ENTER_CONNS_CS	EnterCriticalSection(&conns_cs)
-#define	LEAVE_CONNS_CS	LeaveCriticalSection(&conns_cs)
-#define	DELETE_CONNS_CS	DeleteCriticalSection(&conns_cs)
 #define INIT_ENV_CS(x)		InitializeCriticalSection(&((x)->cs))
 #define ENTER_ENV_CS(x)	EnterCriticalSection(&((x)->cs))
 #define LEAVE_ENV_CS(x)		LeaveCriticalSection(&((x)->cs))
 #define DELETE_ENV_CS(x)	DeleteCriticalSection(&((x)->cs))
+#define INIT_CONNS_CS(x)	InitializeCriticalSection(&((x)->conns_cs))
+#define ENTER_CONNS_CS(x)	EnterCriticalSection(&((x)->conns_cs))
+#define LEAVE_CONNS_CS(x)	LeaveCriticalSection(&((x)->conns_cs))
+#define DELETE_CONNS_CS(x)	DeleteCriticalSection(&((x)->conns_cs))
 #define INIT_COMMON_CS		InitializeCriticalSection(&common_cs)
 #define ENTER_COMMON_CS		EnterCriticalSection(&common_cs)
 #define LEAVE_COMMON_CS		LeaveCriticalSection(&common_cs)
 #define DELETE_COMMON_CS	DeleteCriticalSection(&common_cs)
 #elif defined(POSIX_MULTITHREAD_SUPPORT)
-#define	INIT_CONNS_CS	pthread_mutex_init(&conns_cs,0)
-#define	ENTER_CONNS_CS	pthread_mutex_lock(&conns_cs)
-#define	LEAVE_CONNS_CS	pthread_mutex_unlock(&conns_cs)
-#define	DELETE_CONNS_CS	pthread_mutex_destroy(&conns_cs)
 #define INIT_ENV_CS(x)		pthread_mutex_init(&((x)->cs),0)
 #define ENTER_ENV_CS(x)		pthread_mutex_lock(&((x)->cs))
 #define LEAVE_ENV_CS(x)		pthread_mutex_unlock(&((x)->cs))
 #define DELETE_ENV_CS(x)	pthread_mutex_destroy(&((x)->cs))
+#define INIT_CONNS_CS(x)	pthread_mutex_init(&((x)->conns_cs),0)
+#define ENTER_CONNS_CS(x)	pthread_mutex_lock(&((x)->conns_cs))
+#define LEAVE_CONNS_CS(x)	pthread_mutex_unlock(&((x)->conns_cs))
+#define DELETE_CONNS_CS(x)	pthread_mutex_destroy(&((x)->conns_cs))
 #define INIT_COMMON_CS		pthread_mutex_init(&common_cs,0)
 #define ENTER_COMMON_CS		pthread_mutex_lock(&common_cs)
 #define LEAVE_COMMON_CS		pthread_mutex_unlock(&common_cs)
 #define DELETE_COMMON_CS	pthread_mutex_destroy(&common_cs)
 #else
-#define	INIT_CONNS_CS
-#define	ENTER_CONNS_CS
-#define	LEAVE_CONNS_CS
-#define	DELETE_CONNS_CS
 #define INIT_ENV_CS(x)
 #define ENTER_ENV_CS(x)
 #define LEAVE_ENV_CS(x)
 #define DELETE_ENV_CS(x)
+#define INIT_CONNS_CS(x)
+#define ENTER_CONNS_CS(x)
+#define LEAVE_CONNS_CS(x)
+#define DELETE_CONNS_CS(x)
 #define INIT_COMMON_CS
 #define ENTER_COMMON_CS
 #define LEAVE_COMMON_CS
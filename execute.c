@@ -163,6 +163,10 @@ PGAPI_ExecDirect(HSTMT hstmt,
 
 	MYLOG(0, "entering...%x\n", flag);
 
+	/* called again to complete an asynchronous execution */
+	if (SC_is_async_pending(stmt))
+		return PGAPI_Execute(hstmt, flag);
+
 	if (result = SC_initialize_and_recycle(stmt), SQL_SUCCESS != result)
 		return result;
 
@@ -247,7 +251,12 @@ inquireHowToPrepare(const StatementClass *stmt)
 		{
 			if (SC_may_use_cursor(stmt))
 			{
-				if (ci->drivers.use_declarefetch)
+				/*
+				 * SQL_ATTR_MAX_ROWS alone doesn't give up server side
+				 * prepare, the limit is then applied by the driver.
+				 */
+				if (ci->drivers.use_declarefetch ||
+				    SC_is_server_static(stmt, ci))
 					return PARSE_REQ_FOR_INFO;
 				else if (SQL_CURSOR_FORWARD_ONLY != stmt->options.cursor_type)
 					ret = PARSE_REQ_FOR_INFO;
@@ -482,7 +491,9 @@ RETCODE	Exec_with_parameters_resolved(StatementClass *stmt, EXEC_TYPE exec_type,
 MYLOG(DETAIL_LOG_LEVEL, "prepare_before_exec=%d srv=%d\n", prepare_before_exec, stmt->use_server_side_prepare);
 	/* Create the statement with parameters substituted. */
 	stmt_with_params = stmt->stmt_with_params;
-	if (LAST_EXEC == exec_type)
+	if (SC_is_async_pending(stmt))
+		;	/* the statement has been sent already */
+	else if (LAST_EXEC == exec_type)
 	{
 		if (NULL != stmt_with_params)
 		{
@@ -541,6 +552,8 @@ MYLOG(0, "about to begin SC_execute exec_type=%d\n", exec_type);
 	if (DIRECT_EXEC == exec_type)
 	{
 		retval = SC_execute(stmt);
+		if (SQL_STILL_EXECUTING == retval)
+			RETURN(retval)
 		stmt->count_of_deffered = 0;
 	}
 	else if (DEFFERED_EXEC == exec_type &&
@@ -859,6 +872,7 @@ CC_is_in_trans(conn), SC_is_rb_stmt(stmt), SC_is_tc_stmt(stmt));
 	switch (ret)
 	{
 		case SQL_NEED_DATA:
+		case SQL_STILL_EXECUTING:
 			break;
 		case SQL_ERROR:
 			start_stmt = TRUE;
@@ -997,9 +1011,16 @@ PGAPI_Execute(HSTMT hstmt, UWORD flag)
 
 	MYLOG(0, "entering...%x %p status=%d\n", flag, stmt, stmt->status);
 
-	stmt->has_notice = 0;
 	conn = SC_get_conn(stmt);
 	apdopts = SC_get_APDF(stmt);
+	if (SC_is_async_pending(stmt))
+	{
+		/* called again to complete an asynchronous execution */
+		SC_clear_error(stmt);
+		retval = Exec_with_parameters_resolved(stmt, stmt->exec_type, &exec_end);
+		goto cleanup;
+	}
+	stmt->has_notice = 0;
 
 	/*
 	 * If the statement was previously described, just recycle the old result
@@ -1240,7 +1261,17 @@ next_param_row:
 
 	if (0 != (flag & PODBC_WITH_HOLD))
 		SC_set_with_hold(stmt);
+	/*
+	 * Only the execution of a single set of parameters requested by
+	 * the application can be asynchronous.
+	 */
+	stmt->async.allowed = (stmt->external &&
+			SQL_ASYNC_ENABLE_ON == stmt->options.async_enable &&
+			start_row == end_row);
 	retval = Exec_with_parameters_resolved(stmt, stmt->exec_type, &exec_end);
+	stmt->async.allowed = FALSE;
+	if (SQL_STILL_EXECUTING == retval)
+		goto cleanup;
 	if (!exec_end)
 	{
 		goto next_param_row;
@@ -1280,21 +1311,29 @@ PGAPI_Transact(HENV henv,
 	 */
 	if (hdbc == SQL_NULL_HDBC && henv != SQL_NULL_HENV)
 	{
-		ConnectionClass * const *conns = getConnList();
-		const int	conn_count = getConnCount();
+		int	conn_count;
+		ConnectionClass	**conns = EN_get_connections((EnvironmentClass *) henv, &conn_count);
+		RETCODE	ret = SQL_SUCCESS;
+
 		for (lf = 0; lf < conn_count; lf++)
 		{
 			conn = conns[lf];
 
-			if (conn && CC_get_env(conn) == henv)
-				if (PGAPI_Transact(henv, (HDBC) conn, fType) != SQL_SUCCESS)
-					return SQL_ERROR;
+			if (PGAPI_Transact(henv, (HDBC) conn, fType) != SQL_SUCCESS)
+			{
+				ret = SQL_ERROR;
+				break;
+			}
 		}
-		return SQL_SUCCESS;
+		if (conns)
+			free(conns);
+		return ret;
 	}
 
 	conn = (ConnectionClass *) hdbc;
 
+	if (CC_async_busy(conn, func))
+		return SQL_ERROR;
 	if (fType != SQL_COMMIT &&
 	    fType != SQL_ROLLBACK)
 	{
@@ -1302,6 +1341,20 @@ PGAPI_Transact(HENV henv,
 		return SQL_ERROR;
 	}
 
+	/* called again to complete an asynchronous COMMIT or ROLLBACK */
+	if (CONN_ASYNC_ENDTRAN == conn->async.op ||
+		(conn->async.enabled &&
+		 CC_loves_visible_trans(conn) && CC_is_in_trans(conn)))
+	{
+		RETCODE	ret = CC_async_end_trans(conn, SQL_COMMIT == fType);
+
+		if (SQL_ERROR == ret)
+		{
+			CC_on_abort(conn, NO_TRANS);
+			CC_log_error(func, "", conn);
+		}
+		return ret;
+	}
 	/* If manual commit and in transaction, then proceed. */
 	if (CC_loves_visible_trans(conn) && CC_is_in_trans(conn))
 	{
@@ -1350,8 +1403,9 @@ PGAPI_Cancel(HSTMT hstmt)		/* Statement to cancel. */
 	 * 1. In the middle of SQLParamData / SQLPutData
 	 *    -> cancel the statement
 	 *
-	 * 2. Running a query asynchronously. (asynchronous mode is not supported
-	 *    by psqlODBC)
+	 * 2. Running a query asynchronously (SQL_ATTR_ASYNC_ENABLE).
+	 *    -> Send a query cancel request to the server. The next call of
+	 *       the function being polled returns the error.
 	 *
 	 * 3. Busy running a function in another thread.
 	 *    -> Send a query cancel request to the server
@@ -1386,8 +1440,8 @@ PGAPI_Cancel(HSTMT hstmt)		/* Statement to cancel. */
 	else if (estmt->status == STMT_EXECUTING)
 	{
 		/*
-		 * Busy executing in a different thread. Send a cancel request to
-		 * the server.
+		 * Busy executing in a different thread or asynchronously. Send a
+		 * cancel request to the server.
 		 */
 		if (!CC_send_cancel_request(conn))
 			return SQL_ERROR;
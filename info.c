@@ -856,7 +856,11 @@ MYLOG(0, "CONVERT_FUNCTIONS=" FORMAT_ULEN "\n", value);
 			break;
 		case SQL_ASYNC_MODE:
 			len = 4;
-			value = SQL_AM_NONE;
+			value = SQL_AM_STATEMENT;
+			break;
+		case SQL_ASYNC_DBC_FUNCTIONS:
+			len = 4;
+			value = SQL_ASYNC_DBC_CAPABLE;
 			break;
 		case SQL_BATCH_ROW_COUNT:
 			len = 4;
@@ -1053,6 +1057,10 @@ MYLOG(0, "CONVERT_FUNCTIONS=" FORMAT_ULEN "\n", value);
 #endif
 			len = 4;
 			break;
+		case SQL_MAX_ASYNC_CONCURRENT_STATEMENTS:
+			len = 4;
+			value = 1;	/* a connection runs one query at a time */
+			break;
 		/* The followings aren't implemented yet */
 		case SQL_DATETIME_LITERALS:
 			len = 4;
@@ -1060,8 +1068,6 @@ MYLOG(0, "CONVERT_FUNCTIONS=" FORMAT_ULEN "\n", value);
 			len = 0;
 		case SQL_DRIVER_HDESC:
 			len = 4;
-		case SQL_MAX_ASYNC_CONCURRENT_STATEMENTS:
-			len = 4;
 		case SQL_STANDARD_CLI_CONFORMANCE:
 			len = 4;
 		case SQL_XOPEN_CLI_YEAR:
@@ -312,3 +312,43 @@ quote_table(const pgNAME schema, const pgNAME table, char *buf, int buf_size)
 
 	return buf;
 }
+
+/*
+ *	Parse a tid value "(blocknum,offset)".
+ *	This is called for every row of keysets and is much cheaper
+ *	than (secure_)sscanf().
+ *	Returns FALSE if the value is malformed or out of range, and then
+ *	*blocknum and *offset are left unchanged.
+ */
+BOOL
+parse_tid(const char *str, UInt4 *blocknum, UInt2 *offset)
+{
+	const char *ptr = str;
+	UInt4	bln = 0, off = 0, digit;
+
+	if (NULL == ptr || '(' != *ptr++)
+		return FALSE;
+	if (!isdigit((unsigned char) *ptr))
+		return FALSE;
+	for (; isdigit((unsigned char) *ptr); ptr++)
+	{
+		digit = *ptr - '0';
+		if (bln > (0xffffffffU - digit) / 10)
+			return FALSE;
+		bln = bln * 10 + digit;
+	}
+	if (',' != *ptr++ || !isdigit((unsigned char) *ptr))
+		return FALSE;
+	for (; isdigit((unsigned char) *ptr); ptr++)
+	{
+		off = off * 10 + (*ptr - '0');
+		if (off > 0xffff)
+			return FALSE;
+	}
+	if (')' != *ptr)
+		return FALSE;
+	*blocknum = bln;
+	*offset = (UInt2) off;
+
+	return TRUE;
+}
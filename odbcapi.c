@@ -314,7 +314,7 @@ SQLExecDirect(HSTMT StatementHandle,
 	ENTER_STMT_CS(stmt);
 	SC_clear_error(stmt);
 	flag |= PODBC_WITH_HOLD;
-	if (SC_opencheck(stmt, func))
+	if (!SC_is_async_pending(stmt) && SC_opencheck(stmt, func))
 		ret = SQL_ERROR;
 	else
 	{
@@ -342,12 +342,13 @@ SQLExecute(HSTMT StatementHandle)
 	ENTER_STMT_CS(stmt);
 	SC_clear_error(stmt);
 	flag |= (PODBC_RECYCLE_STATEMENT | PODBC_WITH_HOLD);
-	if (SC_opencheck(stmt, func))
+	if (!SC_is_async_pending(stmt) && SC_opencheck(stmt, func))
 		ret = SQL_ERROR;
 	else
 	{
 		StartRollbackState(stmt);
-		stmt->exec_current_row = -1;
+		if (!SC_is_async_pending(stmt))
+			stmt->exec_current_row = -1;
 		//// SC_set_Result(StatementHandle, NULL);
 		ret = PGAPI_Execute(StatementHandle, flag);
 		ret = DiscardStatementSvp(stmt, ret, FALSE);
@@ -337,7 +337,7 @@ SQLExecDirectW(HSTMT StatementHandle,
 	SC_clear_error(stmt);
 	flag |= PODBC_WITH_HOLD;
 	StartRollbackState(stmt);
-	if (SC_opencheck(stmt, func))
+	if (!SC_is_async_pending(stmt) && SC_opencheck(stmt, func))
 		ret = SQL_ERROR;
 	else
 		ret = PGAPI_ExecDirect(StatementHandle,
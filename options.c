@@ -41,7 +41,14 @@ set_statement_option(ConnectionClass *conn,
 		ci = &(SC_get_conn(stmt)->connInfo);
 	switch (fOption)
 	{
-		case SQL_ASYNC_ENABLE:	/* ignored */
+		case SQL_ASYNC_ENABLE:
+			MYLOG(0, "SQL_ASYNC_ENABLE, vParam = " FORMAT_LEN "\n", vParam);
+			if (SQL_ASYNC_ENABLE_ON != vParam)
+				vParam = SQL_ASYNC_ENABLE_OFF;
+			if (conn)
+				conn->stmtOptions.async_enable = (SQLUINTEGER) vParam;
+			if (stmt)
+				stmt->options.async_enable = (SQLUINTEGER) vParam;
 			break;
 
 		case SQL_BIND_TYPE:
@@ -704,8 +711,8 @@ PGAPI_GetStmtOption(HSTMT hstmt,
 
 			break;
 
-		case SQL_ASYNC_ENABLE:	/* NOT SUPPORTED */
-			*((SQLINTEGER *) pvParam) = SQL_ASYNC_ENABLE_OFF;
+		case SQL_ASYNC_ENABLE:
+			*((SQLINTEGER *) pvParam) = stmt->options.async_enable;
 			break;
 
 		case SQL_BIND_TYPE:
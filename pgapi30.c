@@ -412,7 +412,10 @@ PGAPI_GetConnectAttr(HDBC ConnectionHandle,
 	switch (Attribute)
 	{
 		case SQL_ATTR_ASYNC_ENABLE:
-			*((SQLINTEGER *) Value) = SQL_ASYNC_ENABLE_OFF;
+			*((SQLINTEGER *) Value) = conn->stmtOptions.async_enable;
+			break;
+		case SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE:
+			*((SQLUINTEGER *) Value) = conn->async.enabled ? SQL_ASYNC_DBC_ENABLE_ON : SQL_ASYNC_DBC_ENABLE_OFF;
 			break;
 		case SQL_ATTR_AUTO_IPD:
 			*((SQLINTEGER *) Value) = SQL_FALSE;
@@ -963,10 +966,13 @@ MYLOG(DETAIL_LOG_LEVEL, "RecN=%d allocated=%d\n", RecNumber, ipdopts->allocated)
 						ipdopts->parameters[para_idx].SQLType = SQL_TYPE_TIMESTAMP;
 						break;
 				}
+				PIC_set_pgtype(ipdopts->parameters[para_idx], 0);
 				break;
 			}
 			break;
 		case SQL_DESC_CONCISE_TYPE:
+			if (ipdopts->parameters[para_idx].SQLType != CAST_PTR(SQLSMALLINT, Value))
+				PIC_set_pgtype(ipdopts->parameters[para_idx], 0);
 			ipdopts->parameters[para_idx].SQLType = CAST_PTR(SQLSMALLINT, Value);
 			break;
 		case SQL_DESC_NAME:
@@ -1772,6 +1778,8 @@ PGAPI_SetConnectAttr(HDBC ConnectionHandle,
 	int	newValue;
 
 	MYLOG(0, "entering for %p: " FORMAT_INTEGER " %p\n", ConnectionHandle, Attribute, Value);
+	if (CC_async_busy(conn, func))
+		return SQL_ERROR;
 	switch (Attribute)
 	{
 		case SQL_ATTR_METADATA_ID:
@@ -1814,6 +1822,14 @@ PGAPI_SetConnectAttr(HDBC ConnectionHandle,
 				unsupported = TRUE;
 			break;
 		case SQL_ATTR_ASYNC_ENABLE:
+			if (SQL_ASYNC_ENABLE_ON == CAST_UPTR(SQLULEN, Value))
+				conn->stmtOptions.async_enable = SQL_ASYNC_ENABLE_ON;
+			else
+				conn->stmtOptions.async_enable = SQL_ASYNC_ENABLE_OFF;
+			break;
+		case SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE:
+			conn->async.enabled = (SQL_ASYNC_DBC_ENABLE_ON == CAST_UPTR(SQLULEN, Value));
+			break;
 		case SQL_ATTR_CONNECTION_DEAD:
 		case SQL_ATTR_CONNECTION_TIMEOUT:
 			unsupported = TRUE;
@@ -2296,6 +2312,54 @@ typedef struct
 	int		idx, processed;
 }	bop_cdata;
 
+/*
+ *	Add all the rows of the rowset or update or delete all the rows
+ *	specified by the bookmarks together.
+ *	Returns FALSE if the rows should be processed one by one.
+ */
+static BOOL
+bulk_batch_rows(bop_cdata *s, QResultClass *res, RETCODE *ret)
+{
+	SQLLEN		nrows = s->opts->size_of_rowset, i;
+	SQLSETPOSIROW	*irows;
+	SQLULEN		*global_idxs;
+	KeySet		*keysets;
+	PG_BM		pg_bm;
+	BOOL		batched = FALSE;
+
+	irows = (SQLSETPOSIROW *) malloc(sizeof(SQLSETPOSIROW) * nrows);
+	global_idxs = (SQLULEN *) malloc(sizeof(SQLULEN) * nrows);
+	keysets = (KeySet *) malloc(sizeof(KeySet) * nrows);
+	if (NULL != irows && NULL != global_idxs && NULL != keysets)
+	{
+		for (i = 0; i < nrows; i++)
+		{
+			irows[i] = i;
+			if (SQL_ADD == s->operation)
+				continue;
+			pg_bm = SC_Resolve_bookmark(s->opts, (Int4) i);
+			QR_get_last_bookmark(res, pg_bm.index, &pg_bm.keys);
+			global_idxs[i] = pg_bm.index;
+			keysets[i] = pg_bm.keys;
+		}
+		if (SQL_ADD == s->operation)
+			*ret = SC_pos_add_rows(s->stmt, nrows, irows, &batched);
+		else
+			*ret = SC_pos_update_delete_rows(s->stmt,
+				SQL_UPDATE_BY_BOOKMARK == s->operation ? SQL_UPDATE : SQL_DELETE,
+				nrows, irows, global_idxs, keysets, &batched);
+		if (batched)
+			s->processed = (int) nrows;
+	}
+	if (irows)
+		free(irows);
+	if (global_idxs)
+		free(global_idxs);
+	if (keysets)
+		free(keysets);
+	return batched;
+}
+
 static
 RETCODE	bulk_ope_callback(RETCODE retcode, void *para)
 {
@@ -2318,14 +2382,19 @@ RETCODE	bulk_ope_callback(RETCODE retcode, void *para)
 	{
 		s->idx = s->processed = 0;
 	}
-	s->need_data_callback = FALSE;
 	res = SC_get_Curres(s->stmt);
+	if (!s->need_data_callback &&
+	    NULL != res &&
+	    (SQL_ADD == s->operation || SQL_UPDATE_BY_BOOKMARK == s->operation || SQL_DELETE_BY_BOOKMARK == s->operation) &&
+	    bulk_batch_rows(s, res, &ret))
+		s->idx = (int) s->opts->size_of_rowset; /* all the rows are processed */
+	s->need_data_callback = FALSE;
 	for (; SQL_ERROR != ret && s->idx < s->opts->size_of_rowset; s->idx++)
 	{
 		if (SQL_ADD != s->operation)
 		{
 			pg_bm = SC_Resolve_bookmark(s->opts, s->idx);
-			QR_get_last_bookmark(res, s->idx, &pg_bm.keys);
+			QR_get_last_bookmark(res, pg_bm.index, &pg_bm.keys);
 			global_idx = pg_bm.index;
 		}
 		/* Note opts->row_operation_ptr is ignored */
@@ -2382,6 +2451,8 @@ PGAPI_BulkOperations(HSTMT hstmt, SQLSMALLINT operationX)
 	s.stmt = (StatementClass *) hstmt;
 	s.operation = operationX;
 	SC_clear_error(s.stmt);
+	if (SC_async_busy(s.stmt, func))
+		return SQL_ERROR;
 	s.opts = SC_get_ARDF(s.stmt);
 
 	s.auto_commit_needed = FALSE;
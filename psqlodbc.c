@@ -39,9 +39,9 @@ BOOL isSqlServr(void) {return 3 == exepgm;}
 RETCODE SQL_API SQLDummyOrdinal(void);
 
 #if defined(WIN_MULTITHREAD_SUPPORT)
-extern	CRITICAL_SECTION	conns_cs, common_cs;
+extern	CRITICAL_SECTION	common_cs;
 #elif defined(POSIX_MULTITHREAD_SUPPORT)
-extern	pthread_mutex_t 	conns_cs, common_cs;
+extern	pthread_mutex_t 	common_cs;
 
 #ifdef	POSIX_THREADMUTEX_SUPPORT
 #ifdef	PG_RECURSIVE_MUTEXATTR
@@ -88,7 +88,6 @@ int	initialize_global_cs(void)
 	getMutexAttr();
 #endif /* POSIX_THREADMUTEX_SUPPORT */
 	InitializeLogging();
-	INIT_CONNS_CS;
 	INIT_COMMON_CS;
 
 	return 0;
@@ -97,7 +96,6 @@ int	initialize_global_cs(void)
 static void finalize_global_cs(void)
 {
 	DELETE_COMMON_CS;
-	DELETE_CONNS_CS;
 	FinalizeLogging();
 #ifdef	_DEBUG
 #ifdef	_MEMORY_DEBUG_
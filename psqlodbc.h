@@ -388,6 +388,17 @@ extern int posix_snprintf(char *buf, size_t size, const char *format, ...);
 #ifndef	SQL_ATTR_IMP_PARAM_DESC
 #define	SQL_ATTR_IMP_PARAM_DESC	10013
 #endif
+/* ODBC 3.8 asynchronous connection functions */
+#ifndef	SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE
+#define	SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE	117
+#define	SQL_ASYNC_DBC_ENABLE_ON		1UL
+#define	SQL_ASYNC_DBC_ENABLE_OFF	0UL
+#endif
+#ifndef	SQL_ASYNC_DBC_FUNCTIONS
+#define	SQL_ASYNC_DBC_FUNCTIONS	10023
+#define	SQL_ASYNC_DBC_CAPABLE	1L
+#define	SQL_ASYNC_DBC_NOT_CAPABLE	0L
+#endif
 
 /* Driver stuff */
 
@@ -638,6 +649,7 @@ typedef struct StatementOptions_
 	void			*bookmark_ptr;
 	SQLUINTEGER		metadata_id;
 	SQLULEN			stmt_timeout;
+	SQLUINTEGER		async_enable;
 } StatementOptions;
 
 /*	Used to pass extra query info to send_query */
@@ -647,6 +659,9 @@ typedef struct QueryInfo_
 	SQLLEN		fetch_size;
 	QResultClass	*result_in;
 	const char	*cursor;
+	const char * const *cursors;	/* instead of cursor, one for each result
+					 * of a multiple command query, NULL
+					 * terminated */
 } QueryInfo;
 
 /*	Used to save the error information */
@@ -743,10 +758,18 @@ typedef struct
 	signed char	optional_errors;
 	signed char	ignore_timeout;
 	signed char	fetch_refcursors;
+	signed char	cache_param_values;
+	signed char	pool_reset;
+	signed char	server_static_cursors;
 	UInt4		extra_opts;
 	Int4		keepalive_idle;
 	Int4		keepalive_interval;
 	Int4		batch_size;
+	Int4		pool_size;
+	Int4		pool_idle_timeout;
+	Int4		pool_lifetime;
+	Int4		scroll_cache_windows;
+	Int4		scroll_cache_size;
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	signed char	xa_opt;
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
@@ -30,6 +30,7 @@
 
 static BOOL QR_prepare_for_tupledata(QResultClass *self);
 static BOOL QR_read_tuples_from_pgres(QResultClass *, PGresult **pgres);
+static void QR_free_windows(QResultClass *self);
 
 /*
  *	Used for building a Manual Result only
@@ -220,6 +221,8 @@ QR_Constructor(void)
 		rv->recent_processed_row_count = -1;
 		rv->cursTuple = -1;
 		rv->move_offset = 0;
+		rv->cache_start = 0;
+		rv->cache_curs = -1;
 		rv->num_fields = 0;
 		rv->num_key_fields = PG_NUM_NORMAL_KEYS; /* CTID + OID */
 		rv->tupleField = NULL;
@@ -245,10 +248,15 @@ QR_Constructor(void)
 		rv->updated = NULL;
 		rv->updated_keyset = NULL;
 		rv->updated_tuples = NULL;
+		rv->updated_hash = NULL;
+		rv->uh_mask = 0;
 		rv->dl_alloc = 0;
 		rv->dl_count = 0;
 		rv->deleted = NULL;
 		rv->deleted_keyset = NULL;
+		rv->windows = NULL;
+		rv->win_count = 0;
+		rv->win_bytes = 0;
 	}
 
 	MYLOG(0, "leaving %p\n", rv);
@@ -511,19 +519,8 @@ QR_free_memory(QResultClass *self)
 			char	plannm[32];
 
 			SPRINTF_FIXED(plannm, "_KEYSET_%p", self);
-			if (CC_is_in_error_trans(conn))
-			{
-				CC_mark_a_object_to_discard(conn, 's',plannm);
-			}
-			else
-			{
-				QResultClass	*res;
-				char		cmd[64];
-
-				SPRINTF_FIXED(cmd, "DEALLOCATE \"%s\"", plannm);
-				res = CC_send_query(conn, cmd, NULL, IGNORE_ABORT_ON_CONN | ROLLBACK_ON_ERROR, NULL);
-				QR_Destructor(res);
-			}
+			/* DEALLOCATEd together with the next query */
+			CC_mark_a_object_to_discard(conn, 's',plannm);
 		}
 		self->reload_count = 0;
 	}
@@ -577,18 +574,49 @@ QR_free_memory(QResultClass *self)
 		free(self->updated_tuples);
 		self->updated_tuples = NULL;
 	}
+	if (self->updated_hash)
+	{
+		free(self->updated_hash);
+		self->updated_hash = NULL;
+	}
+	self->uh_mask = 0;
 	self->up_alloc = 0;
 	self->up_count = 0;
+	QR_free_windows(self);
 
 	self->num_total_read = 0;
 	self->num_cached_rows = 0;
 	self->num_cached_keys = 0;
 	self->cursTuple = -1;
+	self->cache_start = 0;
 	self->pstatus = 0;
 
 	MYLOG(0, "leaving\n");
 }
 
+/*
+ *	Binary search of the deleted index info which is kept in
+ *	ascending order.  Returns the position of the first entry
+ *	not less than index (dl_count if there's none).
+ */
+SQLLEN
+QR_search_deleted(const QResultClass *self, SQLLEN index)
+{
+	SQLLEN	low = 0, high = self->dl_count, mid;
+
+	if (!self->deleted)
+		return 0;
+	while (low < high)
+	{
+		mid = low + (high - low) / 2;
+		if (self->deleted[mid] < index)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
 
 BOOL
 QR_from_PGresult(QResultClass *self, StatementClass *stmt, ConnectionClass *conn, const char *cursor, PGresult **pgres)
@@ -712,6 +740,8 @@ MYLOG(DETAIL_LOG_LEVEL, "!!%p->cursTup=" FORMAT_LEN " total_read=" FORMAT_ULEN "
 	QR_set_cursor(self, cursor);
 	if (NULL == cursor)
 		QR_set_reached_eof(self);
+	else if (NULL != stmt && NULL != SC_get_conn(stmt))
+		CC_add_cursor_statement(SC_get_conn(stmt), stmt);
 	return TRUE;
 }
 
@@ -906,11 +936,201 @@ static SQLLEN enlargeKeyCache(QResultClass *self, SQLLEN add_size, const char *m
 	return alloc;
 }
 
+/*
+ *	Saved windows of the declare/fetch tuple cache.
+ *
+ *	When the tuple cache of a cursor without keyset is refilled, the
+ *	old rows are kept as a window so that scrolling back to them later
+ *	needs no MOVE/FETCH.  The windows are ordered from the least to the
+ *	most recently used one and limited by the ScrollCacheWindows and
+ *	ScrollCacheSize (in KB, 0 means no limit) options.
+ */
+static void
+QR_detach_cache(QResultClass *self)
+{
+	if (!QR_cache_is_detached(self))
+	{
+		self->cache_curs = self->cursTuple;
+		self->pstatus |= FQR_CACHE_DETACHED;
+	}
+}
+
+static void
+QR_drop_window(QResultClass *self, UInt4 idx)
+{
+	ScrollWindow	*w = self->windows + idx;
+
+	ClearCachedRows(w->tuples, self->num_fields, w->num_rows);
+	free(w->tuples);
+	self->win_bytes -= w->bytes;
+	self->win_count--;
+	memmove(w, w + 1, sizeof(ScrollWindow) * (self->win_count - idx));
+}
+
+static void
+QR_free_windows(QResultClass *self)
+{
+	while (self->win_count > 0)
+		QR_drop_window(self, self->win_count - 1);
+	if (self->windows)
+	{
+		free(self->windows);
+		self->windows = NULL;
+	}
+	self->win_bytes = 0;
+}
+
+static BOOL
+window_holds(const QResultClass *self, SQLLEN wstart, SQLULEN wrows, SQLLEN start, SQLLEN count)
+{
+	if (start < wstart || start >= wstart + (SQLLEN) wrows)
+		return FALSE;
+	if (start + count <= wstart + (SQLLEN) wrows)
+		return TRUE;
+	/* the rest of the rowset is beyond the end of the result */
+	return (QR_once_reached_eof(self) &&
+		(SQLULEN) wstart + wrows >= self->num_total_read);
+}
+
+/*
+ *	Does the tuple cache hold the rows [start, start + count) ?
+ */
+BOOL
+QR_cache_holds(const QResultClass *self, SQLLEN start, SQLLEN count)
+{
+	return window_holds(self, self->cache_start, self->num_cached_rows, start, count);
+}
+
+/*
+ *	Hand the tuple cache over to the saved windows.
+ *	Returns FALSE if the windows aren't used, the cache is left as is then.
+ */
+static BOOL
+QR_save_window(QResultClass *self)
+{
+	ConnectionClass	*conn = QR_get_conn(self);
+	ScrollWindow	*w;
+	SQLULEN		i, num_values;
+	Int4		max_windows;
+	size_t		max_bytes;
+
+	if (NULL == conn || QR_haskeyset(self) || !QR_get_cursor(self))
+		return FALSE;
+	if (max_windows = conn->connInfo.scroll_cache_windows, max_windows <= 0)
+		return FALSE;
+	if (0 == self->num_cached_rows || NULL == self->backend_tuples)
+		return FALSE;
+	if (NULL == self->windows)
+	{
+		self->windows = (ScrollWindow *) malloc(sizeof(ScrollWindow) * max_windows);
+		if (NULL == self->windows)
+			return FALSE;
+	}
+	else if (self->win_count >= (UInt4) max_windows)
+		QR_drop_window(self, 0);
+	w = self->windows + self->win_count++;
+	w->tuples = self->backend_tuples;
+	w->num_rows = self->num_cached_rows;
+	w->num_alloc = self->count_backend_allocated;
+	w->start = self->cache_start;
+	w->curs = QR_cache_is_detached(self) ? self->cache_curs : self->cursTuple;
+	num_values = self->num_fields * w->num_rows;
+	w->bytes = sizeof(TupleField) * self->num_fields * w->num_alloc;
+	for (i = 0; i < num_values; i++)
+	{
+		if (w->tuples[i].value)
+			w->bytes += w->tuples[i].len + 1;
+	}
+	self->win_bytes += w->bytes;
+MYLOG(DETAIL_LOG_LEVEL, "saved window " FORMAT_LEN "+" FORMAT_ULEN " %zu bytes\n", w->start, w->num_rows, w->bytes);
+	max_bytes = (size_t) conn->connInfo.scroll_cache_size * 1024;
+	while (max_bytes > 0 && self->win_bytes > max_bytes)
+		QR_drop_window(self, 0);
+
+	self->backend_tuples = NULL;
+	self->tupleField = NULL;
+	self->count_backend_allocated = 0;
+	self->num_cached_rows = 0;
+	self->dataFilled = FALSE;
+	self->pstatus &= ~FQR_CACHE_DETACHED;
+	return TRUE;
+}
+
+/*
+ *	Look for a saved window which holds the rows [start, start + count)
+ *	and make it the tuple cache, saving the current one in turn.
+ */
+BOOL
+QR_restore_window(QResultClass *self, SQLLEN start, SQLLEN count)
+{
+	ScrollWindow	w;
+	Int4		i;
+
+	for (i = (Int4) self->win_count - 1; i >= 0; i--)
+	{
+		if (window_holds(self, self->windows[i].start, self->windows[i].num_rows, start, count))
+			break;
+	}
+	if (i < 0)
+		return FALSE;
+	w = self->windows[i];
+	self->win_bytes -= w.bytes;
+	self->win_count--;
+	memmove(self->windows + i, self->windows + i + 1, sizeof(ScrollWindow) * (self->win_count - i));
+	if (!QR_save_window(self) && self->backend_tuples)
+	{
+		ClearCachedRows(self->backend_tuples, self->num_fields, self->num_cached_rows);
+		free(self->backend_tuples);
+	}
+	self->backend_tuples = w.tuples;
+	self->count_backend_allocated = w.num_alloc;
+	self->num_cached_rows = w.num_rows;
+	self->cache_size = w.num_rows;
+	self->cache_start = w.start;
+	self->dataFilled = TRUE;
+	/* the cursor stays where it is */
+	if (w.curs == self->cursTuple)
+		self->pstatus &= ~FQR_CACHE_DETACHED;
+	else
+	{
+		self->cache_curs = w.curs;
+		self->pstatus |= FQR_CACHE_DETACHED;
+	}
+	QR_set_rowstart_in_cache(self, start - w.start);
+	MYLOG(0, "restored window " FORMAT_LEN "+" FORMAT_ULEN " for " FORMAT_LEN "\n", w.start, w.num_rows, start);
+	return TRUE;
+}
+
+/*
+ *	The rows of a cursor beyond SQL_ATTR_MAX_ROWS of the statement are
+ *	never fetched.  Returns the count of rows which may still be read
+ *	from the cursor (-1 if there's no limit) and marks the result as
+ *	having reached EOF when the limit is reached.
+ */
+SQLLEN
+QR_rows_before_max(QResultClass *self, const StatementClass *stmt)
+{
+	SQLLEN	max_rows = stmt->options.maxRows;
+
+	if (max_rows <= 0 || !QR_get_cursor(self))
+		return -1;
+	if (self->cursTuple + 1 < max_rows)
+		return max_rows - (self->cursTuple + 1);
+	if (!QR_once_reached_eof(self))
+	{
+		MYLOG(0, "reached max_rows=" FORMAT_LEN "\n", max_rows);
+		/* the cursor stays on the last row read */
+		self->num_total_read = max_rows;
+		QR_set_reached_eof(self);
+	}
+	return 0;
+}
+
 SQLLEN	QR_move_cursor_to_last(QResultClass *self, StatementClass *stmt)
 {
 	char		movecmd[64];
 	QResultClass	*res;
-	SQLLEN		moved;
+	SQLLEN		moved, limit;
 	ConnectionClass	*conn = SC_get_conn(stmt);
 
 	if (!QR_get_cursor(self))
@@ -918,8 +1138,14 @@ SQLLEN	QR_move_cursor_to_last(QResultClass *self, StatementClass *stmt)
 	if (QR_once_reached_eof(self) &&
 	    self->cursTuple >= self->num_total_read)
 		return 0;
-	SPRINTF_FIXED(movecmd,
-		 "move all in \"%s\"", QR_get_cursor(self));
+	if (limit = QR_rows_before_max(self, stmt), 0 == limit)
+		return 0;
+	if (limit > 0)
+		SPRINTF_FIXED(movecmd,
+			 "move " FORMAT_LEN " in \"%s\"", limit, QR_get_cursor(self));
+	else
+		SPRINTF_FIXED(movecmd,
+			 "move all in \"%s\"", QR_get_cursor(self));
 	res = CC_send_query(conn, movecmd, NULL, READ_ONLY_QUERY, stmt);
 	if (!QR_command_maybe_successful(res))
 	{
@@ -931,12 +1157,22 @@ SQLLEN	QR_move_cursor_to_last(QResultClass *self, StatementClass *stmt)
 	int status = 0;
 	if (secure_sscanf(res->command, &status, "MOVE " FORMAT_ULEN, ARG_FORMAT_ULEN(&moved)) > 0)
 	{
-		moved++;
-		self->cursTuple += moved;
-		if (!QR_once_reached_eof(self))
+		QR_detach_cache(self);
+		if (limit > 0 && moved >= limit)
 		{
-			self->num_total_read = self->cursTuple;
-			QR_set_reached_eof(self);
+			/* stopped on the last row within the limit */
+			self->cursTuple += moved;
+			QR_rows_before_max(self, stmt);
+		}
+		else
+		{
+			moved++;
+			self->cursTuple += moved;
+			if (!QR_once_reached_eof(self))
+			{
+				self->num_total_read = self->cursTuple;
+				QR_set_reached_eof(self);
+			}
 		}
 	}
 	QR_Destructor(res);
@@ -956,7 +1192,7 @@ QR_next_tuple(QResultClass *self, StatementClass *stmt)
 	SQLLEN		num_total_rows;
 	SQLLEN		num_backend_rows = self->num_cached_rows, num_rows_in;
 	Int4		num_fields = self->num_fields, fetch_size, req_size;
-	SQLLEN		offset = 0, end_tuple;
+	SQLLEN		offset = 0, end_tuple, max_rows_left;
 	char		boundary_adjusted = FALSE;
 	TupleField *the_tuples = self->backend_tuples;
 	QResultClass	*res;
@@ -1055,6 +1291,7 @@ MYLOG(DETAIL_LOG_LEVEL, "moved=" FORMAT_ULEN " ? " FORMAT_ULEN "\n", moved, move
 		}
 		/* ... by the following call */
 		QR_set_rowstart_in_cache(self, -1);
+		QR_detach_cache(self);
 		if (QR_is_moving_backward(self))
 		{
 			self->cursTuple -= moved;
@@ -1115,6 +1352,11 @@ MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
 		QR_set_reached_eof(self);
 		RETURN(-1)		/* end of tuples */
 	}
+	if (max_rows_left = QR_rows_before_max(self, stmt), 0 == max_rows_left)
+	{
+		MYLOG(0, "no more rows within max_rows\n");
+		RETURN(-1)		/* end of tuples */
+	}
 
 	if (QR_get_rowstart_in_cache(self) >= num_backend_rows ||
 		QR_is_moving(self))
@@ -1125,7 +1367,11 @@ MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
 		self->cache_size = fetch_size;
 		/* clear obsolete tuples */
 MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_rows);
-		ClearCachedRows(tuple, num_fields, num_backend_rows);
+		if (QR_save_window(self))
+			num_backend_rows = 0;
+		else
+			ClearCachedRows(tuple, num_fields, num_backend_rows);
+		self->pstatus &= ~FQR_CACHE_DETACHED;
 		self->dataFilled = FALSE;
 		QR_stop_movement(self);
 		self->move_offset = 0;
@@ -1152,6 +1398,8 @@ MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_ro
 		boundary_adjusted = TRUE;
 	}
 
+	if (max_rows_left > 0 && fetch_size > max_rows_left)
+		fetch_size = (Int4) max_rows_left;
 	if (enlargeKeyCache(self, self->cache_size - num_backend_rows, "Out of memory while reading tuples") < 0)
 		RETURN(FALSE)
 
@@ -1165,6 +1413,7 @@ MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_ro
 	{
 		QR_set_num_cached_rows(self, 0);
 		QR_set_rowstart_in_cache(self, offset);
+		self->cache_start = self->cursTuple + 1;
 	}
 	num_rows_in = self->num_cached_rows;
 
@@ -1173,6 +1422,7 @@ MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_ro
 	qi.fetch_size = fetch_size;
 	qi.result_in = self;
 	qi.cursor = NULL;
+	qi.cursors = NULL;
 	res = CC_send_query(conn, fetch, &qi, READ_ONLY_QUERY, stmt);
 	if (!QR_command_maybe_successful(res))
 	{
@@ -1193,6 +1443,7 @@ MYLOG(DETAIL_LOG_LEVEL, "reached_eof_now=%d\n", reached_eof_now);
 	cur_fetch = self->num_cached_rows - num_rows_in;
 	if (!ret)
 		RETURN(ret)
+	QR_rows_before_max(self, stmt);
 
 	{
 		SQLLEN	start_idx = 0;
@@ -1275,17 +1526,14 @@ MYLOG(DETAIL_LOG_LEVEL, "will add " FORMAT_LEN " added_tuples from " FORMAT_LEN
 		for (i = lkidx; i < hkidx; i++)
 			self->keyset[i].status |= CURS_NEEDS_REREAD;
 		/* deleted info */
-		for (i = 0; i < self->dl_count && hidx > deleted[i]; i++)
+		for (i = QR_search_deleted(self, lidx); i < self->dl_count && hidx > deleted[i]; i++)
 		{
-			if (lidx <= deleted[i])
+			lf = GIdx2KResIdx(deleted[i], stmt, self);
+			if (lf >= 0 && lf < self->num_cached_keys)
 			{
-				lf = GIdx2KResIdx(deleted[i], stmt, self);
-				if (lf >= 0 && lf < self->num_cached_keys)
-				{
-					self->keyset[lf].status = self->deleted_keyset[i].status;
-					/* mark the row off */
-					self->keyset[lf].status &= (~CURS_NEEDS_REREAD);
-				}
+				self->keyset[lf].status = self->deleted_keyset[i].status;
+				/* mark the row off */
+				self->keyset[lf].status &= (~CURS_NEEDS_REREAD);
 			}
 		}
 		for (i = self->up_count - 1; i >= 0; i--)
@@ -1336,7 +1584,6 @@ QR_read_tuples_from_pgres(QResultClass *self, PGresult **pgres)
 	int		num_fields = self->num_fields;	/* speed up access */
 	ColumnInfoClass *flds;
 	int		effective_cols;
-	char		tidoidbuf[32];
 	int			rowno;
 	int			nrows;
 	int			resStatus;
@@ -1403,19 +1650,11 @@ nextrow:
 			{
 				len = PQgetlength(*pgres, rowno, field_lf);
 				value = PQgetvalue(*pgres, rowno, field_lf);
-				if (field_lf >= effective_cols)
-					buffer = tidoidbuf;
-				else
-				{
-					QR_MALLOC_return_with_error(buffer, char, len + 1, self, "Out of memory in allocating item buffer.", FALSE);
-				}
-				memcpy(buffer, value, len);
-				buffer[len] = '\0';
-
-				QPRINTF(TUPLE_LOG_LEVEL, " '%s'(%d)", buffer, len);
 
 				if (field_lf >= effective_cols)
 				{
+					/* the key values are parsed in place */
+					QPRINTF(TUPLE_LOG_LEVEL, " '%s'(%d)", value, len);
 					if (NULL == this_keyset)
 					{
 						char	emsg[128];
@@ -1425,16 +1664,29 @@ nextrow:
 						QR_set_message(self, emsg);
 						return FALSE;
 					}
-					int status = 0;
 					if (field_lf == effective_cols)
-						secure_sscanf(buffer, &status, "(%u,%hu)",
-							ARG_UINT(&this_keyset->blocknum),
-							ARG_USHORT(&this_keyset->offset));
+					{
+						if (!parse_tid(value, &this_keyset->blocknum, &this_keyset->offset))
+						{
+							char	emsg[128];
+
+							QR_set_rstatus(self, PORES_INTERNAL_ERROR);
+							SPRINTF_FIXED(emsg, "Internal Error -- invalid ctid %.64s", value);
+							QR_set_message(self, emsg);
+							return FALSE;
+						}
+					}
 					else
-						this_keyset->oid = strtoul(buffer, NULL, 10);
+						this_keyset->oid = strtoul(value, NULL, 10);
 				}
 				else
 				{
+					QR_MALLOC_return_with_error(buffer, char, len + 1, self, "Out of memory in allocating item buffer.", FALSE);
+					memcpy(buffer, value, len);
+					buffer[len] = '\0';
+
+					QPRINTF(TUPLE_LOG_LEVEL, " '%s'(%d)", buffer, len);
+
 					this_tuplefield[field_lf].len = len;
 					this_tuplefield[field_lf].value = buffer;
 
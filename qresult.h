@@ -48,8 +48,20 @@ enum
 	FQR_REACHED_EOF = (1L << 1)	/* reached eof */
 	,FQR_HAS_VALID_BASE = (1L << 2)
 	,FQR_NEEDS_SURVIVAL_CHECK = (1L << 3) /* check if the cursor is open */
+	,FQR_CACHE_DETACHED = (1L << 4) /* the cursor isn't positioned at the end of the cache */
 };
 
+/*	A tuple cache window of a declare/fetch cursor kept for later use */
+typedef struct
+{
+	TupleField	*tuples;	/* backend_tuples of the window */
+	SQLULEN		num_rows;	/* count of tuples in the window */
+	SQLULEN		num_alloc;	/* m(re)allocated count */
+	SQLLEN		start;		/* absolute position of the first tuple */
+	SQLLEN		curs;		/* cursTuple just after the window was read */
+	size_t		bytes;		/* approximate memory used by the window */
+} ScrollWindow;
+
 struct QResultClass_
 {
 	ColumnInfoClass *fields;	/* the Column information */
@@ -65,6 +77,8 @@ struct QResultClass_
 	SQLLEN		cursTuple;	/* absolute current position in the servr's cursor used to retrieve tuples from the DB */
 	SQLULEN		move_offset;
 	SQLLEN		base;		/* relative position of rowset start in the current data cache(backend_tuples) */
+	SQLLEN		cache_start;	/* absolute position of the first tuple in the data cache */
+	SQLLEN		cache_curs;	/* cursTuple just after the data cache was read (when detached) */
 
 	UInt2		num_fields;	/* number of fields in the result */
 	UInt2		num_key_fields;	/* number of key fields in the result */
@@ -95,23 +109,28 @@ struct QResultClass_
 	KeySet		*keyset;
 	SQLLEN		key_base;	/* relative position of rowset start in the current keyset cache */
 	UInt2		reload_count;
-	UInt2		rb_alloc;	/* count of allocated rollback info */
-	UInt2		rb_count;	/* count of rollback info */
+	UInt4		rb_alloc;	/* count of allocated rollback info */
+	UInt4		rb_count;	/* count of rollback info */
 	char		dataFilled;	/* Cache is filled with data ? */
 	Rollback	*rollback;
 	UInt4		ad_alloc;	/* count of allocated added info */
 	UInt4		ad_count;	/* count of newly added rows */
 	KeySet		*added_keyset;	/* added keyset info */
 	TupleField	*added_tuples;	/* added data by myself */
-	UInt2		dl_alloc;	/* count of allocated deleted info */
-	UInt2		dl_count;	/* count of deleted info */
-	SQLLEN		*deleted;	/* deleted index info */
+	UInt4		dl_alloc;	/* count of allocated deleted info */
+	UInt4		dl_count;	/* count of deleted info */
+	SQLLEN		*deleted;	/* deleted index info in ascending order */
 	KeySet		*deleted_keyset;	/* deleted keyset info */
-	UInt2		up_alloc;	/* count of allocated updated info */
-	UInt2		up_count;	/* count of updated info */
+	UInt4		up_alloc;	/* count of allocated updated info */
+	UInt4		up_count;	/* count of updated info */
 	SQLLEN		*updated;	/* updated index info */
 	KeySet		*updated_keyset;	/* uddated keyset info */
 	TupleField	*updated_tuples;	/* uddated data by myself */
+	SQLLEN		*updated_hash;	/* hash of the last updated info of each row */
+	UInt4		uh_mask;	/* count of updated_hash slots - 1 */
+	ScrollWindow	*windows;	/* saved cache windows, the most recently used last */
+	UInt4		win_count;	/* count of saved windows */
+	size_t		win_bytes;	/* memory used by the saved windows */
 };
 
 enum {
@@ -204,6 +223,7 @@ do { \
 #define QR_once_reached_eof(self)	((self->pstatus & FQR_REACHED_EOF) != 0)
 #define	QR_has_valid_base(self)		(0 != (self->pstatus & FQR_HAS_VALID_BASE))
 #define	QR_needs_survival_check(self)		(0 != (self->pstatus & FQR_NEEDS_SURVIVAL_CHECK))
+#define	QR_cache_is_detached(self)	(0 != (self->pstatus & FQR_CACHE_DETACHED))
 
 #define QR_aborted(self)		(!self || self->aborted)
 #define QR_get_reqsize(self)		(self->rowset_size_include_ommitted)
@@ -248,7 +268,11 @@ void		QR_set_position(QResultClass *self, SQLLEN pos);
 void		QR_set_cursor(QResultClass *self, const char *name);
 SQLLEN		getNthValid(const QResultClass *self, SQLLEN sta, UWORD orientation, SQLULEN nth, SQLLEN *nearest);
 SQLLEN		QR_move_cursor_to_last(QResultClass *self, StatementClass *stmt);
-BOOL		QR_get_last_bookmark(const QResultClass *self, Int4 index, KeySet *keyset);
+SQLLEN		QR_rows_before_max(QResultClass *self, const StatementClass *stmt);
+BOOL		QR_cache_holds(const QResultClass *self, SQLLEN start, SQLLEN count);
+BOOL		QR_restore_window(QResultClass *self, SQLLEN start, SQLLEN count);
+BOOL		QR_get_last_bookmark(QResultClass *self, Int4 index, KeySet *keyset);
+SQLLEN		QR_search_deleted(const QResultClass *self, SQLLEN index);
 int			QR_search_by_fieldname(const QResultClass *self, const char *name);
 
 #define QR_MALLOC_return_with_error(t, tp, s, a, m, r) \
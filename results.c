@@ -54,6 +54,8 @@ PGAPI_RowCount(HSTMT hstmt,
 		SC_log_error(func, NULL_STRING, NULL);
 		return SQL_INVALID_HANDLE;
 	}
+	if (SC_async_busy(stmt, func))
+		return SQL_ERROR;
 	if (stmt->proc_return > 0)
 	{
 		*pcrow = 0;
@@ -78,7 +80,20 @@ PGAPI_RowCount(HSTMT hstmt,
 		}
 		else if (QR_NumResultCols(res) > 0)
 		{
-			*pcrow = QR_get_cursor(res) ? -1 : QR_get_num_total_tuples(res) - res->dl_count;
+			ConnInfo	*ci = &(SC_get_conn(stmt)->connInfo);
+
+			if (QR_get_cursor(res) &&
+			    (SC_is_server_static(stmt, ci) ||
+			     SC_is_max_rows_cursor(stmt, ci)))
+			{
+				/* count the rows once by moving the cursor to the end */
+				if (!QR_once_reached_eof(res) &&
+				    QR_move_cursor_to_last(res, stmt) < 0)
+					return SQL_ERROR;
+				*pcrow = QR_get_num_total_tuples(res) - res->dl_count;
+			}
+			else
+				*pcrow = QR_get_cursor(res) ? -1 : QR_get_num_total_tuples(res) - res->dl_count;
 			MYLOG(0, "RowCount=" FORMAT_LEN "\n", *pcrow);
 			return SQL_SUCCESS;
 		}
@@ -161,6 +176,8 @@ PGAPI_NumResultCols(HSTMT hstmt,
 		SC_log_error(func, NULL_STRING, NULL);
 		return SQL_INVALID_HANDLE;
 	}
+	if (SC_async_busy(stmt, func))
+		return SQL_ERROR;
 
 	SC_clear_error(stmt);
 #define	return	DONT_CALL_RETURN_FROM_HERE???
@@ -257,6 +274,8 @@ PGAPI_DescribeCol(HSTMT hstmt,
 		SC_log_error(func, NULL_STRING, NULL);
 		return SQL_INVALID_HANDLE;
 	}
+	if (SC_async_busy(stmt, func))
+		return SQL_ERROR;
 
 	conn = SC_get_conn(stmt);
 	ci = &(conn->connInfo);
@@ -520,6 +539,8 @@ PGAPI_ColAttributes(HSTMT hstmt,
 		SC_log_error(func, NULL_STRING, NULL);
 		return SQL_INVALID_HANDLE;
 	}
+	if (SC_async_busy(stmt, func))
+		return SQL_ERROR;
 	stmt_updatable = SC_is_updatable(stmt)
 		/* The following doesn't seem appropriate for client side cursors
 		  && stmt->options.scroll_concurrency != SQL_CONCUR_READ_ONLY
@@ -973,6 +994,8 @@ PGAPI_GetData(HSTMT hstmt,
 		SC_log_error(func, NULL_STRING, NULL);
 		return SQL_INVALID_HANDLE;
 	}
+	if (SC_async_busy(stmt, func))
+		return SQL_ERROR;
 	res = SC_get_Curres(stmt);
 
 	if (STMT_EXECUTING == stmt->status)
@@ -1202,6 +1225,8 @@ PGAPI_Fetch(HSTMT hstmt)
 		SC_log_error(func, NULL_STRING, NULL);
 		return SQL_INVALID_HANDLE;
 	}
+	if (SC_async_busy(stmt, func))
+		return SQL_ERROR;
 
 	SC_clear_error(stmt);
 
@@ -1298,24 +1323,29 @@ MYLOG(DETAIL_LOG_LEVEL, "get " FORMAT_ULEN "th Valid data from " FORMAT_LEN " to
 	if (QR_get_cursor(res))
 	{
 		SQLLEN	*deleted = res->deleted;
-		SQLLEN	delsta;
+		SQLLEN	delsta, base, low, high, mid;
 
+		/*
+		 * The deleted indexes are distinct and in ascending order,
+		 * so the count of the deleted rows skipped is binary searched.
+		 */
 		if (SQL_FETCH_PRIOR == orientation)
 		{
-			*nearest = sta + 1 - nth;
-			delsta = (-1);
-			MYPRINTF(DETAIL_LOG_LEVEL, "deleted ");
-			for (i = res->dl_count - 1; i >=0 && *nearest <= deleted[i]; i--)
+			/* the last deleted row not after sta */
+			delsta = QR_search_deleted(res, sta + 1) - 1;
+			base = sta + 1 - nth;
+			for (low = 0, high = delsta + 1; low < high;)
 			{
-				MYPRINTF(DETAIL_LOG_LEVEL, "[" FORMAT_LEN "]=" FORMAT_LEN " ", i, deleted[i]);
-				if (sta >= deleted[i])
-				{
-					(*nearest)--;
-					if (i > delsta)
-						delsta = i;
-				}
+				mid = low + (high - low) / 2;
+				if (deleted[delsta - mid] + mid < base)
+					high = mid;
+				else
+					low = mid + 1;
 			}
-			MYPRINTF(DETAIL_LOG_LEVEL, "nearest=" FORMAT_LEN "\n", *nearest);
+			*nearest = base - low;
+			if (0 == low)
+				delsta = -1;
+			MYPRINTF(DETAIL_LOG_LEVEL, "deleted skipped=" FORMAT_LEN " nearest=" FORMAT_LEN "\n", low, *nearest);
 			if (*nearest < 0)
 			{
 				*nearest = -1;
@@ -1326,24 +1356,25 @@ MYLOG(DETAIL_LOG_LEVEL, "get " FORMAT_ULEN "th Valid data from " FORMAT_LEN " to
 		}
 		else
 		{
-			MYPRINTF(DETAIL_LOG_LEVEL, "\n");
-			*nearest = sta - 1 + nth;
-			delsta = res->dl_count;
-			if (!QR_once_reached_eof(res))
-				num_tuples = INT_MAX;
-			for (i = 0; i < res->dl_count && *nearest >= deleted[i]; i++)
+			/* the first deleted row not before sta */
+			delsta = QR_search_deleted(res, sta);
+			base = sta - 1 + nth;
+			for (low = 0, high = (SQLLEN) res->dl_count - delsta; low < high;)
 			{
-				if (sta <= deleted[i])
-				{
-					(*nearest)++;
-					if (i < delsta)
-						delsta = i;
-				}
+				mid = low + (high - low) / 2;
+				if (deleted[delsta + mid] - mid > base)
+					high = mid;
+				else
+					low = mid + 1;
 			}
+			*nearest = base + low;
+			if (0 == low)
+				delsta = (SQLLEN) res->dl_count;
+			MYPRINTF(DETAIL_LOG_LEVEL, "deleted skipped=" FORMAT_LEN " nearest=" FORMAT_LEN "\n", low, *nearest);
 			if (*nearest >= num_tuples)
 			{
 				*nearest = num_tuples;
-				count = *nearest - sta + delsta - res->dl_count;
+				count = *nearest - sta + delsta - (SQLLEN) res->dl_count;
 			}
 			else
 				return nth;
@@ -1411,7 +1442,22 @@ MYLOG(DETAIL_LOG_LEVEL, "BASE=" FORMAT_LEN " numb=" FORMAT_LEN " curr=" FORMAT_L
 	if (QR_get_rowstart_in_cache(res) >= 0 &&
 	     QR_get_rowstart_in_cache(res) <= res->num_cached_rows)
 	{
-		QR_set_next_in_cache(res, (QR_get_rowstart_in_cache(res) < 0) ? 0 : QR_get_rowstart_in_cache(res));
+		/*
+		 * The cursor isn't positioned at the end of a detached cache
+		 * and the cache can't be followed by the next fetch.
+		 */
+		if (!QR_cache_is_detached(res) ||
+		    QR_cache_holds(res, self->currTuple + 1, QR_get_reqsize(res)))
+		{
+			QR_set_next_in_cache(res, (QR_get_rowstart_in_cache(res) < 0) ? 0 : QR_get_rowstart_in_cache(res));
+			return;
+		}
+		QR_set_rowstart_in_cache(res, res->num_cached_rows);
+		QR_set_next_in_cache(res, res->num_cached_rows);
+	}
+	else if (QR_restore_window(res, self->currTuple + 1, QR_get_reqsize(res)))
+	{
+		QR_set_next_in_cache(res, QR_get_rowstart_in_cache(res));
 		return;
 	}
 	if (0 == move_offset)
@@ -1490,6 +1536,8 @@ PGAPI_ExtendedFetch(HSTMT hstmt,
 		SC_log_error(func, NULL_STRING, NULL);
 		return SQL_INVALID_HANDLE;
 	}
+	if (SC_async_busy(stmt, func))
+		return SQL_ERROR;
 
 	/* if (SC_is_fetchcursor(stmt) && !stmt->manual_result) */
 	if (SQL_CURSOR_FORWARD_ONLY == stmt->options.cursor_type)
@@ -2031,11 +2079,14 @@ cleanup:
 RETCODE		SQL_API
 PGAPI_MoreResults(HSTMT hstmt)
 {
+	CSTR func = "PGAPI_MoreResults";
 	StatementClass	*stmt = (StatementClass *) hstmt;
 	QResultClass	*res;
 	RETCODE		ret = SQL_SUCCESS;
 
 	MYLOG(0, "entering...\n");
+	if (SC_async_busy(stmt, func))
+		return SQL_ERROR;
 	res = SC_get_Curres(stmt);
 	if (res)
 	{
@@ -2109,24 +2160,28 @@ static void getTid(const QResultClass *res, SQLLEN index, UInt4 *blocknum, UInt2
 	*blocknum = res->keyset[index].blocknum;
 	*offset = res->keyset[index].offset;
 }
-static void KeySetSet(const TupleField *tuple, int num_fields, int num_key_fields, KeySet *keyset, BOOL statusInit)
+static BOOL KeySetSet(const TupleField *tuple, int num_fields, int num_key_fields, KeySet *keyset, BOOL statusInit)
 {
-	int status = 0;
 	if (statusInit)
 		keyset->status = 0;
-	secure_sscanf(tuple[num_fields - num_key_fields].value, &status, "(%u,%hu)",
-		ARG_UINT(&(keyset->blocknum)), ARG_USHORT(&(keyset->offset)));
+	if (!parse_tid(tuple[num_fields - num_key_fields].value, &keyset->blocknum, &keyset->offset))
+	{
+		MYLOG(0, "invalid tid %s\n", NULL_IF_NULL(tuple[num_fields - num_key_fields].value));
+		return FALSE;
+	}
 	if (num_key_fields > 1)
 	{
 		const char *oval = tuple[num_fields - 1].value;
 
 		if ('-' == oval[0])
-			secure_sscanf(oval, &status, "%d", ARG_INT(&(keyset->oid)));
+			keyset->oid = (OID) strtol(oval, NULL, 10);
 		else
-			secure_sscanf(oval, &status, "%u", ARG_UINT(&(keyset->oid)));
+			keyset->oid = (OID) strtoul(oval, NULL, 10);
 	}
 	else
 		keyset->oid = 0;
+
+	return TRUE;
 }
 
 static void AddRollback(StatementClass *stmt, QResultClass *res, SQLLEN index, const KeySet *keyset, Int4 dmlcode)
@@ -2349,7 +2404,8 @@ MYLOG(DETAIL_LOG_LEVEL, "entering index=" FORMAT_LEN ", tuple=%p, num_fields=%d\
 		index = -(SQLLEN)res->ad_count;
 	if (!tuple_added)
 		return;
-	KeySetSet(tuple_added, num_fields + res->num_key_fields, res->num_key_fields, &keys, TRUE);
+	if (!KeySetSet(tuple_added, num_fields + res->num_key_fields, res->num_key_fields, &keys, TRUE))
+		return;
 	keys.status = SQL_ROW_ADDED;
 	if (CC_is_in_trans(SC_get_conn(stmt)))
 		keys.status |= CURS_SELF_ADDING;
@@ -2449,45 +2505,48 @@ MYLOG(DETAIL_LOG_LEVEL, "!!Commit Added=" FORMAT_ULEN "(%d)\n", QR_get_num_total
 static int
 AddDeleted(QResultClass *res, SQLULEN index, const KeySet *keyset)
 {
-	int	i;
-	Int2	dl_count, new_alloc;
+	SQLLEN	i;
+	UInt4	dl_count, new_alloc;
 	SQLLEN	*deleted;
 	KeySet	*deleted_keyset;
 	UWORD	status;
 
 MYLOG(DETAIL_LOG_LEVEL, "entering " FORMAT_ULEN "\n", index);
-	dl_count = res->dl_count;
-	res->dl_count++;
 	if (!QR_get_cursor(res))
+	{
+		res->dl_count++;
 		return TRUE;
+	}
+	dl_count = res->dl_count;
 	if (!res->deleted)
 	{
 		dl_count = 0;
 		new_alloc = 10;
 		QR_MALLOC_return_with_error(res->deleted, SQLLEN, sizeof(SQLLEN) * new_alloc, res, "Deleted index malloc error", FALSE);
 		QR_MALLOC_return_with_error(res->deleted_keyset, KeySet, sizeof(KeySet) * new_alloc, res, "Deleted keyset malloc error", FALSE);
-		deleted = res->deleted;
-		deleted_keyset = res->deleted_keyset;
 		res->dl_alloc = new_alloc;
 	}
+	else if (dl_count >= res->dl_alloc)
+	{
+		new_alloc = res->dl_alloc * 2;
+		res->dl_alloc = 0;
+		QR_REALLOC_return_with_error(res->deleted, SQLLEN, sizeof(SQLLEN) * new_alloc, res, "Deleted index realloc error", FALSE);
+		QR_REALLOC_return_with_error(res->deleted_keyset, KeySet, sizeof(KeySet) * new_alloc, res, "Deleted KeySet realloc error", FALSE);
+		res->dl_alloc = new_alloc;
+	}
+	res->dl_count = dl_count;
+	/*
+	 * sort deleted indexes in ascending order.
+	 * Rows are mostly deleted in ascending order and simply appended.
+	 */
+	if (dl_count > 0 && (SQLLEN) index < res->deleted[dl_count - 1])
+		i = QR_search_deleted(res, (SQLLEN) index);
 	else
+		i = dl_count;
+	deleted = res->deleted + i;
+	deleted_keyset = res->deleted_keyset + i;
+	if (i < dl_count)
 	{
-		if (dl_count >= res->dl_alloc)
-		{
-			new_alloc = res->dl_alloc * 2;
-			res->dl_alloc = 0;
-			QR_REALLOC_return_with_error(res->deleted, SQLLEN, sizeof(SQLLEN) * new_alloc, res, "Deleted index realloc error", FALSE);
-			deleted = res->deleted;
-			QR_REALLOC_return_with_error(res->deleted_keyset, KeySet, sizeof(KeySet) * new_alloc, res, "Deleted KeySet realloc error", FALSE);
-			deleted_keyset = res->deleted_keyset;
-			res->dl_alloc = new_alloc;
-		}
-		/* sort deleted indexes in ascending order */
-		for (i = 0, deleted = res->deleted, deleted_keyset = res->deleted_keyset; i < dl_count; i++, deleted++, deleted_keyset++)
-		{
-			if (index < *deleted)
-				break;
-		}
 		memmove(deleted + 1, deleted, sizeof(SQLLEN) * (dl_count - i));
 		memmove(deleted_keyset + 1, deleted_keyset, sizeof(KeySet) * (dl_count - i));
 	}
@@ -2515,12 +2574,14 @@ MYLOG(DETAIL_LOG_LEVEL, "entering " FORMAT_ULEN "\n", index);
 static void
 RemoveDeleted(QResultClass *res, SQLLEN index)
 {
-	int	i, mv_count, rm_count = 0;
-	SQLLEN	pidx, midx;
+	int	rm_count = 0;
+	SQLLEN	i, mv_count, pidx, midx, target;
 	SQLLEN	*deleted, num_read = QR_get_num_total_read(res);
 	KeySet	*deleted_keyset;
 
 	MYLOG(0, "entering index=" FORMAT_LEN "\n", index);
+	if (!res->deleted)
+		return;
 	if (index < 0)
 	{
 		midx = index;
@@ -2534,10 +2595,10 @@ RemoveDeleted(QResultClass *res, SQLLEN index)
 		else
 			midx = index;
 	}
-	for (i = 0; i < res->dl_count; i++)
+	/* midx <= pidx */
+	for (target = midx;; target = pidx)
 	{
-		if (pidx == res->deleted[i] ||
-		    midx == res->deleted[i])
+		for (i = QR_search_deleted(res, target); i < (SQLLEN) res->dl_count && target == res->deleted[i];)
 		{
 			mv_count = res->dl_count - i - 1;
 			if (mv_count > 0)
@@ -2550,6 +2611,8 @@ RemoveDeleted(QResultClass *res, SQLLEN index)
 			res->dl_count--;
 			rm_count++;
 		}
+		if (target == pidx)
+			break;
 	}
 	MYLOG(0, "removed count=%d,%d\n", rm_count, res->dl_count);
 }
@@ -2557,7 +2620,7 @@ RemoveDeleted(QResultClass *res, SQLLEN index)
 static void
 CommitDeleted(QResultClass *res)
 {
-	int	i;
+	UInt4	i;
 	SQLLEN	*deleted;
 	KeySet	*deleted_keyset;
 	UWORD	status;
@@ -2585,16 +2648,16 @@ CommitDeleted(QResultClass *res)
 		}
 		if (status != deleted_keyset->status)
 		{
-MYLOG(DETAIL_LOG_LEVEL, "Deleted=" FORMAT_LEN "(%d)\n", *deleted, i);
+MYLOG(DETAIL_LOG_LEVEL, "Deleted=" FORMAT_LEN "(%u)\n", *deleted, i);
 			deleted_keyset->status = status;
 		}
 	}
 }
 
 static BOOL
-enlargeUpdated(QResultClass *res, Int4 number, const StatementClass *stmt)
+enlargeUpdated(QResultClass *res, UInt4 number, const StatementClass *stmt)
 {
-	Int2	alloc;
+	UInt4	alloc;
 
 	alloc = res->up_alloc;
 	if (0 == alloc)
@@ -2616,6 +2679,94 @@ enlargeUpdated(QResultClass *res, Int4 number, const StatementClass *stmt)
 	return TRUE;
 }
 
+/*
+ *	updated_hash maps a row index to the position of its last updated
+ *	info so that bookmarks are resolved without scanning the updated
+ *	info.  It's made on demand, kept while updated info is appended
+ *	and dropped when updated info is removed.
+ */
+#define	UPDATED_HASH(index, mask)	(((UInt4) (index) * 2654435761U) & (mask))
+
+static void
+DropUpdatedHash(QResultClass *res)
+{
+	if (res->updated_hash)
+	{
+		free(res->updated_hash);
+		res->updated_hash = NULL;
+	}
+	res->uh_mask = 0;
+}
+
+static void
+AddUpdatedHash(QResultClass *res, UInt4 up_idx)
+{
+	SQLLEN	*hash = res->updated_hash, index;
+	UInt4	l;
+
+	if (!hash)
+		return;
+	/* keep the load factor under 1/2 */
+	if ((up_idx + 1) * 2 > res->uh_mask + 1)
+	{
+		DropUpdatedHash(res);
+		return;
+	}
+	index = res->updated[up_idx];
+	for (l = UPDATED_HASH(index, res->uh_mask); hash[l] >= 0; l = (l + 1) & res->uh_mask)
+	{
+		if (res->updated[hash[l]] == index)
+			break;
+	}
+	hash[l] = up_idx;
+}
+
+static BOOL
+MakeUpdatedHash(QResultClass *res)
+{
+	UInt4	size, i;
+
+	/* leave room for the updates to come */
+	for (size = 64; size < res->up_count * 4; size <<= 1)
+		;
+	if (NULL == (res->updated_hash = malloc(sizeof(SQLLEN) * size)))
+		return FALSE;
+	res->uh_mask = size - 1;
+	for (i = 0; i < size; i++)
+		res->updated_hash[i] = -1;
+	for (i = 0; i < res->up_count; i++)
+		AddUpdatedHash(res, i);
+	return TRUE;
+}
+
+/*
+ *	The position of the last updated info of the row index, or -1.
+ */
+static SQLLEN
+SearchUpdated(QResultClass *res, SQLLEN index)
+{
+	SQLLEN	i;
+	UInt4	l;
+
+	if (0 == res->up_count || NULL == res->updated)
+		return -1;
+	if (NULL != res->updated_hash || MakeUpdatedHash(res))
+	{
+		for (l = UPDATED_HASH(index, res->uh_mask); (i = res->updated_hash[l]) >= 0; l = (l + 1) & res->uh_mask)
+		{
+			if (res->updated[i] == index)
+				return i;
+		}
+		return -1;
+	}
+	for (i = (SQLLEN) res->up_count - 1; i >= 0; i--)
+	{
+		if (res->updated[i] == index)
+			return i;
+	}
+	return -1;
+}
+
 static void
 AddUpdated(StatementClass *stmt, SQLLEN index, const KeySet *keyset, const TupleField *tuple_updated)
 {
@@ -2624,11 +2775,10 @@ AddUpdated(StatementClass *stmt, SQLLEN index, const KeySet *keyset, const Tuple
 	KeySet	*updated_keyset;
 	TupleField	*updated_tuples = NULL,  *tuple;
 	/* SQLLEN	res_ridx; */
-	UInt2	up_count;
+	UInt4	up_count;
 	BOOL	is_in_trans;
 	SQLLEN	upd_idx, upd_add_idx;
 	Int2	num_fields;
-	int	i;
 	UWORD	status;
 
 MYLOG(DETAIL_LOG_LEVEL, "entering index=" FORMAT_LEN "\n", index);
@@ -2658,14 +2808,7 @@ MYLOG(DETAIL_LOG_LEVEL, "entering index=" FORMAT_LEN "\n", index);
 		status |= CURS_SELF_UPDATING;
 	else
 	{
-		for (i = up_count - 1; i >= 0; i--)
-		{
-			if (updated[i] == index)
-				break;
-		}
-		if (i >= 0)
-			upd_idx = i;
-		else
+		if (upd_idx = SearchUpdated(res, index), upd_idx < 0)
 		{
 			SQLLEN	num_totals = QR_get_num_total_tuples(res);
 			if (index >= num_totals)
@@ -2712,6 +2855,7 @@ MYLOG(DETAIL_LOG_LEVEL, "entering index=" FORMAT_LEN "\n", index);
 			pg_memset(tuple, 0, sizeof(TupleField) * num_fields);
 		}
 		res->up_count++;
+		AddUpdatedHash(res, up_count);
 	}
 
 	if (tuple)
@@ -2780,6 +2924,8 @@ RemoveUpdatedAfterTheKey(QResultClass *res, SQLLEN index, const KeySet *keyset)
 			rm_count++;
 		}
 	}
+	if (rm_count > 0)
+		DropUpdatedHash(res);
 	MYLOG(0, "removed count=%d,%d\n", rm_count, res->up_count);
 }
 
@@ -3092,12 +3238,11 @@ ProcessRollback(ConnectionClass *conn, BOOL undo, BOOL partial)
 
 #define	LATEST_TUPLE_LOAD	1L
 #define	USE_INSERTED_TID	(1L << 1)
-static QResultClass *
-positioned_load(StatementClass *stmt, UInt4 flag, const UInt4 *oidint, const char *tidval)
+static BOOL
+positioned_load_query(StatementClass *stmt, UInt4 flag, const UInt4 *oidint, const char *tidval, PQExpBuffer selstr)
 {
 	CSTR	func = "positioned_load";
-	QResultClass *qres = NULL;
-	PQExpBufferData	selstr = {0};
+	BOOL	ret = FALSE;
 	BOOL	latest = ((flag & LATEST_TUPLE_LOAD) != 0);
 	TABLE_INFO	*ti = stmt->ti[0];
 	const char *bestqual = GET_NAME(ti->bestqual);
@@ -3105,7 +3250,6 @@ positioned_load(StatementClass *stmt, UInt4 flag, const UInt4 *oidint, const cha
 	const char *load_stmt = stmt->load_statement;
 
 MYLOG(DETAIL_LOG_LEVEL, "entering bestitem=%s bestqual=%s\n", SAFE_NAME(ti->bestitem), SAFE_NAME(ti->bestqual));
-	initPQExpBuffer(&selstr);
 #define	return	DONT_CALL_RETURN_FROM_HERE???
 	if (TI_has_subclass(ti))
 	{
@@ -3118,7 +3262,7 @@ MYLOG(DETAIL_LOG_LEVEL, "entering bestitem=%s bestqual=%s\n", SAFE_NAME(ti->best
 		{
 			if (latest)
 			{
-				printfPQExpBuffer(&selstr,
+				appendPQExpBuffer(selstr,
 					 "%.*sfrom %s where ctid = (select currtid2('%s', '%s'))",
 					 (int) from_pos, load_stmt,
 					 quoted_table,
@@ -3126,10 +3270,10 @@ MYLOG(DETAIL_LOG_LEVEL, "entering bestitem=%s bestqual=%s\n", SAFE_NAME(ti->best
 					 tidval);
 			}
 			else
-				printfPQExpBuffer(&selstr, "%.*sfrom %s where ctid = '%s'", (int) from_pos, load_stmt, quoted_table, tidval);
+				appendPQExpBuffer(selstr, "%.*sfrom %s where ctid = '%s'", (int) from_pos, load_stmt, quoted_table, tidval);
 		}
 		else if ((flag & USE_INSERTED_TID) != 0)
-			printfPQExpBuffer(&selstr, "%.*sfrom %s where ctid = (select currtid(0, '(0,0)'))", (int) from_pos, load_stmt, quoted_table);
+			appendPQExpBuffer(selstr, "%.*sfrom %s where ctid = (select currtid(0, '(0,0)'))", (int) from_pos, load_stmt, quoted_table);
 		/*
 		else if (bestitem && oidint)
 		{
@@ -3152,21 +3296,21 @@ MYLOG(DETAIL_LOG_LEVEL, "entering bestitem=%s bestqual=%s\n", SAFE_NAME(ti->best
 			{
 				char table_fqn[256];
 
-				printfPQExpBuffer(&selstr,
+				appendPQExpBuffer(selstr,
 					 "%s where ctid = (select currtid2('%s', '%s'))",
 					 load_stmt,
 					 ti_quote(stmt, 0, table_fqn, sizeof(table_fqn)),
 					 tidval);
 			}
 			else
-				printfPQExpBuffer(&selstr, "%s where ctid = '%s'", load_stmt, tidval);
+				appendPQExpBuffer(selstr, "%s where ctid = '%s'", load_stmt, tidval);
 		}
 		else if ((flag & USE_INSERTED_TID) != 0)
-			printfPQExpBuffer(&selstr, "%s where ctid = (select currtid(0, '(0,0)'))", load_stmt);
+			appendPQExpBuffer(selstr, "%s where ctid = (select currtid(0, '(0,0)'))", load_stmt);
 		else if (bestqual)
 		{
 			andExist = FALSE;
-			printfPQExpBuffer(&selstr, "%s where ", load_stmt);
+			appendPQExpBuffer(selstr, "%s where ", load_stmt);
 		}
 		else
 		{
@@ -3176,61 +3320,153 @@ MYLOG(DETAIL_LOG_LEVEL, "entering bestitem=%s bestqual=%s\n", SAFE_NAME(ti->best
 		if (bestqual && oidint)
 		{
 			if (andExist)
-				appendPQExpBufferStr(&selstr, andqual);
-			appendPQExpBuffer(&selstr, bestqual, *oidint);
+				appendPQExpBufferStr(selstr, andqual);
+			appendPQExpBuffer(selstr, bestqual, *oidint);
 		}
 	}
 
-	if (PQExpBufferDataBroken(selstr))
+	if (PQExpBufferDataBroken(*selstr))
 	{
 		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Could not allocate memory positioned_load()", func);
 		goto cleanup;
 	}
-	MYLOG(0, "selstr=%s\n", selstr.data);
-	qres = CC_send_query(SC_get_conn(stmt), selstr.data, NULL, READ_ONLY_QUERY, stmt);
+	ret = TRUE;
 cleanup:
 #undef	return
+	return ret;
+}
+
+static QResultClass *
+positioned_load(StatementClass *stmt, UInt4 flag, const UInt4 *oidint, const char *tidval)
+{
+	QResultClass *qres = NULL;
+	PQExpBufferData	selstr = {0};
+
+	initPQExpBuffer(&selstr);
+	if (positioned_load_query(stmt, flag, oidint, tidval, &selstr))
+	{
+		MYLOG(0, "selstr=%s\n", selstr.data);
+		qres = CC_send_query(SC_get_conn(stmt), selstr.data, NULL, READ_ONLY_QUERY, stmt);
+	}
 	if (!PQExpBufferDataBroken(selstr))
 		termPQExpBuffer(&selstr);
 	return qres;
 }
 
-BOOL QR_get_last_bookmark(const QResultClass *res, Int4 index, KeySet *keyset)
+BOOL QR_get_last_bookmark(QResultClass *res, Int4 index, KeySet *keyset)
 {
-	int	i;
+	SQLLEN	i;
 
 	if (res->dl_count > 0 && res->deleted)
 	{
-		for (i = 0; i < res->dl_count; i++)
+		i = QR_search_deleted(res, index);
+		if (i < (SQLLEN) res->dl_count && res->deleted[i] == index)
+		{
+			*keyset = res->deleted_keyset[i];
+			return TRUE;
+		}
+	}
+	if (i = SearchUpdated(res, index), i >= 0)
+	{
+		*keyset = res->updated_keyset[i];
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/*
+ *	Apply the row reloaded by positioned_load() to the rowset.
+ */
+static RETCODE
+pos_reload_result(StatementClass *stmt, QResultClass *res, SQLULEN global_ridx, SQLLEN kres_ridx, BOOL idx_exist, Int4 logKind, const KeySet *keyset, const char *tidval, QResultClass *qres, UInt2 *count)
+{
+	CSTR		func = "pos_reload_result";
+	int		res_cols = getNumResultCols(res);
+	UInt2		rcnt = 0;
+	RETCODE		ret;
+	BOOL		valid_key = TRUE;
+
+	if (!QR_command_maybe_successful(qres))
+	{
+		ret = SQL_ERROR;
+		SC_replace_error_with_res(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "positioned_load failed", qres, TRUE);
+	}
+	else if (rcnt = (UInt2) QR_get_num_cached_tuples(qres), rcnt == 1)
+	{
+		SQLLEN		res_ridx;
+
+		switch (logKind)
+		{
+			case 0:
+			case SQL_FETCH_BY_BOOKMARK:
+				break;
+			case SQL_UPDATE:
+				AddUpdated(stmt, global_ridx, keyset, qres->tupleField);
+				break;
+			default:
+				AddRollback(stmt, res, global_ridx, keyset, logKind);
+		}
+		res_ridx = GIdx2CacheIdx(global_ridx, stmt, res);
+		if (res_ridx >= 0 && res_ridx < QR_get_num_cached_tuples(res))
 		{
-			if (res->deleted[i] == index)
+			TupleField *tuple_old, *tuple_new;
+			int	effective_fields = res_cols;
+			UInt4	blocknum;
+			UInt2	offset;
+			char	newtid[32];
+
+			tuple_old = res->backend_tuples + res->num_fields * res_ridx;
+
+			QR_set_position(qres, 0);
+			tuple_new = qres->tupleField;
+			/* tidval is formatted as "(%u, %u)" */
+			if (SQL_CURSOR_KEYSET_DRIVEN == stmt->options.cursor_type &&
+				parse_tid(tuple_new[qres->num_fields - res->num_key_fields].value, &blocknum, &offset))
 			{
-				*keyset = res->deleted_keyset[i];
-				return TRUE;
+				SPRINTF_FIXED(newtid, "(%u, %u)", blocknum, offset);
+				if (strcmp(newtid, tidval))
+					res->keyset[kres_ridx].status |= SQL_ROW_UPDATED;
 			}
-			if (res->deleted[i] > index)
-				break;
+			if (!KeySetSet(tuple_new, qres->num_fields, res->num_key_fields, res->keyset + kres_ridx, FALSE))
+				valid_key = FALSE;
+			else
+				MoveCachedRows(tuple_old, tuple_new, effective_fields, 1);
+		}
+		if (!valid_key)
+		{
+			ret = SQL_ERROR;
+			SC_set_error(stmt, STMT_INTERNAL_ERROR, "the reloaded row has an invalid ctid", func);
+		}
+		else if (rcnt > 1)
+		{
+			ret = SQL_SUCCESS_WITH_INFO;
+			SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "more than one row were update/deleted?", func);
 		}
+		else
+			ret = SQL_SUCCESS;
 	}
-	if (res->up_count > 0 && res->updated)
+	else
 	{
-		for (i = res->up_count - 1; i >= 0; i--)
+		SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the content was deleted after last fetch", func);
+		ret = SQL_SUCCESS_WITH_INFO;
+		AddRollback(stmt, res, global_ridx, keyset, logKind);
+		if (idx_exist)
 		{
-			if (res->updated[i] == index)
+			if (stmt->options.cursor_type == SQL_CURSOR_KEYSET_DRIVEN)
 			{
-				*keyset = res->updated_keyset[i];
-				return TRUE;
+				res->keyset[kres_ridx].status |= SQL_ROW_DELETED;
 			}
 		}
 	}
-	return FALSE;
+	if (count)
+		*count = rcnt;
+	return ret;
 }
 
 static RETCODE
 SC_pos_reload_with_key(StatementClass *stmt, SQLULEN global_ridx, UInt2 *count, Int4 logKind, const KeySet *keyset)
 {
 	CSTR		func = "SC_pos_reload_with_key";
-	int		res_cols;
 	UInt2		rcnt;
 	SQLLEN		kres_ridx;
 	OID		oidint;
@@ -3295,7 +3531,6 @@ SC_pos_reload_with_key(StatementClass *stmt, SQLULEN global_ridx, UInt2 *count,
 		getTid(res, kres_ridx, &blocknum, &offset);
 		SPRINTF_FIXED(tidval, "(%u, %u)", blocknum, offset);
 	}
-	res_cols = getNumResultCols(res);
 	if (keyset) /* after or update */
 	{
 		char tid[32];
@@ -3312,63 +3547,7 @@ SC_pos_reload_with_key(StatementClass *stmt, SQLULEN global_ridx, UInt2 *count,
 			qres = positioned_load(stmt, 0, &oidint, NULL);
 		keyset = res->keyset + kres_ridx;
 	}
-	if (!QR_command_maybe_successful(qres))
-	{
-		ret = SQL_ERROR;
-		SC_replace_error_with_res(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "positioned_load failed", qres, TRUE);
-	}
-	else if (rcnt = (UInt2) QR_get_num_cached_tuples(qres), rcnt == 1)
-	{
-		SQLLEN		res_ridx;
-
-		switch (logKind)
-		{
-			case 0:
-			case SQL_FETCH_BY_BOOKMARK:
-				break;
-			case SQL_UPDATE:
-				AddUpdated(stmt, global_ridx, keyset, qres->tupleField);
-				break;
-			default:
-				AddRollback(stmt, res, global_ridx, keyset, logKind);
-		}
-		res_ridx = GIdx2CacheIdx(global_ridx, stmt, res);
-		if (res_ridx >= 0 && res_ridx < QR_get_num_cached_tuples(res))
-		{
-			TupleField *tuple_old, *tuple_new;
-			int	effective_fields = res_cols;
-
-			tuple_old = res->backend_tuples + res->num_fields * res_ridx;
-
-			QR_set_position(qres, 0);
-			tuple_new = qres->tupleField;
-			if (SQL_CURSOR_KEYSET_DRIVEN == stmt->options.cursor_type &&
-				strcmp(tuple_new[qres->num_fields - res->num_key_fields].value, tidval))
-				res->keyset[kres_ridx].status |= SQL_ROW_UPDATED;
-			KeySetSet(tuple_new, qres->num_fields, res->num_key_fields, res->keyset + kres_ridx, FALSE);
-			MoveCachedRows(tuple_old, tuple_new, effective_fields, 1);
-		}
-		if (rcnt > 1)
-		{
-			ret = SQL_SUCCESS_WITH_INFO;
-			SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "more than one row were update/deleted?", func);
-		}
-		else
-			ret = SQL_SUCCESS;
-	}
-	else
-	{
-		SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the content was deleted after last fetch", func);
-		ret = SQL_SUCCESS_WITH_INFO;
-		AddRollback(stmt, res, global_ridx, keyset, logKind);
-		if (idx_exist)
-		{
-			if (stmt->options.cursor_type == SQL_CURSOR_KEYSET_DRIVEN)
-			{
-				res->keyset[kres_ridx].status |= SQL_ROW_DELETED;
-			}
-		}
-	}
+	ret = pos_reload_result(stmt, res, global_ridx, kres_ridx, idx_exist, logKind, keyset, tidval, qres, &rcnt);
 	QR_Destructor(qres);
 	if (count)
 		*count = rcnt;
@@ -3383,177 +3562,141 @@ SC_pos_reload(StatementClass *stmt, SQLULEN global_ridx, UInt2 *count, Int4 logK
 }
 
 static	const int	pre_fetch_count = 32;
-static SQLLEN LoadFromKeyset(StatementClass *stmt, QResultClass * res, int rows_per_fetch, SQLLEN limitrow)
+
+static UInt4 keyset_hash(UInt4 blocknum, UInt2 offset, OID oid)
+{
+	UInt4	h = blocknum * 0x9E3779B1U;
+
+	h ^= (offset + (h << 6) + (h >> 2));
+	return h ^ (oid * 0x85EBCA6BU);
+}
+
+/*
+ *	Reload the rows marked CURS_NEEDS_REREAD in the rowset.
+ *	All the ctids are sent as one tid array parameter of the prepared
+ *	statement "_KEYSET_%p" and each row returned is mapped back to the
+ *	rowset via a hash on (blocknum, offset, oid).
+ */
+static SQLLEN LoadFromKeyset(StatementClass *stmt, QResultClass * res, SQLLEN limitrow)
 {
 	CSTR	func = "LoadFromKeyset";
 	ConnectionClass	*conn = SC_get_conn(stmt);
-	SQLLEN	i;
-	int	j, rowc, rcnt = 0;
-	OID	oid;
-	UInt4	blocknum;
-	SQLLEN	kres_ridx;
-	UInt2	offset;
-	PQExpBufferData	qval = {0};
-	int	keys_per_fetch = 10;
+	SQLLEN	i, j, k, l, kres_ridx, kres_offset = 0;
+	SQLLEN	*kidx = NULL, *hash = NULL;
+	int	rcnt = 0;
+	UInt4	hmask;
+	Int2	m;
+	char	planname[32];
+	QResultClass	*qres = NULL;
+	TupleField	*tuple, *tuplew;
+	const KeySet	*keyr;
 
 #define	return	DONT_CALL_RETURN_FROM_HERE???
-	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res), rowc = 0;; i++, kres_ridx++)
+	if (limitrow <= SC_get_rowset_start(stmt))
+		goto cleanup;
+	if (NULL == (kidx = malloc(sizeof(SQLLEN) * (limitrow - SC_get_rowset_start(stmt)))))
 	{
-		if (i >= limitrow)
-		{
-			if (!rowc)
-				break;
-			if (res->reload_count > 0)
-			{
-				for (j = rowc; j < keys_per_fetch; j++)
-				{
-					appendPQExpBufferStr(&qval, j ? ",NULL" : "NULL");
-				}
-			}
-			rowc = -1; /* end of loop */
-		}
-		if (rowc < 0 || rowc >= keys_per_fetch)
-		{
-			QResultClass	*qres;
+		rcnt = -1;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
+		goto cleanup;
+	}
+	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res); i < limitrow; i++, kres_ridx++)
+	{
+		if (0 != (res->keyset[kres_ridx].status & CURS_NEEDS_REREAD))
+			kidx[rcnt++] = kres_ridx;
+		kres_offset = i - kres_ridx;
+	}
+	if (0 == rcnt)
+		goto cleanup;
 
-			appendPQExpBufferStr(&qval, ")");
-			if (PQExpBufferDataBroken(qval))
-			{
-				rcnt = -1;
-				SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
-				goto cleanup;
-			}
-			qres = CC_send_query(conn, qval.data, NULL, CREATE_KEYSET | READ_ONLY_QUERY, stmt);
-			if (QR_command_maybe_successful(qres))
-			{
-				SQLLEN		j, k, l;
-				Int2		m;
-				TupleField	*tuple, *tuplew;
-				UInt4		bln;
-				UInt2		off;
+	SPRINTF_FIXED(planname, "_KEYSET_%p", res);
+	if (res->reload_count <= 0)
+	{
+		PQExpBufferData	qval = {0};
+		Oid	paramType = PG_TYPE_TIDARRAY;
+		BOOL	prepared;
 
-				for (j = 0; j < QR_get_num_total_read(qres); j++)
-				{
-					oid = getOid(qres, j);
-					getTid(qres, j, &blocknum, &offset);
-					for (k = SC_get_rowset_start(stmt); k < limitrow; k++)
-					{
-						getTid(res, k, &bln, &off);
-						if (oid == getOid(res, k) &&
-						    bln == blocknum &&
-						    off == offset)
-						{
-							l = GIdx2CacheIdx(k, stmt, res);
-							tuple = res->backend_tuples + res->num_fields * l;
-							tuplew = qres->backend_tuples + qres->num_fields * j;
-							for (m = 0; m < res->num_fields; m++, tuple++, tuplew++)
-							{
-								if (tuple->len > 0 && tuple->value)
-									free(tuple->value);
-								tuple->value = tuplew->value;
-								tuple->len = tuplew->len;
-								tuplew->value = NULL;
-								tuplew->len = -1;
-							}
-							res->keyset[k].status &= ~CURS_NEEDS_REREAD;
-							break;
-						}
-					}
-				}
-			}
-			else
-			{
-				SC_set_error(stmt, STMT_EXEC_ERROR, "Data Load Error", func);
-				rcnt = -1;
-				QR_Destructor(qres);
-				break;
-			}
-			QR_Destructor(qres);
-			if (rowc < 0)
-				break;
-			rowc = 0;
+		initPQExpBuffer(&qval);
+		printfPQExpBuffer(&qval, "%s where ctid = ANY($1::tid[])", stmt->load_statement);
+		if (PQExpBufferDataBroken(qval))
+		{
+			rcnt = -1;
+			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
+			goto cleanup;
 		}
-		if (!rowc)
+		prepared = CC_prepare_query(conn, planname, qval.data, 1, &paramType);
+		termPQExpBuffer(&qval);
+		if (!prepared)
 		{
-			if (PQExpBufferDataBroken(qval))
-			{
-				initPQExpBuffer(&qval);
+			SC_set_error(stmt, STMT_EXEC_ERROR, "Prepare for Data Load Error", func);
+			rcnt = -1;
+			goto cleanup;
+		}
+		res->reload_count = 1;
+	}
+	qres = CC_send_tid_array(conn, planname, res->keyset, kidx, rcnt, CREATE_KEYSET, stmt);
+	if (!QR_command_maybe_successful(qres))
+	{
+		SC_set_error(stmt, STMT_EXEC_ERROR, "Data Load Error", func);
+		rcnt = -1;
+		goto cleanup;
+	}
 
-				if (res->reload_count > 0)
-					keys_per_fetch = res->reload_count;
-				else
-				{
-					char	planname[32];
-					int	j;
-					QResultClass	*qres;
+	/* open addressing hash of kidx, the size is a power of 2 */
+	for (hmask = 1; hmask < (UInt4) rcnt * 2; hmask <<= 1)
+		;
+	if (NULL == (hash = malloc(sizeof(SQLLEN) * hmask)))
+	{
+		rcnt = -1;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
+		goto cleanup;
+	}
+	for (l = 0; l < (SQLLEN) hmask; l++)
+		hash[l] = -1;
+	hmask--;
+	for (j = 0; j < rcnt; j++)
+	{
+		keyr = res->keyset + kidx[j];
+		for (l = keyset_hash(keyr->blocknum, keyr->offset, keyr->oid) & hmask; hash[l] >= 0; l = (l + 1) & hmask)
+			;
+		hash[l] = j;
+	}
 
-					if (rows_per_fetch >= pre_fetch_count * 2)
-						keys_per_fetch = pre_fetch_count;
-					else
-						keys_per_fetch = rows_per_fetch;
-					if (!keys_per_fetch)
-						keys_per_fetch = 2;
-					SPRINTF_FIXED(planname, "_KEYSET_%p", res);
-					printfPQExpBuffer(&qval, "PREPARE \"%s\"", planname);
-					for (j = 0; j < keys_per_fetch; j++)
-					{
-						appendPQExpBufferStr(&qval, j ? ",tid" : "(tid");
-					}
-					appendPQExpBuffer(&qval, ") as %s where ctid in ", stmt->load_statement);
-					for (j = 0; j < keys_per_fetch; j++)
-					{
-						if (j == 0)
-							appendPQExpBufferStr(&qval, "($1");
-						else
-							appendPQExpBuffer(&qval, ",$%d", j + 1);
-					}
-					appendPQExpBufferStr(&qval, ")");
-					if (PQExpBufferDataBroken(qval))
-					{
-						rcnt = -1;
-						SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
-						goto cleanup;
-					}
-					qres = CC_send_query(conn, qval.data, NULL, READ_ONLY_QUERY, stmt);
-					if (QR_command_maybe_successful(qres))
-					{
-						res->reload_count = keys_per_fetch;
-					}
-					else
-					{
-						SC_set_error(stmt, STMT_EXEC_ERROR, "Prepare for Data Load Error", func);
-						rcnt = -1;
-						SC_set_Result(stmt, qres);
-						break;
-					}
-					QR_Destructor(qres);
-				}
-			}
-			if (res->reload_count > 0)
-			{
-				printfPQExpBuffer(&qval, "EXECUTE \"_KEYSET_%p\"(", res);
-			}
-			else
-			{
-				printfPQExpBuffer(&qval, "%s where ctid in (", stmt->load_statement);
-			}
+	for (j = 0; j < QR_get_num_total_read(qres); j++)
+	{
+		const KeySet	*keyw = qres->keyset + j;
+
+		for (l = keyset_hash(keyw->blocknum, keyw->offset, keyw->oid) & hmask; hash[l] >= 0; l = (l + 1) & hmask)
+		{
+			k = kidx[hash[l]];
+			keyr = res->keyset + k;
+			if (keyr->oid == keyw->oid &&
+			    keyr->blocknum == keyw->blocknum &&
+			    keyr->offset == keyw->offset)
+				break;
 		}
-		if (rcnt >= 0 &&
-		    0 != (res->keyset[kres_ridx].status & CURS_NEEDS_REREAD))
+		if (hash[l] < 0)
+			continue;
+		tuple = res->backend_tuples + res->num_fields * GIdx2CacheIdx(k + kres_offset, stmt, res);
+		tuplew = qres->backend_tuples + qres->num_fields * j;
+		for (m = 0; m < res->num_fields; m++, tuple++, tuplew++)
 		{
-			getTid(res, kres_ridx, &blocknum, &offset);
-			if (rowc)
-				appendPQExpBuffer(&qval, ",'(%u,%u)'", blocknum, offset);
-			else
-				appendPQExpBuffer(&qval, "'(%u,%u)'", blocknum, offset);
-			rowc++;
-			rcnt++;
+			if (tuple->len > 0 && tuple->value)
+				free(tuple->value);
+			tuple->value = tuplew->value;
+			tuple->len = tuplew->len;
+			tuplew->value = NULL;
+			tuplew->len = -1;
 		}
+		res->keyset[k].status &= ~CURS_NEEDS_REREAD;
 	}
 cleanup:
 #undef	return
-	if (!PQExpBufferDataBroken(qval))
-		termPQExpBuffer(&qval);
+	QR_Destructor(qres);
+	if (hash)
+		free(hash);
+	if (kidx)
+		free(kidx);
 	return rcnt;
 }
 
@@ -3763,7 +3906,7 @@ SC_pos_reload_needed(StatementClass *stmt, SQLULEN req_size, UDWORD flag)
 			goto cleanup;
 		}
 	}
-	else if (rowc = LoadFromKeyset(stmt, res, rows_per_fetch, limitrow), rowc < 0)
+	else if (rowc = LoadFromKeyset(stmt, res, limitrow), rowc < 0)
 	{
 		goto cleanup;
 	}
@@ -3791,30 +3934,16 @@ cleanup:
 	return ret;
 }
 
-static RETCODE	SQL_API
-SC_pos_newload(StatementClass *stmt, const UInt4 *oidint, BOOL tidRef,
-			   const char *tidval)
+/*
+ *	Append the row reloaded after an insert to the keyset and the cache.
+ */
+static RETCODE
+pos_newload_result(StatementClass *stmt, QResultClass *res, QResultClass *qres)
 {
 	CSTR	func = "SC_pos_newload";
 	int			i;
-	QResultClass *res, *qres;
 	RETCODE		ret = SQL_ERROR;
 
-	MYLOG(0, "entering ti=%p\n", stmt->ti);
-	if (!(res = SC_get_Curres(stmt)))
-	{
-		SC_set_error(stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_pos_newload.", func);
-		return SQL_ERROR;
-	}
-	if (SC_update_not_ready(stmt))
-		parse_statement(stmt, TRUE);	/* not preferable */
-	if (!SC_is_updatable(stmt))
-	{
-		stmt->options.scroll_concurrency = SQL_CONCUR_READ_ONLY;
-		SC_set_error(stmt, STMT_INVALID_OPTION_IDENTIFIER, "the statement is read-only", func);
-		return SQL_ERROR;
-	}
-	qres = positioned_load(stmt, (tidRef && NULL == tidval) ? USE_INSERTED_TID : 0, oidint, tidRef ? tidval : NULL);
 	if (!qres || !QR_command_maybe_successful(qres))
 	{
 		SC_set_error(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "positioned_load in pos_newload failed", func);
@@ -3868,7 +3997,11 @@ QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_t
 					QR_REALLOC_return_with_error(res->keyset, KeySet, sizeof(KeySet) * tuple_size, res, "pos_newload failed", SQL_ERROR);
 					res->count_keyset_allocated = tuple_size;
 				}
-				KeySetSet(tuple_new, qres->num_fields, res->num_key_fields, res->keyset + kres_ridx, TRUE);
+				if (!KeySetSet(tuple_new, qres->num_fields, res->num_key_fields, res->keyset + kres_ridx, TRUE))
+				{
+					SC_set_error(stmt, STMT_INTERNAL_ERROR, "the added row has an invalid ctid", func);
+					return SQL_ERROR;
+				}
 				res->num_cached_keys++;
 			}
 			if (appendData)
@@ -3906,6 +4039,33 @@ QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_t
 		}
 		/* stmt->currTuple = SC_get_rowset_start(stmt) + ridx; */
 	}
+	return ret;
+}
+
+static RETCODE	SQL_API
+SC_pos_newload(StatementClass *stmt, const UInt4 *oidint, BOOL tidRef,
+			   const char *tidval)
+{
+	CSTR	func = "SC_pos_newload";
+	QResultClass *res, *qres;
+	RETCODE		ret;
+
+	MYLOG(0, "entering ti=%p\n", stmt->ti);
+	if (!(res = SC_get_Curres(stmt)))
+	{
+		SC_set_error(stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_pos_newload.", func);
+		return SQL_ERROR;
+	}
+	if (SC_update_not_ready(stmt))
+		parse_statement(stmt, TRUE);	/* not preferable */
+	if (!SC_is_updatable(stmt))
+	{
+		stmt->options.scroll_concurrency = SQL_CONCUR_READ_ONLY;
+		SC_set_error(stmt, STMT_INVALID_OPTION_IDENTIFIER, "the statement is read-only", func);
+		return SQL_ERROR;
+	}
+	qres = positioned_load(stmt, (tidRef && NULL == tidval) ? USE_INSERTED_TID : 0, oidint, tidRef ? tidval : NULL);
+	ret = pos_newload_result(stmt, res, qres);
 	QR_Destructor(qres);
 	return ret;
 }
@@ -3932,8 +4092,9 @@ irow_update(RETCODE ret, StatementClass *stmt, StatementClass *ustmt, SQLULEN gl
 				if (NULL != tres->backend_tuples &&
 				    1 == QR_get_num_cached_tuples(tres))
 				{
-					KeySetSet(tres->backend_tuples, QR_NumResultCols(tres), QR_NumResultCols(tres), &keys, TRUE);
-					if (SQL_SUCCEEDED(ret = SC_pos_reload_with_key(stmt, global_ridx, (UInt2 *) 0, SQL_UPDATE, &keys)))
+					if (!KeySetSet(tres->backend_tuples, QR_NumResultCols(tres), QR_NumResultCols(tres), &keys, TRUE))
+						ret = SQL_ERROR;
+					else if (SQL_SUCCEEDED(ret = SC_pos_reload_with_key(stmt, global_ridx, (UInt2 *) 0, SQL_UPDATE, &keys)))
 						AddRollback(stmt, SC_get_Curres(stmt), global_ridx, old_keyset, SQL_UPDATE);
 				}
 				else
@@ -3959,111 +4120,271 @@ irow_update(RETCODE ret, StatementClass *stmt, StatementClass *ustmt, SQLULEN gl
 	return ret;
 }
 
-/* SQL_NEED_DATA callback for SC_pos_update */
-typedef struct
-{
-	BOOL		updyes;
-	QResultClass	*res;
-	StatementClass	*stmt, *qstmt;
-	IRDFields	*irdflds;
-	SQLSETPOSIROW		irow;
-	SQLULEN		global_ridx;
-	KeySet		old_keyset;
-}	pup_cdata;
+/*
+ *	Set the keyset status and the row status of an updated row.
+ */
 static RETCODE
-pos_update_callback(RETCODE retcode, void *para)
+pos_update_status(RETCODE ret, StatementClass *stmt, QResultClass *res, SQLSETPOSIROW irow, SQLULEN global_ridx)
 {
-	RETCODE	ret = retcode;
-	pup_cdata *s = (pup_cdata *) para;
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
 	SQLLEN	kres_ridx;
 	BOOL	idx_exist = TRUE;
 
-	if (s->updyes)
-	{
-		MYLOG(0, "entering\n");
-		ret = irow_update(ret, s->stmt, s->qstmt, s->global_ridx, &s->old_keyset);
-MYLOG(DETAIL_LOG_LEVEL, "irow_update ret=%d,%d\n", ret, SC_get_errornumber(s->qstmt));
-		if (ret != SQL_SUCCESS)
-			SC_error_copy(s->stmt, s->qstmt, TRUE);
-		PGAPI_FreeStmt(s->qstmt, SQL_DROP);
-		s->qstmt = NULL;
-	}
-	s->updyes = FALSE;
-	kres_ridx = GIdx2KResIdx(s->global_ridx, s->stmt, s->res);
-	if (kres_ridx < 0 || kres_ridx >= s->res->num_cached_keys)
+	kres_ridx = GIdx2KResIdx(global_ridx, stmt, res);
+	if (kres_ridx < 0 || kres_ridx >= res->num_cached_keys)
 	{
 		idx_exist = FALSE;
 	}
-	if (SQL_SUCCESS == ret && s->res->keyset && idx_exist)
+	if (SQL_SUCCESS == ret && res->keyset && idx_exist)
 	{
-		ConnectionClass	*conn = SC_get_conn(s->stmt);
+		ConnectionClass	*conn = SC_get_conn(stmt);
 
 		if (CC_is_in_trans(conn))
 		{
-			s->res->keyset[kres_ridx].status |= (SQL_ROW_UPDATED  | CURS_SELF_UPDATING);
+			res->keyset[kres_ridx].status |= (SQL_ROW_UPDATED  | CURS_SELF_UPDATING);
 		}
 		else
-			s->res->keyset[kres_ridx].status |= (SQL_ROW_UPDATED  | CURS_SELF_UPDATED);
+			res->keyset[kres_ridx].status |= (SQL_ROW_UPDATED  | CURS_SELF_UPDATED);
 	}
-	if (s->irdflds->rowStatusArray)
+	if (irdflds->rowStatusArray)
 	{
 		switch (ret)
 		{
 			case SQL_SUCCESS:
-				s->irdflds->rowStatusArray[s->irow] = SQL_ROW_UPDATED;
+				irdflds->rowStatusArray[irow] = SQL_ROW_UPDATED;
 				break;
 			case SQL_NO_DATA_FOUND:
 			case SQL_SUCCESS_WITH_INFO:
-				s->irdflds->rowStatusArray[s->irow] = SQL_ROW_SUCCESS_WITH_INFO;
+				irdflds->rowStatusArray[irow] = SQL_ROW_SUCCESS_WITH_INFO;
 				ret = SQL_SUCCESS_WITH_INFO;
 				break;
 			case SQL_ERROR:
 			default:
-				s->irdflds->rowStatusArray[s->irow] = SQL_ROW_ERROR;
+				irdflds->rowStatusArray[irow] = SQL_ROW_ERROR;
 		}
 	}
 
 	return ret;
 }
-RETCODE
-SC_pos_update(StatementClass *stmt,
-		  SQLSETPOSIROW irow, SQLULEN global_ridx, const KeySet *keyset)
+
+/* SQL_NEED_DATA callback for SC_pos_update */
+typedef struct
 {
-	CSTR	func = "SC_pos_update";
-	int			i,
-				num_cols,
-				upd_cols;
-	pup_cdata	s;
-	ConnectionClass	*conn;
-	ARDFields	*opts = SC_get_ARDF(stmt);
-	BindInfoClass *bindings = opts->bindings;
-	TABLE_INFO	*ti;
-	FIELD_INFO	**fi;
-	PQExpBufferData		updstr = {0};
-	RETCODE		ret = SQL_ERROR;
-	OID	oid;
-	UInt4	blocknum;
-	UInt2	pgoffset;
-	SQLLEN	offset;
-	SQLLEN	*used, kres_ridx;
-	Int4	bind_size = opts->bind_size;
-	BOOL	idx_exist = TRUE;
-	char	table_fqn[256];
+	BOOL		updyes;
+	QResultClass	*res;
+	StatementClass	*stmt, *qstmt;
+	IRDFields	*irdflds;
+	SQLSETPOSIROW		irow;
+	SQLULEN		global_ridx;
+	KeySet		old_keyset;
+}	pup_cdata;
+static RETCODE
+pos_update_callback(RETCODE retcode, void *para)
+{
+	RETCODE	ret = retcode;
+	pup_cdata *s = (pup_cdata *) para;
 
-	s.stmt = stmt;
-	s.irow = irow;
-	s.global_ridx = global_ridx;
-	s.irdflds = SC_get_IRDF(s.stmt);
-	fi = s.irdflds->fi;
-	if (!(s.res = SC_get_Curres(s.stmt)))
+	if (s->updyes)
 	{
-		SC_set_error(s.stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_pos_update.", func);
-		return SQL_ERROR;
+		MYLOG(0, "entering\n");
+		ret = irow_update(ret, s->stmt, s->qstmt, s->global_ridx, &s->old_keyset);
+MYLOG(DETAIL_LOG_LEVEL, "irow_update ret=%d,%d\n", ret, SC_get_errornumber(s->qstmt));
+		if (ret != SQL_SUCCESS)
+			SC_error_copy(s->stmt, s->qstmt, TRUE);
+		PGAPI_FreeStmt(s->qstmt, SQL_DROP);
+		s->qstmt = NULL;
 	}
-	MYLOG(0, "entering " FORMAT_POSIROW "+" FORMAT_LEN " fi=%p ti=%p\n", s.irow, QR_get_rowstart_in_cache(s.res), fi, s.stmt->ti);
-	if (SC_update_not_ready(stmt))
-		parse_statement(s.stmt, TRUE);	/* not preferable */
-	if (!SC_is_updatable(s.stmt))
+	s->updyes = FALSE;
+
+	return pos_update_status(ret, s->stmt, s->res, s->irow, s->global_ridx);
+}
+
+/*
+ *	Get the address of the bound value or the length/indicator
+ *	of the row irow.
+ */
+static SQLLEN *
+bound_used_of_row(const ARDFields *opts, const BindInfoClass *binding, SQLSETPOSIROW irow)
+{
+	SQLLEN	*used = binding->used;
+	SQLLEN	offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
+
+	if (NULL == used)
+		return NULL;
+	used = LENADDR_SHIFT(used, offset);
+	if (opts->bind_size > 0)
+		used = LENADDR_SHIFT(used, opts->bind_size * irow);
+	else
+		used = LENADDR_SHIFT(used, irow * sizeof(SQLLEN));
+	return used;
+}
+
+static char *
+bound_buffer_of_row(const ARDFields *opts, const BindInfoClass *binding, SQLSETPOSIROW irow)
+{
+	char	*buffer = binding->buffer;
+	SQLLEN	offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
+	SQLLEN	ctypelen;
+
+	if (NULL == buffer)
+		return NULL;
+	buffer += offset;
+	if (opts->bind_size > 0)
+		buffer += opts->bind_size * irow;
+	else if (ctypelen = ctype_length(binding->returntype), ctypelen > 0)
+		buffer += ctypelen * irow;
+	else
+		buffer += binding->buflen * irow;
+	return buffer;
+}
+
+/*
+ *	Append the UPDATE command for the row irow of the rowset to updstr.
+ *	Returns the number of the columns to update.
+ */
+static int
+pos_update_query(StatementClass *stmt, SQLSETPOSIROW irow, OID oid, UInt4 blocknum, UInt2 pgoffset, PQExpBuffer updstr, BOOL *data_at_exec)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	BindInfoClass	*bindings = opts->bindings;
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+	FIELD_INFO	**fi = irdflds->fi;
+	TABLE_INFO	*ti = stmt->ti[0];
+	int		i, num_cols, upd_cols;
+	SQLLEN		*used;
+	char		table_fqn[256];
+
+	appendPQExpBuffer(updstr,
+			 "update %s set", ti_quote(stmt, oid, table_fqn, sizeof(table_fqn)));
+
+	num_cols = irdflds->nfields;
+	for (i = upd_cols = 0; i < num_cols; i++)
+	{
+		if (used = bound_used_of_row(opts, bindings + i, irow), used != NULL)
+		{
+			MYLOG(0, "%d used=" FORMAT_LEN ",%p\n", i, *used, used);
+			if (*used != SQL_IGNORE && fi[i]->updatable)
+			{
+				if (upd_cols)
+					appendPQExpBuffer(updstr,
+								 ", \"%s\" = ?", GET_NAME(fi[i]->column_name));
+				else
+					appendPQExpBuffer(updstr,
+								 " \"%s\" = ?", GET_NAME(fi[i]->column_name));
+				upd_cols++;
+				if (*used == SQL_DATA_AT_EXEC || *used <= SQL_LEN_DATA_AT_EXEC_OFFSET)
+					*data_at_exec = TRUE;
+			}
+		}
+		else
+			MYLOG(0, "%d null bind\n", i);
+	}
+	if (upd_cols > 0)
+	{
+		const char *bestitem = GET_NAME(ti->bestitem);
+		const char *bestqual = GET_NAME(ti->bestqual);
+
+		appendPQExpBuffer(updstr,
+					 " where ctid = '(%u, %u)'",
+					 blocknum, pgoffset);
+		if (bestqual)
+		{
+			appendPQExpBuffer(updstr, " and ");
+			appendPQExpBuffer(updstr, bestqual, oid);
+		}
+		if (PG_VERSION_GE(conn, 8.2))
+		{
+			appendPQExpBuffer(updstr, " returning ctid");
+			if (bestitem)
+			{
+				appendPQExpBuffer(updstr, ", ");
+				appendPQExpBuffer(updstr, "\"%s\"", bestitem);
+			}
+		}
+	}
+
+	return upd_cols;
+}
+
+/*
+ *	Bind the columns to update or insert of the row irow as the parameters
+ *	pno + 1, pno + 2, ... of qstmt and return the last parameter number.
+ *	If row_addr is TRUE, the addresses of the row itself are bound.
+ *	Otherwise the rowset arrays are bound and the row is selected by
+ *	qstmt->exec_start_row.
+ */
+static int
+bind_pos_params(StatementClass *stmt, StatementClass *qstmt, SQLSETPOSIROW irow, int pno, BOOL row_addr)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	BindInfoClass	*bindings = opts->bindings;
+	FIELD_INFO	**fi = SC_get_IRDF(stmt)->fi;
+	IPDFields	*ipdopts = SC_get_IPDF(qstmt);
+	int		i, num_cols = SC_get_IRDF(stmt)->nfields;
+	int		unknown_sizes = conn->connInfo.drivers.unknown_sizes;
+	OID		fieldtype;
+	SQLLEN		*used;
+
+	for (i = 0; i < num_cols; i++)
+	{
+		if (used = bound_used_of_row(opts, bindings + i, irow), used != NULL)
+		{
+			MYLOG(0, "%d used=" FORMAT_LEN "\n", i, *used);
+			if (*used != SQL_IGNORE && fi[i]->updatable)
+			{
+				/* fieldtype = QR_get_field_type(s.res, i); */
+				fieldtype = getEffectiveOid(conn, fi[i]);
+				PIC_set_pgtype(ipdopts->parameters[pno], fieldtype);
+				PGAPI_BindParameter(qstmt,
+					(SQLUSMALLINT) ++pno,
+					SQL_PARAM_INPUT,
+					bindings[i].returntype,
+					pgtype_to_concise_type(stmt, fieldtype, i, unknown_sizes),
+															fi[i]->column_size > 0 ? fi[i]->column_size : pgtype_column_size(stmt, fieldtype, i, unknown_sizes),
+					(SQLSMALLINT) fi[i]->decimal_digits,
+					row_addr ? bound_buffer_of_row(opts, bindings + i, irow) : bindings[i].buffer,
+					bindings[i].buflen,
+					row_addr ? used : bindings[i].used);
+			}
+		}
+	}
+
+	return pno;
+}
+
+RETCODE
+SC_pos_update(StatementClass *stmt,
+		  SQLSETPOSIROW irow, SQLULEN global_ridx, const KeySet *keyset)
+{
+	CSTR	func = "SC_pos_update";
+	int			num_cols,
+				upd_cols;
+	pup_cdata	s;
+	ConnectionClass	*conn;
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	PQExpBufferData		updstr = {0};
+	RETCODE		ret = SQL_ERROR;
+	OID	oid;
+	UInt4	blocknum;
+	UInt2	pgoffset;
+	SQLLEN	kres_ridx;
+	BOOL	idx_exist = TRUE, data_at_exec = FALSE;
+
+	s.stmt = stmt;
+	s.irow = irow;
+	s.global_ridx = global_ridx;
+	s.irdflds = SC_get_IRDF(s.stmt);
+	if (!(s.res = SC_get_Curres(s.stmt)))
+	{
+		SC_set_error(s.stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_pos_update.", func);
+		return SQL_ERROR;
+	}
+	MYLOG(0, "entering " FORMAT_POSIROW "+" FORMAT_LEN " fi=%p ti=%p\n", s.irow, QR_get_rowstart_in_cache(s.res), s.irdflds->fi, s.stmt->ti);
+	if (SC_update_not_ready(stmt))
+		parse_statement(s.stmt, TRUE);	/* not preferable */
+	if (!SC_is_updatable(s.stmt))
 	{
 		s.stmt->options.scroll_concurrency = SQL_CONCUR_READ_ONLY;
 		SC_set_error(s.stmt, STMT_INVALID_OPTION_IDENTIFIER, "the statement is read-only", func);
@@ -4100,70 +4421,17 @@ SC_pos_update(StatementClass *stmt,
 		s.old_keyset = *keyset;
 	}
 
-	ti = s.stmt->ti[0];
-
 	initPQExpBuffer(&updstr);
 #define	return	DONT_CALL_RETURN_FROM_HERE???
-	printfPQExpBuffer(&updstr,
-			 "update %s set", ti_quote(stmt, oid, table_fqn, sizeof(table_fqn)));
-
 	num_cols = s.irdflds->nfields;
-	offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
-	for (i = upd_cols = 0; i < num_cols; i++)
-	{
-		if (used = bindings[i].used, used != NULL)
-		{
-			used = LENADDR_SHIFT(used, offset);
-			if (bind_size > 0)
-				used = LENADDR_SHIFT(used, bind_size * s.irow);
-			else
-				used = LENADDR_SHIFT(used, s.irow * sizeof(SQLLEN));
-			MYLOG(0, "%d used=" FORMAT_LEN ",%p\n", i, *used, used);
-			if (*used != SQL_IGNORE && fi[i]->updatable)
-			{
-				if (upd_cols)
-					appendPQExpBuffer(&updstr,
-								 ", \"%s\" = ?", GET_NAME(fi[i]->column_name));
-				else
-					appendPQExpBuffer(&updstr,
-								 " \"%s\" = ?", GET_NAME(fi[i]->column_name));
-				upd_cols++;
-			}
-		}
-		else
-			MYLOG(0, "%d null bind\n", i);
-	}
+	upd_cols = pos_update_query(stmt, s.irow, oid, blocknum, pgoffset, &updstr, &data_at_exec);
 	conn = SC_get_conn(s.stmt);
 	s.updyes = FALSE;
 	if (upd_cols > 0)
 	{
 		HSTMT		hstmt;
-		int			j;
-		ConnInfo	*ci = &(conn->connInfo);
 		APDFields	*apdopts;
-		IPDFields	*ipdopts;
-		OID		fieldtype = 0;
-		const char *bestitem = GET_NAME(ti->bestitem);
-		const char *bestqual = GET_NAME(ti->bestqual);
-		int	unknown_sizes = ci->drivers.unknown_sizes;
 
-		appendPQExpBuffer(&updstr,
-					 " where ctid = '(%u, %u)'",
-					 blocknum, pgoffset);
-		if (bestqual)
-		{
-			appendPQExpBuffer(&updstr, " and ");
-			appendPQExpBuffer(&updstr, bestqual, oid);
-		}
-		if (PG_VERSION_GE(conn, 8.2))
-		{
-			appendPQExpBuffer(&updstr, " returning ctid");
-			if (bestitem)
-			{
-				appendPQExpBuffer(&updstr, ", ");
-				appendPQExpBuffer(&updstr, "\"%s\"", bestitem);
-			}
-		}
 		MYLOG(0, "updstr=%s\n", updstr.data);
 		if (PGAPI_AllocStmt(conn, &hstmt, 0) != SQL_SUCCESS)
 		{
@@ -4174,37 +4442,9 @@ SC_pos_update(StatementClass *stmt,
 		apdopts = SC_get_APDF(s.qstmt);
 		apdopts->param_bind_type = opts->bind_size;
 		apdopts->param_offset_ptr = opts->row_offset_ptr;
-		ipdopts = SC_get_IPDF(s.qstmt);
 		SC_set_delegate(s.stmt, s.qstmt);
-		extend_iparameter_bindings(ipdopts, num_cols);
-		for (i = j = 0; i < num_cols; i++)
-		{
-			if (used = bindings[i].used, used != NULL)
-			{
-				used = LENADDR_SHIFT(used, offset);
-				if (bind_size > 0)
-					used = LENADDR_SHIFT(used, bind_size * s.irow);
-				else
-					used = LENADDR_SHIFT(used, s.irow * sizeof(SQLLEN));
-				MYLOG(0, "%d used=" FORMAT_LEN "\n", i, *used);
-				if (*used != SQL_IGNORE && fi[i]->updatable)
-				{
-					/* fieldtype = QR_get_field_type(s.res, i); */
-					fieldtype = getEffectiveOid(conn, fi[i]);
-					PIC_set_pgtype(ipdopts->parameters[j], fieldtype);
-					PGAPI_BindParameter(hstmt,
-						(SQLUSMALLINT) ++j,
-						SQL_PARAM_INPUT,
-						bindings[i].returntype,
-						pgtype_to_concise_type(s.stmt, fieldtype, i, unknown_sizes),
-																fi[i]->column_size > 0 ? fi[i]->column_size : pgtype_column_size(s.stmt, fieldtype, i, unknown_sizes),
-						(SQLSMALLINT) fi[i]->decimal_digits,
-						bindings[i].buffer,
-						bindings[i].buflen,
-						bindings[i].used);
-				}
-			}
-		}
+		extend_iparameter_bindings(SC_get_IPDF(s.qstmt), num_cols);
+		bind_pos_params(s.stmt, s.qstmt, s.irow, 0, FALSE);
 		s.qstmt->exec_start_row = s.qstmt->exec_end_row = s.irow;
 		s.updyes = TRUE;
 		if (PQExpBufferDataBroken(updstr))
@@ -4244,96 +4484,37 @@ cleanup:
 		termPQExpBuffer(&updstr);
 	return ret;
 }
-RETCODE
-SC_pos_delete(StatementClass *stmt,
-		  SQLSETPOSIROW irow, SQLULEN global_ridx, const KeySet *keyset)
+
+/*
+ *	Append the DELETE command for a row to dltstr.
+ */
+static void
+pos_delete_query(StatementClass *stmt, OID oid, UInt4 blocknum, UInt2 offset, PQExpBuffer dltstr)
 {
-	CSTR	func = "SC_pos_update";
-	UWORD		offset;
-	QResultClass *res, *qres;
-	ConnectionClass	*conn = SC_get_conn(stmt);
-	IRDFields	*irdflds = SC_get_IRDF(stmt);
-	PQExpBufferData		dltstr = {0};
-	RETCODE		ret;
-	SQLLEN		kres_ridx;
-	OID		oid;
-	UInt4		blocknum, qflag;
-	TABLE_INFO	*ti;
-	const char	*bestitem;
-	const char	*bestqual;
-	BOOL		idx_exist = TRUE;
+	TABLE_INFO	*ti = stmt->ti[0];
+	const char	*bestqual = GET_NAME(ti->bestqual);
 	char		table_fqn[256];
 
-	MYLOG(0, "entering ti=%p\n", stmt->ti);
-	if (!(res = SC_get_Curres(stmt)))
-	{
-		SC_set_error(stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_pos_delete.", func);
-		return SQL_ERROR;
-	}
-	if (SC_update_not_ready(stmt))
-		parse_statement(stmt, TRUE);	/* not preferable */
-	if (!SC_is_updatable(stmt))
-	{
-		stmt->options.scroll_concurrency = SQL_CONCUR_READ_ONLY;
-		SC_set_error(stmt, STMT_INVALID_OPTION_IDENTIFIER, "the statement is read-only", func);
-		return SQL_ERROR;
-	}
-	kres_ridx = GIdx2KResIdx(global_ridx, stmt, res);
-	if (kres_ridx < 0 || kres_ridx >= res->num_cached_keys)
-	{
-		if (NULL == keyset || keyset->offset == 0)
-		{
-			SC_set_error(stmt, STMT_ROW_OUT_OF_RANGE, "the target keys are out of the rowset", func);
-			return SQL_ERROR;
-		}
-		idx_exist = FALSE;
-	}
-	ti = stmt->ti[0];
-	bestitem = GET_NAME(ti->bestitem);
-	bestqual = GET_NAME(ti->bestqual);
-	if (idx_exist)
-	{
-		if (!(oid = getOid(res, kres_ridx)))
-		{
-			if (bestitem && !strcmp(bestitem, OID_NAME))
-			{
-				SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the row was already deleted ?", func);
-				return SQL_ERROR;
-			}
-		}
-		getTid(res, kres_ridx, &blocknum, &offset);
-		keyset = res->keyset + kres_ridx;
-	}
-	else
-	{
-		oid = keyset->oid;
-		blocknum = keyset->blocknum;
-		offset = keyset->offset;
-	}
-	initPQExpBuffer(&dltstr);
-#define	return	DONT_CALL_RETURN_FROM_HERE???
-	printfPQExpBuffer(&dltstr,
+	appendPQExpBuffer(dltstr,
 			 "delete from %s where ctid = '(%u, %u)'",
 			 ti_quote(stmt, oid, table_fqn, sizeof(table_fqn)), blocknum, offset);
 	if (bestqual && !TI_has_subclass(ti))
 	{
-		appendPQExpBuffer(&dltstr, " and ");
-		appendPQExpBuffer(&dltstr, bestqual, oid);
+		appendPQExpBuffer(dltstr, " and ");
+		appendPQExpBuffer(dltstr, bestqual, oid);
 	}
+}
+
+/*
+ *	Check the result of the DELETE command for a row.
+ *	The deleted row is invisible now and there's no need to reload it.
+ */
+static RETCODE
+pos_delete_result(StatementClass *stmt, QResultClass *res, QResultClass *qres, SQLULEN global_ridx, BOOL idx_exist, const KeySet *keyset)
+{
+	CSTR	func = "SC_pos_delete";
+	RETCODE	ret = SQL_SUCCESS;
 
-	if (PQExpBufferDataBroken(dltstr))
-	{
-		ret = SQL_ERROR;
-		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_delete()", func);
-		goto cleanup;
-	}
-	MYLOG(0, "dltstr=%s\n", dltstr.data);
-	qflag = 0;
-        if (stmt->external && !CC_is_in_trans(conn) &&
-                 (!CC_does_autocommit(conn)))
-		qflag |= GO_INTO_TRANSACTION;
-	qres = CC_send_query(conn, dltstr.data, NULL, qflag, stmt);
-	ret = SQL_SUCCESS;
 	if (QR_command_maybe_successful(qres))
 	{
 		int			dltcnt;
@@ -4344,11 +4525,7 @@ SC_pos_delete(StatementClass *stmt,
 			secure_sscanf(cmdstr, &status, "DELETE %d", ARG_INT(&dltcnt)) == 1)
 		{
 			if (dltcnt == 1)
-			{
-				RETCODE	tret = SC_pos_reload_with_key(stmt, global_ridx, (UInt2 *) 0, SQL_DELETE, keyset);
-				if (!SQL_SUCCEEDED(tret))
-					ret = tret;
-			}
+				AddRollback(stmt, res, global_ridx, keyset, SQL_DELETE);
 			else if (dltcnt == 0)
 			{
 				SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the content was changed before deletes", func);
@@ -4376,17 +4553,27 @@ SC_pos_delete(StatementClass *stmt,
 	{
 		SC_set_error(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "SetPos delete return error", func);
 	}
-	if (qres)
-		QR_Destructor(qres);
-	if (SQL_SUCCESS == ret && keyset)
-		AddDeleted(res, global_ridx, keyset);
-	if (SQL_SUCCESS == ret && keyset && idx_exist)
-	{
-		res->keyset[kres_ridx].status &= (~KEYSET_INFO_PUBLIC);
-		if (CC_is_in_trans(conn))
-		{
-			res->keyset[kres_ridx].status |= (SQL_ROW_DELETED | CURS_SELF_DELETING);
-		}
+
+	return ret;
+}
+
+/*
+ *	Set the keyset status and the row status of a deleted row.
+ */
+static RETCODE
+pos_delete_status(RETCODE ret, StatementClass *stmt, QResultClass *res, SQLSETPOSIROW irow, SQLULEN global_ridx, SQLLEN kres_ridx, BOOL idx_exist, const KeySet *keyset)
+{
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+
+	if (SQL_SUCCESS == ret && keyset)
+		AddDeleted(res, global_ridx, keyset);
+	if (SQL_SUCCESS == ret && keyset && idx_exist)
+	{
+		res->keyset[kres_ridx].status &= (~KEYSET_INFO_PUBLIC);
+		if (CC_is_in_trans(SC_get_conn(stmt)))
+		{
+			res->keyset[kres_ridx].status |= (SQL_ROW_DELETED | CURS_SELF_DELETING);
+		}
 		else
 			res->keyset[kres_ridx].status |= (SQL_ROW_DELETED | CURS_SELF_DELETED);
 MYLOG(DETAIL_LOG_LEVEL, ".status[" FORMAT_ULEN "]=%x\n", global_ridx, res->keyset[kres_ridx].status);
@@ -4410,6 +4597,89 @@ MYLOG(DETAIL_LOG_LEVEL, ".status[" FORMAT_ULEN "]=%x\n", global_ridx, res->keyse
 		}
 	}
 
+	return ret;
+}
+
+RETCODE
+SC_pos_delete(StatementClass *stmt,
+		  SQLSETPOSIROW irow, SQLULEN global_ridx, const KeySet *keyset)
+{
+	CSTR	func = "SC_pos_update";
+	UWORD		offset;
+	QResultClass *res, *qres;
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	PQExpBufferData		dltstr = {0};
+	RETCODE		ret;
+	SQLLEN		kres_ridx;
+	OID		oid;
+	UInt4		blocknum, qflag;
+	const char	*bestitem;
+	BOOL		idx_exist = TRUE;
+
+	MYLOG(0, "entering ti=%p\n", stmt->ti);
+	if (!(res = SC_get_Curres(stmt)))
+	{
+		SC_set_error(stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_pos_delete.", func);
+		return SQL_ERROR;
+	}
+	if (SC_update_not_ready(stmt))
+		parse_statement(stmt, TRUE);	/* not preferable */
+	if (!SC_is_updatable(stmt))
+	{
+		stmt->options.scroll_concurrency = SQL_CONCUR_READ_ONLY;
+		SC_set_error(stmt, STMT_INVALID_OPTION_IDENTIFIER, "the statement is read-only", func);
+		return SQL_ERROR;
+	}
+	kres_ridx = GIdx2KResIdx(global_ridx, stmt, res);
+	if (kres_ridx < 0 || kres_ridx >= res->num_cached_keys)
+	{
+		if (NULL == keyset || keyset->offset == 0)
+		{
+			SC_set_error(stmt, STMT_ROW_OUT_OF_RANGE, "the target keys are out of the rowset", func);
+			return SQL_ERROR;
+		}
+		idx_exist = FALSE;
+	}
+	bestitem = GET_NAME(stmt->ti[0]->bestitem);
+	if (idx_exist)
+	{
+		if (!(oid = getOid(res, kres_ridx)))
+		{
+			if (bestitem && !strcmp(bestitem, OID_NAME))
+			{
+				SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the row was already deleted ?", func);
+				return SQL_ERROR;
+			}
+		}
+		getTid(res, kres_ridx, &blocknum, &offset);
+		keyset = res->keyset + kres_ridx;
+	}
+	else
+	{
+		oid = keyset->oid;
+		blocknum = keyset->blocknum;
+		offset = keyset->offset;
+	}
+	initPQExpBuffer(&dltstr);
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	pos_delete_query(stmt, oid, blocknum, offset, &dltstr);
+	if (PQExpBufferDataBroken(dltstr))
+	{
+		ret = SQL_ERROR;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_delete()", func);
+		goto cleanup;
+	}
+	MYLOG(0, "dltstr=%s\n", dltstr.data);
+	qflag = 0;
+        if (stmt->external && !CC_is_in_trans(conn) &&
+                 (!CC_does_autocommit(conn)))
+		qflag |= GO_INTO_TRANSACTION;
+	qres = CC_send_query(conn, dltstr.data, NULL, qflag, stmt);
+	ret = pos_delete_result(stmt, res, qres, global_ridx, idx_exist, keyset);
+	if (qres)
+		QR_Destructor(qres);
+	ret = pos_delete_status(ret, stmt, res, irow, global_ridx, kres_ridx, idx_exist, keyset);
+
 cleanup:
 #undef return
 	if (!PQExpBufferDataBroken(dltstr))
@@ -4417,6 +4687,285 @@ cleanup:
 	return ret;
 }
 
+/* a row of SC_pos_update_delete_rows() */
+typedef struct
+{
+	SQLSETPOSIROW	irow;
+	SQLULEN		global_ridx;
+	SQLLEN		kres_ridx;
+	BOOL		idx_exist;
+	OID		oid;
+	UInt4		blocknum;
+	UInt2		offset;
+	KeySet		old_keyset;
+	KeySet		new_keyset;
+	RETCODE		ret;
+}	bpos_row;
+
+/*
+ *	Update or delete the rows irows[0 .. nrows - 1] of the rowset
+ *	together.  The commands are sent as one multiple command query,
+ *	i.e. in a single round trip.  The parameters of a multiple command
+ *	statement are inlined and it's sent by the simple query protocol
+ *	(see PARSE_REQ_FOR_INFO), so this isn't pipelining.  The reload of
+ *	the updated rows is another single query.  The keysets and the
+ *	row status array are reconciled afterwards.
+ *	If the batch fails, it is rolled back as a whole and every row is
+ *	marked as SQL_ROW_ERROR.
+ *
+ *	*batched is set to FALSE without doing anything when the rows
+ *	can't be processed together (e.g. data at execution parameters),
+ *	and the caller should process them one by one.
+ */
+RETCODE
+SC_pos_update_delete_rows(StatementClass *stmt, UWORD fOption, SQLLEN nrows, const SQLSETPOSIROW *irows, const SQLULEN *global_ridxs, const KeySet *keysets, BOOL *batched)
+{
+	CSTR	func = "SC_pos_update_delete_rows";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	QResultClass	*res, *qres = NULL, *rres = NULL, *tres;
+	StatementClass	*qstmt = NULL;
+	bpos_row	*rows = NULL, *row;
+	PQExpBufferData	qstr = {0}, rstr = {0};
+	RETCODE		ret = SQL_SUCCESS;
+	SQLLEN		i;
+	const char	*bestitem;
+	BOOL		data_at_exec = FALSE;
+	int		pno = 0;
+
+	*batched = FALSE;
+	if (nrows < 2 ||
+	    (SQL_UPDATE != fOption && SQL_DELETE != fOption))
+		return SQL_SUCCESS;
+	if (!(res = SC_get_Curres(stmt)) || !res->keyset)
+		return SQL_SUCCESS;
+	if (SC_update_not_ready(stmt))
+		parse_statement(stmt, TRUE);	/* not preferable */
+	if (!SC_is_updatable(stmt))
+		return SQL_SUCCESS;
+	/* the new keys are got by RETURNING */
+	if (SQL_UPDATE == fOption && !PG_VERSION_GE(conn, 8.2))
+		return SQL_SUCCESS;
+	if (NULL == (rows = (bpos_row *) malloc(sizeof(bpos_row) * nrows)))
+		return SQL_SUCCESS;
+
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	bestitem = GET_NAME(stmt->ti[0]->bestitem);
+	for (i = 0, row = rows; i < nrows; i++, row++)
+	{
+		row->irow = irows[i];
+		row->global_ridx = global_ridxs[i];
+		row->ret = SQL_SUCCESS;
+		row->kres_ridx = GIdx2KResIdx(row->global_ridx, stmt, res);
+		row->idx_exist = (row->kres_ridx >= 0 && row->kres_ridx < res->num_cached_keys);
+		if (row->idx_exist)
+			row->old_keyset = res->keyset[row->kres_ridx];
+		else if (keysets && keysets[i].offset != 0)
+			row->old_keyset = keysets[i];
+		else
+			goto cleanup;	/* an error of the row */
+		row->oid = row->old_keyset.oid;
+		row->blocknum = row->old_keyset.blocknum;
+		row->offset = row->old_keyset.offset;
+		if (row->idx_exist && 0 == row->oid &&
+		    bestitem && !strcmp(bestitem, OID_NAME))
+			goto cleanup;	/* an error of the row */
+	}
+
+	initPQExpBuffer(&qstr);
+	for (i = 0, row = rows; i < nrows; i++, row++)
+	{
+		if (i > 0)
+			appendPQExpBufferChar(&qstr, ';');
+		if (SQL_UPDATE == fOption)
+		{
+			if (0 == pos_update_query(stmt, row->irow, row->oid, row->blocknum, row->offset, &qstr, &data_at_exec))
+				goto cleanup;	/* update list null */
+		}
+		else
+			pos_delete_query(stmt, row->oid, row->blocknum, row->offset, &qstr);
+	}
+	if (data_at_exec)
+		goto cleanup;
+	if (PQExpBufferDataBroken(qstr))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_update_delete_rows()", func);
+		ret = SQL_ERROR;
+		*batched = TRUE;
+		goto cleanup;
+	}
+	MYLOG(0, "%s " FORMAT_LEN " rows=%s\n", SQL_UPDATE == fOption ? "update" : "delete", nrows, qstr.data);
+
+	*batched = TRUE;
+	if (SQL_DELETE == fOption)
+	{
+		UInt4	qflag = 0;
+
+		if (stmt->external && !CC_is_in_trans(conn) &&
+		    (!CC_does_autocommit(conn)))
+			qflag |= GO_INTO_TRANSACTION;
+		qres = CC_send_query(conn, qstr.data, NULL, qflag, stmt);
+		for (tres = qres, i = 0; QR_command_maybe_successful(tres); tres = QR_nextr(tres), i++)
+			;
+		if (i < nrows)
+		{
+			ret = SQL_ERROR;
+			pos_delete_result(stmt, res, tres, 0, FALSE, NULL);
+		}
+		else
+		{
+			for (tres = qres, row = rows; tres; tres = QR_nextr(tres), row++)
+				row->ret = pos_delete_result(stmt, res, tres, row->global_ridx, row->idx_exist, row->idx_exist ? res->keyset + row->kres_ridx : &row->old_keyset);
+		}
+	}
+	else
+	{
+		HSTMT		hstmt;
+		APDFields	*apdopts;
+
+		if (PGAPI_AllocStmt(conn, &hstmt, 0) != SQL_SUCCESS)
+		{
+			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "internal AllocStmt error", func);
+			ret = SQL_ERROR;
+			goto cleanup;
+		}
+		qstmt = (StatementClass *) hstmt;
+		/* the addresses of each row are bound directly */
+		apdopts = SC_get_APDF(qstmt);
+		apdopts->param_bind_type = 0;
+		apdopts->param_offset_ptr = NULL;
+		SC_set_delegate(stmt, qstmt);
+		extend_iparameter_bindings(SC_get_IPDF(qstmt), SC_get_IRDF(stmt)->nfields * nrows);
+		for (i = 0, row = rows; i < nrows; i++, row++)
+			pno = bind_pos_params(stmt, qstmt, row->irow, pno, TRUE);
+		qstmt->exec_start_row = qstmt->exec_end_row = 0;
+		if (!SQL_SUCCEEDED(PGAPI_ExecDirect(hstmt, (SQLCHAR *) qstr.data, SQL_NTS, 0)))
+		{
+			SC_error_copy(stmt, qstmt, TRUE);
+			ret = SQL_ERROR;
+		}
+		else
+		{
+			/* reload the updated rows at once */
+			initPQExpBuffer(&rstr);
+			for (tres = SC_get_Result(qstmt), row = rows, i = 0; i < nrows; tres = tres ? QR_nextr(tres) : NULL, row++, i++)
+			{
+				int	updcnt, status = 0;
+				const char *cmdstr = tres ? QR_get_command(tres) : NULL;
+
+				row->ret = SQL_ERROR;
+				if (!cmdstr ||
+				    secure_sscanf(cmdstr, &status, "UPDATE %d", ARG_INT(&updcnt)) != 1)
+					;
+				else if (updcnt == 1)
+				{
+					if (NULL != tres->backend_tuples &&
+					    1 == QR_get_num_cached_tuples(tres) &&
+					    KeySetSet(tres->backend_tuples, QR_NumResultCols(tres), QR_NumResultCols(tres), &row->new_keyset, TRUE))
+					{
+						char	tid[32];
+
+						SPRINTF_FIXED(tid, "(%u,%hu)", row->new_keyset.blocknum, row->new_keyset.offset);
+						if (rstr.len > 0)
+							appendPQExpBufferChar(&rstr, ';');
+						if (positioned_load_query(stmt, 0, &row->new_keyset.oid, tid, &rstr))
+							row->ret = SQL_SUCCESS;
+					}
+				}
+				else if (updcnt == 0)
+				{
+					SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the content was changed before updates", func);
+					row->ret = SQL_SUCCESS_WITH_INFO;
+					if (stmt->options.cursor_type == SQL_CURSOR_KEYSET_DRIVEN)
+						SC_pos_reload(stmt, row->global_ridx, (UInt2 *) 0, 0);
+				}
+			}
+			if (rstr.len > 0)
+			{
+				MYLOG(0, "reload=%s\n", rstr.data);
+				rres = CC_send_query(conn, rstr.data, NULL, READ_ONLY_QUERY, stmt);
+			}
+			for (tres = rres, row = rows, i = 0; i < nrows; row++, i++)
+			{
+				char	tidval[32];
+
+				if (SQL_SUCCESS != row->ret)
+					continue;
+				if (row->idx_exist)
+					SPRINTF_FIXED(tidval, "(%u, %u)", row->blocknum, row->offset);
+				else
+					tidval[0] = '\0';
+				row->ret = pos_reload_result(stmt, res, row->global_ridx, row->kres_ridx, row->idx_exist, SQL_UPDATE, &row->new_keyset, tidval, tres, NULL);
+				if (SQL_SUCCEEDED(row->ret))
+					AddRollback(stmt, res, row->global_ridx, &row->old_keyset, SQL_UPDATE);
+				if (tres)
+					tres = QR_nextr(tres);
+			}
+			for (row = rows, i = 0; i < nrows; row++, i++)
+			{
+				if (SQL_ERROR == row->ret && SC_get_errornumber(stmt) == 0)
+					SC_set_error(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "SetPos update return error", func);
+			}
+		}
+	}
+
+	/* reconcile the keyset and the row status */
+	for (row = rows, i = 0; i < nrows; row++, i++)
+	{
+		RETCODE	rowret = (SQL_ERROR == ret ? SQL_ERROR : row->ret);
+
+		if (SQL_UPDATE == fOption)
+			rowret = pos_update_status(rowret, stmt, res, row->irow, row->global_ridx);
+		else
+			rowret = pos_delete_status(rowret, stmt, res, row->irow, row->global_ridx, row->kres_ridx, row->idx_exist, row->idx_exist ? res->keyset + row->kres_ridx : &row->old_keyset);
+		if (SQL_ERROR == rowret)
+			ret = SQL_ERROR;
+		else if (SQL_SUCCESS_WITH_INFO == rowret && SQL_SUCCESS == ret)
+			ret = SQL_SUCCESS_WITH_INFO;
+	}
+
+cleanup:
+#undef	return
+	if (!PQExpBufferDataBroken(qstr))
+		termPQExpBuffer(&qstr);
+	if (!PQExpBufferDataBroken(rstr))
+		termPQExpBuffer(&rstr);
+	QR_Destructor(qres);
+	QR_Destructor(rres);
+	if (qstmt)
+		PGAPI_FreeStmt(qstmt, SQL_DROP);
+	free(rows);
+	return ret;
+}
+
+/*
+ *	Get the keys of the inserted row from the result of
+ *	"insert ... returning ctid[, bestitem]".
+ *	Returns FALSE if the command didn't insert one row.
+ */
+static BOOL
+inserted_keys(QResultClass *tres, OID *oid, KeySet *keys, char *tidv, size_t tidvlen)
+{
+	int		addcnt;
+	int		status = 0;
+	const char *cmdstr = tres ? QR_get_command(tres) : NULL;
+
+	if (!cmdstr ||
+	    secure_sscanf(cmdstr, &status, "INSERT %u %d",
+			ARG_UINT(oid), ARG_INT(&addcnt)) != 2 ||
+	    addcnt != 1)
+		return FALSE;
+	tidv[0] = '\0';
+	if (NULL != tres->backend_tuples &&
+	    1 == QR_get_num_cached_tuples(tres))
+	{
+		if (!KeySetSet(tres->backend_tuples, QR_NumResultCols(tres), QR_NumResultCols(tres), keys, TRUE))
+			return FALSE;
+		*oid = keys->oid;
+		snprintf(tidv, tidvlen, "(%u,%hu)", keys->blocknum, keys->offset);
+	}
+	return TRUE;
+}
+
 static RETCODE SQL_API
 irow_insert(RETCODE ret, StatementClass *stmt, StatementClass *istmt,
 			SQLLEN addpos)
@@ -4425,35 +4974,19 @@ irow_insert(RETCODE ret, StatementClass *stmt, StatementClass *istmt,
 
 	if (ret != SQL_ERROR)
 	{
-		int		addcnt;
 		OID		oid, *poid = NULL;
 		ARDFields	*opts = SC_get_ARDF(stmt);
 		QResultClass	*ires = SC_get_Curres(istmt), *tres;
-		const char *cmdstr;
 		BindInfoClass	*bookmark;
+		char	tidv[32];
+		KeySet	keys;
 
 		tres = (QR_nextr(ires) ? QR_nextr(ires) : ires);
-		cmdstr = QR_get_command(tres);
-
-		int status = 0;
-		if (cmdstr &&
-			secure_sscanf(cmdstr, &status, "INSERT %u %d",
-				ARG_UINT(&oid), ARG_INT(&addcnt)) == 2 &&
-			addcnt == 1)
+		if (inserted_keys(tres, &oid, &keys, tidv, sizeof(tidv)))
 		{
 			RETCODE	qret;
-			const char * tidval = NULL;
-			char	tidv[32];
-			KeySet	keys;
+			const char * tidval = (tidv[0] ? tidv : NULL);
 
-			if (NULL != tres->backend_tuples &&
-			    1 == QR_get_num_cached_tuples(tres))
-			{
-				KeySetSet(tres->backend_tuples, QR_NumResultCols(tres), QR_NumResultCols(tres), &keys, TRUE);
-				oid = keys.oid;
-				SPRINTF_FIXED(tidv, "(%u,%hu)", keys.blocknum, keys.offset);
-				tidval = tidv;
-			}
 			if (0 != oid)
 				poid = &oid;
 			qret = SC_pos_newload(stmt, poid, TRUE, tidval);
@@ -4481,6 +5014,50 @@ irow_insert(RETCODE ret, StatementClass *stmt, StatementClass *istmt,
 	return ret;
 }
 
+/*
+ *	Set the keyset status and the row status of an added row.
+ */
+static RETCODE
+pos_add_status(RETCODE ret, StatementClass *stmt, QResultClass *res, SQLSETPOSIROW irow)
+{
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+
+	if (SQL_SUCCESS == ret && res->keyset)
+	{
+		SQLLEN	global_ridx = QR_get_num_total_tuples(res) - 1;
+		ConnectionClass	*conn = SC_get_conn(stmt);
+		SQLLEN	kres_ridx;
+		UWORD	status = SQL_ROW_ADDED;
+
+		if (CC_is_in_trans(conn))
+			status |= CURS_SELF_ADDING;
+		else
+			status |= CURS_SELF_ADDED;
+		kres_ridx = GIdx2KResIdx(global_ridx, stmt, res);
+		if (kres_ridx >= 0 && kres_ridx < res->num_cached_keys)
+		{
+			res->keyset[kres_ridx].status = status;
+		}
+	}
+	if (irdflds->rowStatusArray)
+	{
+		switch (ret)
+		{
+			case SQL_SUCCESS:
+				irdflds->rowStatusArray[irow] = SQL_ROW_ADDED;
+				break;
+			case SQL_NO_DATA_FOUND:
+			case SQL_SUCCESS_WITH_INFO:
+				irdflds->rowStatusArray[irow] = SQL_ROW_SUCCESS_WITH_INFO;
+				break;
+			default:
+				irdflds->rowStatusArray[irow] = SQL_ROW_ERROR;
+		}
+	}
+
+	return ret;
+}
+
 /* SQL_NEED_DATA callback for SC_pos_add */
 typedef struct
 {
@@ -4518,40 +5095,77 @@ pos_add_callback(RETCODE retcode, void *para)
 		SC_error_copy(s->stmt, s->qstmt, TRUE);
 	PGAPI_FreeStmt((HSTMT) s->qstmt, SQL_DROP);
 	s->qstmt = NULL;
-	if (SQL_SUCCESS == ret && s->res->keyset)
-	{
-		SQLLEN	global_ridx = QR_get_num_total_tuples(s->res) - 1;
-		ConnectionClass	*conn = SC_get_conn(s->stmt);
-		SQLLEN	kres_ridx;
-		UWORD	status = SQL_ROW_ADDED;
 
-		if (CC_is_in_trans(conn))
-			status |= CURS_SELF_ADDING;
-		else
-			status |= CURS_SELF_ADDED;
-		kres_ridx = GIdx2KResIdx(global_ridx, s->stmt, s->res);
-		if (kres_ridx >= 0 && kres_ridx < s->res->num_cached_keys)
+	return pos_add_status(ret, s->stmt, s->res, s->irow);
+}
+
+/*
+ *	Append the INSERT command for the row irow of the rowset to addstr.
+ *	Returns the number of the columns to insert.
+ */
+static int
+pos_add_query(StatementClass *stmt, SQLSETPOSIROW irow, PQExpBuffer addstr, BOOL *data_at_exec)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	BindInfoClass	*bindings = opts->bindings;
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+	FIELD_INFO	**fi = irdflds->fi;
+	int		i, num_cols, add_cols;
+	SQLLEN		*used;
+	char		table_fqn[256];
+
+	appendPQExpBuffer(addstr,
+			 "insert into %s (",
+			 ti_quote(stmt, 0, table_fqn, sizeof(table_fqn)));
+	num_cols = irdflds->nfields;
+	for (i = add_cols = 0; i < num_cols; i++)
+	{
+		if (used = bound_used_of_row(opts, bindings + i, irow), used != NULL)
 		{
-			s->res->keyset[kres_ridx].status = status;
+			MYLOG(0, "%d used=" FORMAT_LEN "\n", i, *used);
+			if (*used != SQL_IGNORE && fi[i]->updatable)
+			{
+				if (add_cols)
+					appendPQExpBuffer(addstr,
+								 ", \"%s\"", GET_NAME(fi[i]->column_name));
+				else
+					appendPQExpBuffer(addstr,
+								 "\"%s\"", GET_NAME(fi[i]->column_name));
+				add_cols++;
+				if (*used == SQL_DATA_AT_EXEC || *used <= SQL_LEN_DATA_AT_EXEC_OFFSET)
+					*data_at_exec = TRUE;
+			}
 		}
+		else
+			MYLOG(0, "%d null bind\n", i);
 	}
-	if (s->irdflds->rowStatusArray)
+	if (add_cols > 0)
 	{
-		switch (ret)
+		appendPQExpBuffer(addstr, ") values (");
+		for (i = 0; i < add_cols; i++)
 		{
-			case SQL_SUCCESS:
-				s->irdflds->rowStatusArray[s->irow] = SQL_ROW_ADDED;
-				break;
-			case SQL_NO_DATA_FOUND:
-			case SQL_SUCCESS_WITH_INFO:
-				s->irdflds->rowStatusArray[s->irow] = SQL_ROW_SUCCESS_WITH_INFO;
-				break;
-			default:
-				s->irdflds->rowStatusArray[s->irow] = SQL_ROW_ERROR;
+			if (i)
+				appendPQExpBuffer(addstr, ", ?");
+			else
+				appendPQExpBuffer(addstr, "?");
+		}
+		appendPQExpBuffer(addstr, ")");
+		if (PG_VERSION_GE(conn, 8.2))
+		{
+			TABLE_INFO	*ti = stmt->ti[0];
+			const char *bestitem = GET_NAME(ti->bestitem);
+
+			appendPQExpBuffer(addstr, " returning ctid");
+			if (bestitem)
+			{
+				appendPQExpBuffer(addstr, ", ");
+				appendPQExpBuffer(addstr, "\"%s\"", bestitem);
+			}
 		}
 	}
 
-	return ret;
+	return add_cols;
 }
 
 RETCODE
@@ -4560,29 +5174,19 @@ SC_pos_add(StatementClass *stmt,
 {
 	CSTR	func = "SC_pos_add";
 	int			num_cols,
-				add_cols,
-				i;
+				add_cols;
 	HSTMT		hstmt;
 
 	padd_cdata	s;
 	ConnectionClass	*conn;
-	ConnInfo	*ci;
 	ARDFields	*opts = SC_get_ARDF(stmt);
 	APDFields	*apdopts;
-	IPDFields	*ipdopts;
-	BindInfoClass *bindings = opts->bindings;
-	FIELD_INFO	**fi = SC_get_IRDF(stmt)->fi;
 	PQExpBufferData		addstr = {0};
-	RETCODE		ret;
-	SQLULEN		offset;
-	SQLLEN		*used;
-	Int4		bind_size = opts->bind_size;
-	OID		fieldtype;
-	int		unknown_sizes;
+	RETCODE		ret;
 	int		func_cs_count = 0;
-	char		table_fqn[256];
+	BOOL		data_at_exec = FALSE;
 
-	MYLOG(0, "entering fi=%p ti=%p\n", fi, stmt->ti);
+	MYLOG(0, "entering fi=%p ti=%p\n", SC_get_IRDF(stmt)->fi, stmt->ti);
 	s.stmt = stmt;
 	s.irow = irow;
 	if (!(s.res = SC_get_Curres(s.stmt)))
@@ -4609,83 +5213,18 @@ SC_pos_add(StatementClass *stmt,
 	}
 	initPQExpBuffer(&addstr);
 #define	return	DONT_CALL_RETURN_FROM_HERE???
-	printfPQExpBuffer(&addstr,
-			 "insert into %s (",
-			 ti_quote(s.stmt, 0, table_fqn, sizeof(table_fqn)));
-	if (opts->row_offset_ptr)
-		offset = *opts->row_offset_ptr;
-	else
-		offset = 0;
 	s.qstmt = (StatementClass *) hstmt;
 	apdopts = SC_get_APDF(s.qstmt);
 	apdopts->param_bind_type = opts->bind_size;
 	apdopts->param_offset_ptr = opts->row_offset_ptr;
-	ipdopts = SC_get_IPDF(s.qstmt);
 	SC_set_delegate(s.stmt, s.qstmt);
-	ci = &(conn->connInfo);
-	unknown_sizes = ci->drivers.unknown_sizes;
-	extend_iparameter_bindings(ipdopts, num_cols);
-	for (i = add_cols = 0; i < num_cols; i++)
-	{
-		if (used = bindings[i].used, used != NULL)
-		{
-			used = LENADDR_SHIFT(used, offset);
-			if (bind_size > 0)
-				used = LENADDR_SHIFT(used, bind_size * s.irow);
-			else
-				used = LENADDR_SHIFT(used, s.irow * sizeof(SQLLEN));
-			MYLOG(0, "%d used=" FORMAT_LEN "\n", i, *used);
-			if (*used != SQL_IGNORE && fi[i]->updatable)
-			{
-				/* fieldtype = QR_get_field_type(s.res, i); */
-				fieldtype = getEffectiveOid(conn, fi[i]);
-				if (add_cols)
-					appendPQExpBuffer(&addstr,
-								 ", \"%s\"", GET_NAME(fi[i]->column_name));
-				else
-					appendPQExpBuffer(&addstr,
-								 "\"%s\"", GET_NAME(fi[i]->column_name));
-				PIC_set_pgtype(ipdopts->parameters[add_cols], fieldtype);
-				PGAPI_BindParameter(hstmt,
-					(SQLUSMALLINT) ++add_cols,
-					SQL_PARAM_INPUT,
-					bindings[i].returntype,
-					pgtype_to_concise_type(s.stmt, fieldtype, i, unknown_sizes),
-															fi[i]->column_size > 0 ? fi[i]->column_size : pgtype_column_size(s.stmt, fieldtype, i, unknown_sizes),
-					(SQLSMALLINT) fi[i]->decimal_digits,
-					bindings[i].buffer,
-					bindings[i].buflen,
-					bindings[i].used);
-			}
-		}
-		else
-			MYLOG(0, "%d null bind\n", i);
-	}
+	extend_iparameter_bindings(SC_get_IPDF(s.qstmt), num_cols);
+	add_cols = pos_add_query(s.stmt, s.irow, &addstr, &data_at_exec);
+	bind_pos_params(s.stmt, s.qstmt, s.irow, 0, FALSE);
 	s.updyes = FALSE;
 	ENTER_INNER_CONN_CS(conn, func_cs_count);
 	if (add_cols > 0)
 	{
-		appendPQExpBuffer(&addstr, ") values (");
-		for (i = 0; i < add_cols; i++)
-		{
-			if (i)
-				appendPQExpBuffer(&addstr, ", ?");
-			else
-				appendPQExpBuffer(&addstr, "?");
-		}
-		appendPQExpBuffer(&addstr, ")");
-		if (PG_VERSION_GE(conn, 8.2))
-		{
-			TABLE_INFO	*ti = stmt->ti[0];
-			const char *bestitem = GET_NAME(ti->bestitem);
-
-			appendPQExpBuffer(&addstr, " returning ctid");
-			if (bestitem)
-			{
-				appendPQExpBuffer(&addstr, ", ");
-				appendPQExpBuffer(&addstr, "\"%s\"", bestitem);
-			}
-		}
 		if (PQExpBufferDataBroken(addstr))
 		{
 			ret = SQL_ERROR;
@@ -4729,19 +5268,267 @@ cleanup:
 	return ret;
 }
 
+/* a row of SC_pos_add_rows() */
+typedef struct
+{
+	SQLSETPOSIROW	irow;
+	OID		oid;
+	KeySet		keys;
+	char		tidval[32];
+	QResultClass	*lres;	/* the reloaded row */
+	RETCODE		ret;
+}	badd_row;
+
+/*
+ *	Insert the rows irows[0 .. nrows - 1] of the rowset together.
+ *	The INSERT commands are executed as one multiple command statement,
+ *	i.e. its parameters are inlined and it's sent by the simple query
+ *	protocol in a single round trip.  The inserted rows are identified
+ *	by RETURNING ctid and all of them are loaded by one query.
+ *	If the batch fails, it is rolled back as a whole and every row is
+ *	marked as SQL_ROW_ERROR.
+ *
+ *	*batched is set to FALSE without doing anything when the rows
+ *	can't be processed together, and the caller should process them
+ *	one by one.
+ */
+RETCODE
+SC_pos_add_rows(StatementClass *stmt, SQLLEN nrows, const SQLSETPOSIROW *irows, BOOL *batched)
+{
+	CSTR	func = "SC_pos_add_rows";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	BindInfoClass	*bookmark = opts->bookmark;
+	QResultClass	*res, *rres = NULL, *tres;
+	StatementClass	*qstmt = NULL;
+	badd_row	*rows = NULL, *row;
+	PQExpBufferData	qstr = {0}, rstr = {0};
+	RETCODE		ret = SQL_SUCCESS, rowret;
+	SQLLEN		i, addpos;
+	SQLSETPOSIROW	brow_save = stmt->bind_row;
+	BOOL		data_at_exec = FALSE;
+	int		pno = 0, func_cs_count = 0;
+	HSTMT		hstmt;
+	APDFields	*apdopts;
+
+	*batched = FALSE;
+	if (nrows < 2)
+		return SQL_SUCCESS;
+	if (!(res = SC_get_Curres(stmt)))
+		return SQL_SUCCESS;
+	if (SC_update_not_ready(stmt))
+		parse_statement(stmt, TRUE);	/* not preferable */
+	if (!SC_is_updatable(stmt))
+		return SQL_SUCCESS;
+	/* the inserted rows are identified by RETURNING */
+	if (!PG_VERSION_GE(conn, 8.2))
+		return SQL_SUCCESS;
+	if (NULL == (rows = (badd_row *) malloc(sizeof(badd_row) * nrows)))
+		return SQL_SUCCESS;
+
+	initPQExpBuffer(&qstr);
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	for (i = 0, row = rows; i < nrows; i++, row++)
+	{
+		row->irow = irows[i];
+		row->lres = NULL;
+		row->ret = SQL_ERROR;
+		if (i > 0)
+			appendPQExpBufferChar(&qstr, ';');
+		if (0 == pos_add_query(stmt, row->irow, &qstr, &data_at_exec))
+			goto cleanup;	/* insert list null */
+	}
+	if (data_at_exec)
+		goto cleanup;
+	*batched = TRUE;
+	if (PQExpBufferDataBroken(qstr))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_add_rows()", func);
+		ret = SQL_ERROR;
+		goto cleanup;
+	}
+	MYLOG(0, "insert " FORMAT_LEN " rows=%s\n", nrows, qstr.data);
+
+	if (PGAPI_AllocStmt(conn, &hstmt, 0) != SQL_SUCCESS)
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "internal AllocStmt error", func);
+		ret = SQL_ERROR;
+		goto cleanup;
+	}
+	qstmt = (StatementClass *) hstmt;
+	/* the addresses of each row are bound directly */
+	apdopts = SC_get_APDF(qstmt);
+	apdopts->param_bind_type = 0;
+	apdopts->param_offset_ptr = NULL;
+	SC_set_delegate(stmt, qstmt);
+	extend_iparameter_bindings(SC_get_IPDF(qstmt), SC_get_IRDF(stmt)->nfields * nrows);
+	for (i = 0, row = rows; i < nrows; i++, row++)
+		pno = bind_pos_params(stmt, qstmt, row->irow, pno, TRUE);
+	qstmt->exec_start_row = qstmt->exec_end_row = 0;
+	ENTER_INNER_CONN_CS(conn, func_cs_count);
+	rowret = PGAPI_ExecDirect(hstmt, (SQLCHAR *) qstr.data, SQL_NTS, 0);
+	SC_setInsertedTable(qstmt, rowret);
+	if (!SQL_SUCCEEDED(rowret))
+	{
+		SC_error_copy(stmt, qstmt, TRUE);
+		ret = SQL_ERROR;
+		goto batch_error;
+	}
+
+	/* load the inserted rows at once */
+	initPQExpBuffer(&rstr);
+	for (tres = SC_get_Result(qstmt), row = rows, i = 0; i < nrows; tres = tres ? QR_nextr(tres) : NULL, row++, i++)
+	{
+		if (!inserted_keys(tres, &row->oid, &row->keys, row->tidval, sizeof(row->tidval)) ||
+		    !row->tidval[0])
+			continue;
+		if (rstr.len > 0)
+			appendPQExpBufferChar(&rstr, ';');
+		if (positioned_load_query(stmt, 0, 0 != row->oid ? &row->oid : NULL, row->tidval, &rstr))
+			row->ret = SQL_SUCCESS;
+	}
+	if (rstr.len > 0)
+	{
+		MYLOG(0, "reload=%s\n", rstr.data);
+		rres = CC_send_query(conn, rstr.data, NULL, READ_ONLY_QUERY, stmt);
+	}
+	for (tres = rres, row = rows, i = 0; i < nrows; row++, i++)
+	{
+		if (SQL_SUCCESS != row->ret)
+			continue;
+		row->lres = tres;
+		if (tres)
+			tres = QR_nextr(tres);
+	}
+
+	/*
+	 *	append the rows to the keyset and the cache in order,
+	 *	pos_add_status() sees the row just appended as the last one.
+	 */
+	for (row = rows, i = 0; i < nrows; row++, i++)
+	{
+		if (SQL_SUCCESS != row->ret)
+		{
+			if (SC_get_errornumber(stmt) == 0)
+				SC_set_error(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "SetPos insert return error", func);
+		}
+		else
+		{
+			stmt->bind_row = row->irow;
+			if (QR_get_cursor(res))
+				addpos = -(SQLLEN)(res->ad_count + 1);
+			else
+				addpos = QR_get_num_total_tuples(res);
+			row->ret = pos_newload_result(stmt, res, row->lres);
+			if (SQL_NO_DATA_FOUND == row->ret)
+				row->ret = SC_pos_newload(stmt, 0 != row->oid ? &row->oid : NULL, FALSE, NULL);
+			if (SQL_ERROR != row->ret)
+			{
+				row->ret = SQL_SUCCESS;
+				if (bookmark && bookmark->buffer)
+				{
+					SC_set_current_col(stmt, -1);
+					SC_Create_bookmark(stmt, bookmark, stmt->bind_row, addpos, &row->keys);
+				}
+			}
+		}
+		rowret = pos_add_status(row->ret, stmt, res, row->irow);
+		if (SQL_ERROR == rowret)
+			ret = SQL_ERROR;
+		else if (SQL_SUCCESS_WITH_INFO == rowret && SQL_SUCCESS == ret)
+			ret = SQL_SUCCESS_WITH_INFO;
+	}
+	stmt->bind_row = brow_save;
+	goto cleanup;
+
+batch_error:
+	/* the batch failed as a whole */
+	for (row = rows, i = 0; i < nrows; row++, i++)
+		pos_add_status(SQL_ERROR, stmt, res, row->irow);
+
+cleanup:
+#undef	return
+	CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
+	if (!PQExpBufferDataBroken(qstr))
+		termPQExpBuffer(&qstr);
+	if (!PQExpBufferDataBroken(rstr))
+		termPQExpBuffer(&rstr);
+	QR_Destructor(rres);
+	if (qstmt)
+		PGAPI_FreeStmt(qstmt, SQL_DROP);
+	free(rows);
+	return ret;
+}
+
 /*
  *	Stuff for updatable cursors end.
  */
 
-RETCODE
-SC_pos_refresh(StatementClass *stmt, SQLSETPOSIROW irow , SQLULEN global_ridx)
+/*
+ *	Fetch the row irow of the rowset again after it's reloaded if needed.
+ *	SC_fetch() reads the row next to the current one, so the current
+ *	row is moved just before the row global_ridx and restored after.
+ */
+static void
+pos_refresh_fetch(StatementClass *stmt, SQLSETPOSIROW irow, SQLULEN global_ridx)
 {
 	RETCODE	ret;
 	IRDFields	*irdflds = SC_get_IRDF(stmt);
+	QResultClass	*res = SC_get_Curres(stmt);
 	/* save the last_fetch_count */
 	SQLLEN		last_fetch = stmt->last_fetch_count;
 	SQLLEN		last_fetch2 = stmt->last_fetch_count_include_ommitted;
 	SQLSETPOSIROW	bind_save = stmt->bind_row;
+	SQLLEN		curr_save = stmt->currTuple;
+	SQLLEN		next_save = res->fetch_number;
+	SQLLEN		kres_ridx;
+	UWORD		pstatus = 0;
+
+	stmt->bind_row = irow;
+	stmt->currTuple = global_ridx - 1;
+	if (SC_is_fetchcursor(stmt) && QR_get_cursor(res))
+		QR_set_next_in_cache(res, GIdx2CacheIdx(global_ridx, stmt, res));
+	ret = SC_fetch(stmt);
+	/* restore the last_fetch_count */
+	stmt->last_fetch_count = last_fetch;
+	stmt->last_fetch_count_include_ommitted = last_fetch2;
+	stmt->bind_row = bind_save;
+	stmt->currTuple = curr_save;
+	QR_set_next_in_cache(res, next_save);
+	if (irdflds->rowStatusArray)
+	{
+		/* report the changes found by the reload as PGAPI_ExtendedFetch() does */
+		if (res->keyset)
+		{
+			kres_ridx = GIdx2KResIdx(global_ridx, stmt, res);
+			if (kres_ridx >= 0 && kres_ridx < res->num_cached_keys)
+				pstatus = (res->keyset[kres_ridx].status & KEYSET_INFO_PUBLIC);
+		}
+		switch (ret)
+		{
+			case SQL_SUCCESS:
+				if (0 != (pstatus & SQL_ROW_DELETED))
+					irdflds->rowStatusArray[irow] = SQL_ROW_DELETED;
+				else if (0 != (pstatus & SQL_ROW_UPDATED))
+					irdflds->rowStatusArray[irow] = SQL_ROW_UPDATED;
+				else
+					irdflds->rowStatusArray[irow] = SQL_ROW_SUCCESS;
+				break;
+			case SQL_SUCCESS_WITH_INFO:
+				irdflds->rowStatusArray[irow] = SQL_ROW_SUCCESS_WITH_INFO;
+				break;
+			case SQL_ERROR:
+			default:
+				irdflds->rowStatusArray[irow] = SQL_ROW_ERROR;
+				break;
+		}
+	}
+}
+
+RETCODE
+SC_pos_refresh(StatementClass *stmt, SQLSETPOSIROW irow , SQLULEN global_ridx)
+{
+	RETCODE	ret;
 	BOOL		tuple_reload = FALSE;
 
 	if (stmt->options.cursor_type == SQL_CURSOR_KEYSET_DRIVEN)
@@ -4764,30 +5551,143 @@ SC_pos_refresh(StatementClass *stmt, SQLSETPOSIROW irow , SQLULEN global_ridx)
 		if (!SQL_SUCCEEDED(ret = SC_pos_reload(stmt, global_ridx, (UInt2 *) 0, 0)))
 			return ret;
 	}
-	stmt->bind_row = irow;
-	ret = SC_fetch(stmt);
-	/* restore the last_fetch_count */
-	stmt->last_fetch_count = last_fetch;
-	stmt->last_fetch_count_include_ommitted = last_fetch2;
-	stmt->bind_row = bind_save;
-	if (irdflds->rowStatusArray)
+	pos_refresh_fetch(stmt, irow, global_ridx);
+
+	return SQL_SUCCESS;
+}
+
+/* a row of SC_pos_refresh_rows() */
+typedef struct
+{
+	SQLSETPOSIROW	irow;
+	SQLULEN		global_ridx;
+	SQLLEN		kres_ridx;
+	OID		oidint;
+	char		tidval[32];
+	BOOL		queried;
+	QResultClass	*qres;	/* the reloaded row */
+	RETCODE		ret;
+}	bref_row;
+
+/*
+ *	Refresh the rows irows[0 .. nrows - 1] of the rowset together.
+ *	The rows SC_pos_refresh() would reload are re-read by one multiple
+ *	command query (the same queries as SC_pos_reload()) instead of a
+ *	query per row, then each row is fetched again.
+ *	Processing stops at the first row which couldn't be reloaded and
+ *	*nprocessed is set to the count of the rows processed.
+ *
+ *	*batched is set to FALSE without doing anything when the rows
+ *	can't be processed together, and the caller should process them
+ *	one by one.
+ */
+RETCODE
+SC_pos_refresh_rows(StatementClass *stmt, SQLLEN nrows, const SQLSETPOSIROW *irows, const SQLULEN *global_ridxs, SQLLEN *nprocessed, BOOL *batched)
+{
+	CSTR	func = "SC_pos_refresh_rows";
+	QResultClass	*res, *qres = NULL, *tres;
+	bref_row	*rows = NULL, *row;
+	PQExpBufferData	qstr = {0};
+	RETCODE		ret = SQL_SUCCESS;
+	SQLLEN		i;
+	UInt2		rcnt;
+	BOOL		keyset_driven = (SQL_CURSOR_KEYSET_DRIVEN == stmt->options.cursor_type);
+	BOOL		use_ctid;
+
+	*batched = FALSE;
+	if (nrows < 2)
+		return SQL_SUCCESS;
+	if (!(res = SC_get_Curres(stmt)) || !res->keyset)
+		return SQL_SUCCESS;
+	if (SC_update_not_ready(stmt))
+		parse_statement(stmt, TRUE);	/* not preferable */
+	if (!SC_is_updatable(stmt))
+		return SQL_SUCCESS;
+	if (NULL == (rows = (bref_row *) malloc(sizeof(bref_row) * nrows)))
+		return SQL_SUCCESS;
+
+	initPQExpBuffer(&qstr);
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	for (i = 0, row = rows; i < nrows; i++, row++)
+	{
+		row->irow = irows[i];
+		row->global_ridx = global_ridxs[i];
+		row->kres_ridx = GIdx2KResIdx(row->global_ridx, stmt, res);
+		row->queried = FALSE;
+		row->qres = NULL;
+		row->ret = SQL_SUCCESS;
+		if (!keyset_driven &&
+		    (row->kres_ridx < 0 ||
+		     row->kres_ridx >= QR_get_num_cached_tuples(res) ||
+		     0 == (CURS_NEEDS_REREAD & res->keyset[row->kres_ridx].status)))
+			continue;
+		/* the same checks as SC_pos_reload_with_key() */
+		if (row->kres_ridx < 0 || row->kres_ridx >= res->num_cached_keys)
+		{
+			row->ret = SQL_ERROR;
+			continue;
+		}
+		use_ctid = (0 == (res->keyset[row->kres_ridx].status & CURS_SELF_ADDING));
+		if (!(row->oidint = getOid(res, row->kres_ridx)) &&
+		    !strcmp(SAFE_NAME(stmt->ti[0]->bestitem), OID_NAME))
+		{
+			row->ret = SQL_SUCCESS_WITH_INFO;
+			continue;
+		}
+		SPRINTF_FIXED(row->tidval, "(%u, %u)", res->keyset[row->kres_ridx].blocknum, res->keyset[row->kres_ridx].offset);
+		if (qstr.len > 0)
+			appendPQExpBufferChar(&qstr, ';');
+		if (!positioned_load_query(stmt, use_ctid ? LATEST_TUPLE_LOAD : 0, &row->oidint, use_ctid ? row->tidval : NULL, &qstr))
+			goto cleanup;
+		row->queried = TRUE;
+	}
+	*batched = TRUE;
+	*nprocessed = 0;
+	if (PQExpBufferDataBroken(qstr))
 	{
-		switch (ret)
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_refresh_rows()", func);
+		ret = SQL_ERROR;
+		goto cleanup;
+	}
+	if (qstr.len > 0)
+	{
+		MYLOG(0, "reload=%s\n", qstr.data);
+		qres = CC_send_query(SC_get_conn(stmt), qstr.data, NULL, READ_ONLY_QUERY, stmt);
+	}
+	for (tres = qres, row = rows, i = 0; i < nrows; row++, i++)
+	{
+		if (!row->queried)
+			continue;
+		row->qres = tres;
+		if (tres)
+			tres = QR_nextr(tres);
+	}
+
+	for (row = rows, i = 0; i < nrows; row++, i++)
+	{
+		if (row->queried)
+			row->ret = pos_reload_result(stmt, res, row->global_ridx, row->kres_ridx, TRUE, 0, res->keyset + row->kres_ridx, row->tidval, row->qres, &rcnt);
+		else if (SQL_ERROR == row->ret)
+			SC_set_error(stmt, STMT_ROW_OUT_OF_RANGE, "the target keys are out of the rowset", func);
+		else if (SQL_SUCCESS_WITH_INFO == row->ret)
+			SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the row was already deleted ?", func);
+		if (!SQL_SUCCEEDED(row->ret))
 		{
-			case SQL_SUCCESS:
-				irdflds->rowStatusArray[irow] = SQL_ROW_SUCCESS;
-				break;
-			case SQL_SUCCESS_WITH_INFO:
-				irdflds->rowStatusArray[irow] = SQL_ROW_SUCCESS_WITH_INFO;
-				break;
-			case SQL_ERROR:
-			default:
-				irdflds->rowStatusArray[irow] = SQL_ROW_ERROR;
-				break;
+			ret = row->ret;
+			i++;
+			break;
 		}
+		pos_refresh_fetch(stmt, row->irow, row->global_ridx);
 	}
+	*nprocessed = i;
 
-	return SQL_SUCCESS;
+cleanup:
+#undef	return
+	if (!PQExpBufferDataBroken(qstr))
+		termPQExpBuffer(&qstr);
+	QR_Destructor(qres);
+	free(rows);
+	return ret;
 }
 
 /*	SQL_NEED_DATA callback for PGAPI_SetPos */
@@ -4802,6 +5702,67 @@ typedef struct
 	UWORD	fOption;
 	SQLSETPOSIROW	irow, nrow, processed;
 }	spos_cdata;
+
+/*
+ *	Update, delete, add or refresh all the rows of the rowset to proceed
+ *	together.
+ *	Returns FALSE if the rows should be processed one by one.
+ */
+static BOOL
+spos_batch_rows(spos_cdata *s, RETCODE *ret)
+{
+	QResultClass	*res = s->res;
+	ARDFields	*opts = s->opts;
+	SQLSETPOSIROW	*irows, nrow;
+	SQLULEN		*global_ridxs, global_ridx;
+	SQLLEN		idx, kres_ridx, nrows = 0;
+	BOOL		batched = FALSE;
+
+	irows = (SQLSETPOSIROW *) malloc(sizeof(SQLSETPOSIROW) * (s->end_row + 1));
+	global_ridxs = (SQLULEN *) malloc(sizeof(SQLULEN) * (s->end_row + 1));
+	if (NULL == irows || NULL == global_ridxs)
+		goto cleanup;
+	/* the same rows as the loop in spos_callback() */
+	for (idx = 0, nrow = 0; nrow <= s->end_row; idx++)
+	{
+		global_ridx = RowIdx2GIdx(idx, s->stmt);
+		if (SQL_ADD != s->fOption)
+		{
+			if ((int) global_ridx >= QR_get_num_total_tuples(res))
+				break;
+			if (res->keyset)
+			{
+				kres_ridx = GIdx2KResIdx(global_ridx, s->stmt, res);
+				if (kres_ridx >= res->num_cached_keys)
+					break;
+				if (kres_ridx >= 0 &&
+				    0 == (res->keyset[kres_ridx].status & CURS_IN_ROWSET))
+					continue;
+			}
+		}
+		if (!opts->row_operation_ptr || opts->row_operation_ptr[nrow] == SQL_ROW_PROCEED)
+		{
+			irows[nrows] = nrow;
+			global_ridxs[nrows] = global_ridx;
+			nrows++;
+		}
+		nrow++;
+	}
+	if (SQL_ADD == s->fOption)
+		*ret = SC_pos_add_rows(s->stmt, nrows, irows, &batched);
+	else if (SQL_REFRESH == s->fOption)
+		*ret = SC_pos_refresh_rows(s->stmt, nrows, irows, global_ridxs, &nrows, &batched);
+	else
+		*ret = SC_pos_update_delete_rows(s->stmt, s->fOption, nrows, irows, global_ridxs, NULL, &batched);
+	if (batched)
+		s->processed = nrows;
+cleanup:
+	if (irows)
+		free(irows);
+	if (global_ridxs)
+		free(global_ridxs);
+	return batched;
+}
 static
 RETCODE spos_callback(RETCODE retcode, void *para)
 {
@@ -4837,6 +5798,11 @@ RETCODE spos_callback(RETCODE retcode, void *para)
 		SC_set_error(s->stmt, STMT_SEQUENCE_ERROR, "Passed res or opts for spos_callback is NULL", func);
 		return SQL_ERROR;
 	}
+	if (!s->need_data_callback &&
+	    0 == s->irow &&
+	    (SQL_UPDATE == s->fOption || SQL_DELETE == s->fOption || SQL_ADD == s->fOption || SQL_REFRESH == s->fOption) &&
+	    spos_batch_rows(s, &ret))
+		s->nrow = s->end_row + 1; /* all the rows are processed */
 	s->need_data_callback = FALSE;
 	for (; SQL_ERROR != ret && s->nrow <= s->end_row; s->idx++)
 	{
@@ -4950,6 +5916,8 @@ PGAPI_SetPos(HSTMT hstmt,
 		SC_log_error(func, NULL_STRING, NULL);
 		return SQL_INVALID_HANDLE;
 	}
+	if (SC_async_busy(s.stmt, func))
+		return SQL_ERROR;
 
 	s.irow = irow;
 	s.fOption = fOption;
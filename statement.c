@@ -172,7 +172,15 @@ static const struct
 	}
 };
 
-static QResultClass *libpq_bind_and_exec(StatementClass *stmt);
+static QResultClass *libpq_bind_and_exec(StatementClass *stmt, BOOL issue_begin);
+#ifdef	HAVE_PQENTERPIPELINEMODE
+static PGresult *ExecPipelined(StatementClass *stmt, BOOL issue_begin,
+						BOOL parse_and_describe, const char *query,
+						int nParams, const Oid *paramTypes,
+						const char * const *paramValues,
+						const int *paramLengths, const int *paramFormats,
+						int resultFormat);
+#endif /* HAVE_PQENTERPIPELINEMODE */
 static void SC_set_errorinfo(StatementClass *self, QResultClass *res, int errkind);
 static void SC_set_error_if_not_set(StatementClass *self, int errornumber, const char *errmsg, const char *func);
 
@@ -263,6 +271,7 @@ PGAPI_FreeStmt(HSTMT hstmt,
 		{
 			QResultClass	*res;
 
+			SC_async_abandon(stmt);
 			if (STMT_EXECUTING == stmt->status)
 			{
 				SC_set_error(stmt, STMT_SEQUENCE_ERROR, "Statement is currently executing a transaction.", func);
@@ -387,6 +396,11 @@ SC_Constructor(ConnectionClass *conn)
 	if (rv)
 	{
 		rv->hdbc = conn;
+		rv->conn_index = -1;
+		rv->prev_cursor_stmt = rv->next_cursor_stmt = NULL;
+		rv->async.allowed = rv->async.pending = FALSE;
+		rv->async.res = NULL;
+		rv->async.pgres = NULL;
 		rv->phstmt = NULL;
 		rv->rhold.first = rv->rhold.last = NULL;
 		rv->curres = NULL;
@@ -467,6 +481,7 @@ SC_Constructor(ConnectionClass *conn)
 		rv->callbacks = NULL;
 		GetDataInfoInitialize(SC_get_GDTI(rv));
 		PutDataInfoInitialize(SC_get_PDTI(rv));
+		ExecParamsInfoInitialize(SC_get_EPRM(rv));
 		rv->use_server_side_prepare = conn->connInfo.use_server_side_prepare;
 		rv->lock_CC_for_rb = FALSE;
 		// for batch execution
@@ -490,6 +505,7 @@ SC_Destructor(StatementClass *self)
 
 	MYLOG(0, "entering self=%p, self->result=%p, self->hdbc=%p\n", self, res, self->hdbc);
 	SC_clear_error(self);
+	SC_async_abandon(self);
 	if (STMT_EXECUTING == self->status)
 	{
 		SC_set_error(self, STMT_SEQUENCE_ERROR, "Statement is currently executing a transaction.", func);
@@ -528,6 +544,7 @@ SC_Destructor(StatementClass *self)
 	DC_Destructor((DescriptorClass *) SC_get_IPDi(self));
 	GDATA_unbind_cols(SC_get_GDTI(self), TRUE);
 	PDATA_free_params(SC_get_PDTI(self), STMT_FREE_PARAMS_ALL);
+	EPARAMS_free(SC_get_EPRM(self));
 
 	if (self->__error_message)
 		free(self->__error_message);
@@ -571,6 +588,8 @@ SC_set_Result(StatementClass *self, QResultClass *first)
 		self->curres = first;
 		self->rhold.first = first;
 		self->rhold.last = last;
+		if (first && QR_get_cursor(first) && self->hdbc)
+			CC_add_cursor_statement(self->hdbc, self);
 	}
 }
 
@@ -585,6 +604,8 @@ SC_set_ResultHold(StatementClass *self, QResultHold rhold)
 		QR_Destructor(self->rhold.first);
 		self->curres = rhold.first;
 		self->rhold = rhold;
+		if (rhold.first && QR_get_cursor(rhold.first) && self->hdbc)
+			CC_add_cursor_statement(self->hdbc, self);
 	}
 	else if (rhold.last != self->rhold.last)
 	{
@@ -712,22 +733,9 @@ SC_set_prepared(StatementClass *stmt, int prepared)
 		if (conn)
 		{
 			ENTER_CONN_CS(conn);
+			/* DEALLOCATEd together with the next query */
 			if (CONN_CONNECTED == conn->status)
-			{
-				if (CC_is_in_error_trans(conn))
-				{
-					CC_mark_a_object_to_discard(conn, 's',  stmt->plan_name);
-				}
-				else
-				{
-					QResultClass	*res;
-					char dealloc_stmt[128];
-
-					SPRINTF_FIXED(dealloc_stmt, "DEALLOCATE \"%s\"", stmt->plan_name);
-					res = CC_send_query(conn, dealloc_stmt, NULL, IGNORE_ABORT_ON_CONN | ROLLBACK_ON_ERROR, NULL);
-					QR_Destructor(res);
-				}
-			}
+				CC_mark_a_object_to_discard(conn, 's',  stmt->plan_name);
 			LEAVE_CONN_CS(conn);
 		}
 	}
@@ -800,6 +808,83 @@ SC_initialize_stmts(StatementClass *self, BOOL initializeOriginal)
 	return 0;
 }
 
+/*
+ *	The connection remembers the statement in flight, so that the other
+ *	statements see it's busy without looking at each of them.
+ */
+static void
+SC_set_async_pending(StatementClass *self, BOOL pending)
+{
+	ConnectionClass	*conn = SC_get_conn(self);
+
+	self->async.pending = pending;
+	if (NULL == conn)
+		return;
+	if (pending)
+		conn->async_stmt = self;
+	else if (conn->async_stmt == self)
+		conn->async_stmt = NULL;
+}
+
+/*
+ *	While an asynchronous execution is in flight only the function being
+ *	polled, SQLCancel() and SQLFreeStmt() may be called for the statement,
+ *	and the other statements can't use the connection.
+ */
+BOOL
+SC_async_busy(StatementClass *self, const char *func)
+{
+	ConnectionClass	*conn = SC_get_conn(self);
+
+	if (SC_is_async_pending(self))
+		SC_set_error(self, STMT_STILL_EXECUTING, "An asynchronous execution of the statement is in progress.", func);
+	else if (NULL != conn && CC_async_pending(conn))
+		SC_set_error(self, STMT_STILL_EXECUTING, "An asynchronous execution is in progress on the connection.", func);
+	else
+		return FALSE;
+
+	return TRUE;
+}
+
+/*
+ *	Give up the asynchronous execution in flight when the statement is
+ *	closed or freed. The query is cancelled and the rest of its results
+ *	are read and thrown away, so that the connection is blocking and
+ *	usable again.
+ */
+void
+SC_async_abandon(StatementClass *self)
+{
+	ConnectionClass	*conn = SC_get_conn(self);
+	PGconn		*pqconn;
+	PGresult	*pgres;
+
+	if (!SC_is_async_pending(self))
+		return;
+	MYLOG(0, "abandoning the asynchronous execution of stmt=%p\n", self);
+	if (NULL != conn && NULL != (pqconn = conn->pqconn))
+	{
+		ENTER_CONN_CS(conn);
+		/* this sends what's left of the request */
+		PQsetnonblocking(pqconn, 0);
+		if (PQisBusy(pqconn))
+			CC_send_cancel_request(conn);
+		while (pgres = PQgetResult(pqconn), NULL != pgres)
+			PQclear(pgres);
+		LIBPQ_update_transaction_status(conn);
+		if (CONN_DOWN != conn->status)
+			conn->status = self->async.conn_status;
+		LEAVE_CONN_CS(conn);
+	}
+	if (NULL != self->async.pgres)
+		PQclear((PGresult *) self->async.pgres);
+	QR_Destructor(self->async.res);
+	self->async.res = NULL;
+	self->async.pgres = NULL;
+	SC_set_async_pending(self, FALSE);
+	SC_SetExecuting(self, FALSE);
+}
+
 /** 
  *  @brief Is the statement currently executing a transaction or cursor
  *  @param[in] self 
@@ -817,6 +902,8 @@ BOOL	SC_opencheck(StatementClass *self, const char *func)
 		SC_set_error(self, STMT_SEQUENCE_ERROR, "Statement is currently executing a transaction.", func);
 		return TRUE;
 	}
+	if (SC_async_busy(self, func))
+		return TRUE;
 	/*
 	 * We can dispose the result of Describe-only any time.
 	 */
@@ -881,6 +968,7 @@ SC_recycle_statement(StatementClass *self)
 	MYLOG(0, "entering self=%p\n", self);
 
 	SC_clear_error(self);
+	SC_async_abandon(self);
 	/* This would not happen */
 	if (self->status == STMT_EXECUTING)
 	{
@@ -1914,6 +2002,17 @@ SC_execute(StatementClass *self)
 	conn = SC_get_conn(self);
 	ci = &(conn->connInfo);
 
+	if (SC_is_async_pending(self))
+	{
+		/* called again to complete an asynchronous execution */
+		ENTER_INNER_CONN_CS(conn, func_cs_count);
+		oldstatus = self->async.conn_status;
+		is_in_trans = self->async.is_in_trans;
+		isSelectType = self->async.is_select;
+		useCursor = issue_begin = FALSE;
+		use_extended_protocol = TRUE;
+		goto resume_async;
+	}
 	errnum_sav = SC_get_errornumber(self);
 	errmsg_sav = SC_get_errormsg(self);
 	if (NULL != errmsg_sav)
@@ -2029,16 +2128,21 @@ SC_execute(StatementClass *self)
 		use_extended_protocol = TRUE;
 	}
 	isSelectType = (SC_may_use_cursor(self) || self->statement_type == STMT_TYPE_PROCCALL);
+resume_async:
 	if (use_extended_protocol)
 	{
 		QResultClass *first;
 
-		if (issue_begin)
-			CC_begin(conn);
-
-		first = libpq_bind_and_exec(self);
+		first = libpq_bind_and_exec(self, issue_begin);
 		if (!first)
 		{
+			if (SC_is_async_pending(self))
+			{
+				self->async.conn_status = oldstatus;
+				self->async.is_in_trans = is_in_trans;
+				self->async.is_select = isSelectType;
+				goto cleanup;
+			}
 			if (SC_get_errornumber(self) <= 0)
 			{
 				SC_set_error(self, STMT_NO_RESPONSE, "Could not receive the response, communication down ??", func);
@@ -2062,7 +2166,12 @@ SC_execute(StatementClass *self)
 		{
 			qi.result_in = NULL;
 			qi.cursor = SC_cursor_name(self);
+			qi.cursors = NULL;
 			qi.fetch_size = qi.row_size = ci->drivers.fetch_max;
+			/* don't fetch the rows beyond SQL_ATTR_MAX_ROWS */
+			if (SC_is_max_rows_cursor(self, ci) ||
+			    (self->options.maxRows > 0 && qi.fetch_size > self->options.maxRows))
+				qi.fetch_size = qi.row_size = self->options.maxRows;
 			SPRINTF_FIXED(fetch,
 					 "fetch " FORMAT_LEN " in \"%s\"",
 					 qi.fetch_size, SC_cursor_name(self));
@@ -2114,8 +2223,19 @@ SC_execute(StatementClass *self)
 				first = qres;
 				rhold.first = first;
 			}
+			if (first)
+				QR_rows_before_max(first, self);
 			if (first && SC_is_with_hold(self))
 				QR_set_withhold(first);
+			/*
+			 * The rows within SQL_ATTR_MAX_ROWS have all arrived, so
+			 * don't keep the cursor, nor the transaction begun for it
+			 * in autocommit mode, open until they are read.
+			 */
+			if (first && SC_is_max_rows_cursor(self, ci) &&
+			    QR_command_maybe_successful(first) &&
+			    QR_once_reached_eof(first))
+				QR_close(first);	/* a failure is reported in the result */
 		}
 		MYLOG(0, "     done sending the query:\n");
 	}
@@ -2327,12 +2447,20 @@ MYLOG(DETAIL_LOG_LEVEL, "!!SC_fetch return =%d\n", ret);
 
 		if (ci->fetch_refcursors)
 		{
-			char			fetch[128];
+			PQExpBufferData	fetch = {0};
 			QResultClass 	*last = NULL, *res;
 			BOOL			refcursor_found = FALSE;
+			const char		**cursors;
+			int				ncursors = 0;
 
 			/* Iterate the columns in the result to look for refcursors */
 			numcols = QR_NumResultCols(rhold.first);
+			if (cursors = (const char **) malloc(sizeof(char *) * (numcols + 1)), NULL == cursors)
+			{
+				SC_set_error(self, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for refcursors", func);
+				numcols = 0;
+			}
+			initPQExpBuffer(&fetch);
 			for (i = 0; i < numcols; i++)
 			{
 				MYLOG(DETAIL_LOG_LEVEL, "!!! numfield=%d field_type=%u\n", numcols, QR_get_field_type(rhold.first, i));
@@ -2350,27 +2478,34 @@ MYLOG(DETAIL_LOG_LEVEL, "!!SC_fetch return =%d\n", ret);
 					if (!SC_cursor_is_valid(self))
 						continue;
 
-					SC_set_fetchcursor(self);
-					qi.result_in = NULL;
-					qi.cursor = SC_cursor_name(self);
-					qi.fetch_size = qi.row_size = ci->drivers.fetch_max;
-					SPRINTF_FIXED(fetch, "fetch " FORMAT_LEN " in \"%s\"", qi.fetch_size, SC_cursor_name(self));
-					res = CC_send_query(conn, fetch, &qi, qflag | READ_ONLY_QUERY, SC_get_ancestor(self));
-					if (NULL != res)
+					/* the refcursors are fetched with one multiple command query */
+					cursors[ncursors++] = QR_get_value_backend_text(rhold.first, 0, i);
+					appendPQExpBuffer(&fetch, "%sfetch " FORMAT_LEN " in \"%s\"",
+									  ncursors > 1 ? ";" : "",
+									  (SQLLEN) ci->drivers.fetch_max,
+									  cursors[ncursors - 1]);
+				}
+			}
+			if (ncursors > 0 && PQExpBufferDataBroken(fetch))
+				SC_set_error(self, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for refcursors", func);
+			else if (ncursors > 0)
+			{
+				cursors[ncursors] = NULL;
+				SC_set_fetchcursor(self);
+				qi.result_in = NULL;
+				qi.cursor = NULL;
+				qi.cursors = cursors;	/* each result has its own cursor */
+				qi.fetch_size = qi.row_size = ci->drivers.fetch_max;
+				res = CC_send_query(conn, fetch.data, &qi, qflag | READ_ONLY_QUERY, SC_get_ancestor(self));
+				if (NULL != res)
+				{
+					/* Reinitialise with the results fetched from the refcursors */
+					SC_init_Result(self);
+					SC_set_Result(self, res);
+					if (NULL != QR_nextr(res))
+						self->multi_statement = TRUE;
+					for (last = res; NULL != res; res = QR_nextr(res))
 					{
-						if (NULL == last)
-						{
-							/* Reinitialise with result fetched from first refcursor */
-							SC_init_Result(self);
-							SC_set_Result(self, res);
-						}
-						else
-						{
-							/* Add another result fetched from the next refcursor */
-							QR_concat(last, res);
-							self->multi_statement = TRUE;
-						}
-						last = res;
 						if (!QR_command_maybe_successful(res))
 						{
 							SC_set_errorinfo(self, res, 0);
@@ -2379,6 +2514,9 @@ MYLOG(DETAIL_LOG_LEVEL, "!!SC_fetch return =%d\n", ret);
 					}
 				}
 			}
+			termPQExpBuffer(&fetch);
+			if (cursors)
+				free(cursors);
 			if (refcursor_found)
 			{
 				/* Discard original result */
@@ -2391,6 +2529,14 @@ MYLOG(DETAIL_LOG_LEVEL, "!!SC_fetch return =%d\n", ret);
 	}
 cleanup:
 #undef	return
+	if (SC_is_async_pending(self))
+	{
+		/* the request is in flight, the statement is still executing */
+		CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
+		if (NULL != errmsg_sav)
+			free(errmsg_sav);
+		return SQL_STILL_EXECUTING;
+	}
 	SC_SetExecuting(self, FALSE);
 	CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
 	if (CONN_DOWN != conn->status)
@@ -2538,8 +2684,16 @@ SC_log_error(const char *func, const char *desc, const StatementClass *self)
  *	Extended Query
  */
 
+/*
+ * Start a request in the current transaction.
+ *
+ * If 'begin_deferred' is not NULL, the caller sends the internal SAVEPOINT
+ * (conn->internal_op is set to PREPEND_IN_PROGRESS) and the implicit BEGIN
+ * (*begin_deferred is set to TRUE) together with the request itself.
+ */
 static BOOL
-RequestStart(StatementClass *stmt, ConnectionClass *conn, const char *func)
+RequestStart(StatementClass *stmt, ConnectionClass *conn, const char *func,
+			 BOOL *begin_deferred)
 {
 	BOOL	ret = TRUE;
 	unsigned int	svpopt = 0;
@@ -2557,6 +2711,8 @@ RequestStart(StatementClass *stmt, ConnectionClass *conn, const char *func)
 		return TRUE;
 	if (SC_is_readonly(stmt))
 		svpopt |= SVPOPT_RDONLY;
+	if (begin_deferred)
+		svpopt |= SVPOPT_REDUCE_ROUNDTRIP;
 	if (SQL_ERROR == SetStatementSvp(stmt, svpopt))
 	{
 		char	emsg[128];
@@ -2574,11 +2730,51 @@ RequestStart(StatementClass *stmt, ConnectionClass *conn, const char *func)
 	if (!CC_is_in_trans(conn) && CC_loves_visible_trans(conn) &&
 		stmt->statement_type != STMT_TYPE_SPECIAL)
 	{
-		ret = CC_begin(conn);
+		if (begin_deferred)
+			*begin_deferred = TRUE;
+		else
+			ret = CC_begin(conn);
 	}
 	return ret;
 }
 
+#ifdef	HAVE_PQENTERPIPELINEMODE
+/*
+ * Can BEGIN/SAVEPOINT be sent together with the execution of the statement ?
+ *
+ * Not if binding the parameters may create large objects, which must be
+ * done after them (see ResolveOneParam()).
+ */
+static BOOL
+RequestStartCanBeDeferred(const StatementClass *stmt)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	const IPDFields	*ipdopts = SC_get_IPDF(stmt);
+	int		i;
+	OID		pgtype;
+
+	if (NULL == conn->pqconn ||
+		PQ_PIPELINE_OFF != PQpipelineStatus(conn->pqconn))
+		return FALSE;
+	for (i = 0; i < stmt->num_params && i < ipdopts->allocated; i++)
+	{
+		pgtype = PIC_dsp_pgtype(conn, ipdopts->parameters[i]);
+		if (pgtype == conn->lobj_type ||
+			(PG_TYPE_OID == pgtype && conn->lo_is_domain))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/*
+ * Is BEGIN or SAVEPOINT deferred by RequestStart() still to be sent ?
+ */
+#define	RequestStartIsDeferred(conn, begin_deferred) \
+	(((begin_deferred) && !CC_is_in_trans(conn)) || \
+	 PREPEND_IN_PROGRESS == (conn)->internal_op)
+#endif /* HAVE_PQENTERPIPELINEMODE */
+
 static void log_params(int nParams, const Oid *paramTypes, const UCHAR * const *paramValues, const int *paramLengths, const int *paramFormats, int resultFormat)
 {
 	int	i, j;
@@ -2616,8 +2812,78 @@ QResultClass *add_libpq_notice_receiver(StatementClass *stmt, notice_receiver_ar
 	return newres;
 }
 
+/*
+ *	Make progress with an asynchronous execution without blocking.
+ *	Returns TRUE when the whole response has been received. Then
+ *	stmt->async.pgres holds the result the same as PQexecXxxx()
+ *	would have returned.
+ */
+static BOOL
+SC_async_poll(StatementClass *stmt)
+{
+	CSTR		func = "SC_async_poll";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	PGconn		*pqconn = conn->pqconn;
+	PGresult	*pgres, *last;
+	notice_receiver_arg	nrarg;
+	BOOL		done = FALSE;
+
+	if (NULL == pqconn)
+		return TRUE;
+	if (!stmt->async.flushed)
+	{
+		int	ret = PQflush(pqconn);
+
+		if (ret > 0)
+		{
+			/* the server may be waiting for us to read */
+			if (CC_socket_ready(conn, FALSE))
+				PQconsumeInput(pqconn);
+			return FALSE;
+		}
+		stmt->async.flushed = TRUE;
+	}
+	nrarg.conn = conn;
+	nrarg.comment = func;
+	nrarg.res = stmt->async.res;
+	nrarg.stmt = stmt;
+	PQsetNoticeReceiver(pqconn, receive_libpq_notice, &nrarg);
+	for (;;)
+	{
+		if (PQisBusy(pqconn))
+		{
+			if (!CC_socket_ready(conn, FALSE))
+				break;
+			/* on failure PQgetResult() returns the error at once */
+			if (PQconsumeInput(pqconn) && PQisBusy(pqconn))
+				break;
+		}
+		if (pgres = PQgetResult(pqconn), NULL == pgres)
+		{
+			done = TRUE;
+			break;
+		}
+		/* keep the last result but don't lose an error */
+		last = (PGresult *) stmt->async.pgres;
+		if (NULL != last && PGRES_FATAL_ERROR == PQresultStatus(last))
+			PQclear(pgres);
+		else
+		{
+			if (NULL != last)
+				PQclear(last);
+			stmt->async.pgres = pgres;
+		}
+	}
+	PQsetNoticeReceiver(pqconn, receive_libpq_notice, NULL);
+	if (done)
+		PQsetnonblocking(pqconn, 0);
+	MYLOG(DETAIL_LOG_LEVEL, "stmt=%p done=%d\n", stmt, done);
+
+	return done;
+}
+
 static QResultClass *
-libpq_bind_and_exec(StatementClass *stmt)
+libpq_bind_and_exec(StatementClass *stmt, BOOL issue_begin)
 {
 	CSTR		func = "libpq_bind_and_exec";
 	ConnectionClass	*conn = SC_get_conn(stmt);
@@ -2634,10 +2900,54 @@ libpq_bind_and_exec(StatementClass *stmt)
 	char	   *cmdtag;
 	char	   *rowcount;
 	notice_receiver_arg	nrarg;
+	BOOL		begin_deferred = FALSE, *defer_begin = NULL;
+	BOOL		async = stmt->async.allowed, sent = TRUE;
+#ifdef	HAVE_PQENTERPIPELINEMODE
+	BOOL		parse_and_describe = FALSE, discard_pipelined = FALSE;
+#endif /* HAVE_PQENTERPIPELINEMODE */
 
-	if (!RequestStart(stmt, conn, func))
+	if (SC_is_async_pending(stmt))
+	{
+		/* called again to complete an asynchronous execution */
+		if (!SC_async_poll(stmt))
+			return NULL;
+		res = newres = stmt->async.res;
+		pgres = (PGresult *) stmt->async.pgres;
+		stmt->async.res = NULL;
+		stmt->async.pgres = NULL;
+		SC_set_async_pending(stmt, FALSE);
+		goto receive_results;
+	}
+#ifdef	HAVE_PQENTERPIPELINEMODE
+	/*
+	 * BEGIN, SAVEPOINT and the execution can be sent in a pipeline,
+	 * see ExecPipelined().
+	 */
+	if (!async && RequestStartCanBeDeferred(stmt))
+		defer_begin = &begin_deferred;
+#endif /* HAVE_PQENTERPIPELINEMODE */
+	if (issue_begin)
+	{
+		if (defer_begin)
+			begin_deferred = TRUE;
+		else
+			CC_begin(conn);
+	}
+
+	if (!RequestStart(stmt, conn, func, defer_begin))
 		return NULL;
 
+	/*
+	 * The objects marked to be discarded go ahead of the execution, in
+	 * the same pipeline if possible (see CC_pipeline_marked_objects()).
+	 */
+#ifdef	HAVE_PQENTERPIPELINEMODE
+	discard_pipelined = (NULL != defer_begin &&
+						 !CC_is_in_trans(conn) && CC_discard_pending(conn));
+	if (!discard_pipelined)
+#endif /* HAVE_PQENTERPIPELINEMODE */
+	CC_discard_marked_objects(conn);
+
 #ifdef	NOT_USED
 	if (CC_is_in_trans(conn) && !CC_started_rbpoint(conn))
 	{
@@ -2688,18 +2998,42 @@ libpq_bind_and_exec(StatementClass *stmt)
 		}
 
 		pstmt = stmt->processed_statements;
-		QLOG(0, "PQexecParams: %p '%s' nParams=%d\n", conn->pqconn, pstmt->query, nParams);
 		log_params(nParams, paramTypes, (const UCHAR * const *) paramValues, paramLengths, paramFormats, resultFormat);
 		/* set notice receiver */
 		newres = add_libpq_notice_receiver(stmt, &nrarg);
-		pgres = PQexecParams(conn->pqconn,
-							 pstmt->query,
-							 nParams,
-							 paramTypes,
-							 (const char **) paramValues,
-							 paramLengths,
-							 paramFormats,
-							 resultFormat);
+#ifdef	HAVE_PQENTERPIPELINEMODE
+		if (discard_pipelined || RequestStartIsDeferred(conn, begin_deferred))
+			pgres = ExecPipelined(stmt, begin_deferred, FALSE,
+							pstmt->query, nParams, paramTypes,
+							(const char * const *) paramValues, paramLengths, paramFormats,
+							resultFormat);
+		else
+#endif /* HAVE_PQENTERPIPELINEMODE */
+		if (async)
+		{
+			QLOG(0, "PQsendQueryParams: %p '%s' nParams=%d (async)\n", conn->pqconn, pstmt->query, nParams);
+			sent = (0 == PQsetnonblocking(conn->pqconn, 1) &&
+					PQsendQueryParams(conn->pqconn,
+								 pstmt->query,
+								 nParams,
+								 paramTypes,
+								 (const char **) paramValues,
+								 paramLengths,
+								 paramFormats,
+								 resultFormat));
+		}
+		else
+		{
+			QLOG(0, "PQexecParams: %p '%s' nParams=%d\n", conn->pqconn, pstmt->query, nParams);
+			pgres = PQexecParams(conn->pqconn,
+								 pstmt->query,
+								 nParams,
+								 paramTypes,
+								 (const char **) paramValues,
+								 paramLengths,
+								 paramFormats,
+								 resultFormat);
+		}
 	}
 	else
 	{
@@ -2707,23 +3041,61 @@ libpq_bind_and_exec(StatementClass *stmt)
 
 		if (stmt->prepared == PREPARING_PERMANENTLY)
 		{
+#ifdef	HAVE_PQENTERPIPELINEMODE
+			/*
+			 * A single statement can be parsed, described and executed
+			 * in one round trip.
+			 */
+			if (prepareParametersNoDesc(stmt, FALSE, PARSE_PARAM_CAST) == SQL_ERROR)
+				goto cleanup;
+			parse_and_describe = (!async &&
+						 NULL == stmt->processed_statements->next &&
+						 PQ_PIPELINE_OFF == PQpipelineStatus(conn->pqconn));
+			/* the query is already processed, only describe it */
+			if (!parse_and_describe &&
+				desc_params_and_sync(stmt) == SQL_ERROR)
+				goto cleanup;
+#else
 			if (prepareParameters(stmt, FALSE) == SQL_ERROR)
 				goto cleanup;
+#endif /* HAVE_PQENTERPIPELINEMODE */
 		}
 
 		/* prepareParameters() set plan name, so don't fetch this earlier */
 		plan_name = stmt->plan_name ? stmt->plan_name : NULL_STRING;
 
-		/* already prepared */
-		QLOG(0, "PQexecPrepared: %p plan=%s nParams=%d\n", conn->pqconn, plan_name, nParams);
 		log_params(nParams, paramTypes, (const UCHAR * const *) paramValues, paramLengths, paramFormats, resultFormat);
 		/* set notice receiver */
 		newres = add_libpq_notice_receiver(stmt, &nrarg);
-		pgres = PQexecPrepared(conn->pqconn,
-							   plan_name, 	/* portal name == plan name */
-							   nParams,
-							   (const char **) paramValues, paramLengths, paramFormats,
-							   resultFormat);
+#ifdef	HAVE_PQENTERPIPELINEMODE
+		if (parse_and_describe || discard_pipelined ||
+			RequestStartIsDeferred(conn, begin_deferred))
+			pgres = ExecPipelined(stmt, begin_deferred, parse_and_describe,
+							NULL, nParams, NULL,
+							(const char * const *) paramValues, paramLengths, paramFormats,
+							resultFormat);
+		else
+#endif /* HAVE_PQENTERPIPELINEMODE */
+		if (async)
+		{
+			QLOG(0, "PQsendQueryPrepared: %p plan=%s nParams=%d (async)\n", conn->pqconn, plan_name, nParams);
+			sent = (0 == PQsetnonblocking(conn->pqconn, 1) &&
+					PQsendQueryPrepared(conn->pqconn,
+								   plan_name, 	/* portal name == plan name */
+								   nParams,
+								   (const char **) paramValues, paramLengths, paramFormats,
+								   resultFormat));
+		}
+		else
+		{
+			/* already prepared */
+			QLOG(0, "PQexecPrepared: %p plan=%s nParams=%d\n", conn->pqconn, plan_name, nParams);
+			pgres = PQexecPrepared(conn->pqconn,
+								   plan_name, 	/* portal name == plan name */
+								   nParams,
+								   (const char **) paramValues, paramLengths, paramFormats,
+								   resultFormat);
+		}
 	}
 	/* reset notice receiver */
 	PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, NULL);
@@ -2732,8 +3104,29 @@ libpq_bind_and_exec(StatementClass *stmt)
 		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory while allocating result set", func);
 		goto cleanup;
 	}
+	if (async)
+	{
+		if (!sent)
+		{
+			PQsetnonblocking(conn->pqconn, 0);
+			SC_set_error(stmt, STMT_EXEC_ERROR, PQerrorMessage(conn->pqconn), func);
+			QR_Destructor(res);
+			res = NULL;
+			goto cleanup;
+		}
+		/*
+		 * The result is received by SC_async_poll() in this and
+		 * the following calls.
+		 */
+		SC_set_async_pending(stmt, TRUE);
+		stmt->async.flushed = FALSE;
+		stmt->async.res = res;
+		stmt->async.pgres = NULL;
+		return libpq_bind_and_exec(stmt, FALSE);
+	}
 
 	/* 3. Receive results */
+receive_results:
 MYLOG(DETAIL_LOG_LEVEL, "get_Result=%p %p\n", res, SC_get_Result(stmt));
 	pgresstatus = PQresultStatus(pgres);
 	switch (pgresstatus)
@@ -2790,51 +3183,34 @@ MYLOG(DETAIL_LOG_LEVEL, "get_Result=%p %p\n", res, SC_get_Result(stmt));
 		QR_Destructor(newres);
 
 cleanup:
+#ifdef	HAVE_PQENTERPIPELINEMODE
+	/*
+	 * If the request failed before the deferred SAVEPOINT was sent, send
+	 * it now so that the error can be rolled back to it as usual.
+	 */
+	if (NULL == res && PREPEND_IN_PROGRESS == conn->internal_op)
+		RequestStart(stmt, conn, func, NULL);
+#endif /* HAVE_PQENTERPIPELINEMODE */
+	/* the parameter arrays belong to stmt->exec_params */
 	if (pgres)
 		PQclear(pgres);
-	if (paramValues)
-	{
-		int			i;
-		for (i = 0; i < nParams; i++)
-		{
-			if (paramValues[i] != NULL)
-				free(paramValues[i]);
-		}
-		free(paramValues);
-	}
-	if (paramTypes)
-		free(paramTypes);
-	if (paramLengths)
-		free(paramLengths);
-	if (paramFormats)
-		free(paramFormats);
 
 	return res;
 }
 
 /*
- * Parse a query using libpq.
+ * Collect the parameter types to send with the Parse message of a query.
  *
- * 'res' is only passed here for error reporting purposes. If an error is
- * encountered, it is set in 'res', and the function returns FALSE.
+ * Returns the number of the parameters, or -1 on error.
  */
-static BOOL
-ParseWithLibpq(StatementClass *stmt, const char *plan_name,
-			   const char *query,
-			   Int2 num_params, const char *comment, QResultClass *res)
+static Int2
+parse_param_types(StatementClass *stmt, Int2 num_params, Oid **pparamTypes)
 {
-	CSTR	func = "ParseWithLibpq";
 	ConnectionClass	*conn = SC_get_conn(stmt);
 	Int4		sta_pidx = -1, end_pidx = -1;
-	const char	*cstatus;
 	Oid		   *paramTypes = NULL;
-	BOOL		retval = FALSE;
-	PGresult   *pgres = NULL;
-
-	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query);
-	if (!RequestStart(stmt, conn, func))
-		return FALSE;
 
+	*pparamTypes = NULL;
 	if (stmt->discard_output_params)
 		num_params = 0;
 	else if (num_params != 0)
@@ -2886,7 +3262,7 @@ MYLOG(0, "sta_pidx=%d end_pidx=%d num_p=%d\n", sta_pidx, end_pidx, num_params);
 		if (paramTypes == NULL)
 		{
 			SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
-			goto cleanup;
+			return -1;
 		}
 
 		MYLOG(0, "ipdopts->allocated: %d\n", ipdopts->allocated);
@@ -2908,17 +3284,25 @@ MYLOG(0, "sta_pidx=%d end_pidx=%d num_p=%d\n", sta_pidx, end_pidx, num_params);
 			}
 		}
 	}
+	*pparamTypes = paramTypes;
 
-	if (plan_name == NULL || plan_name[0] == '\0')
-		conn->unnamed_prepared_stmt = NULL;
+	return num_params;
+}
+
+/*
+ * Process the result of a Parse (PQprepare) request.
+ */
+static BOOL
+parse_result_with_libpq(StatementClass *stmt, const char *plan_name,
+						PGresult *pgres, QResultClass *res)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	const char	*cstatus;
 
-	/* Prepare */
-	QLOG(0, "PQprepare: %p '%s' plan=%s nParams=%d\n", conn->pqconn, query, plan_name, num_params);
-	pgres = PQprepare(conn->pqconn, plan_name, query, num_params, paramTypes);
 	if (PQresultStatus(pgres) != PGRES_COMMAND_OK)
 	{
 		handle_pgres_error(conn, pgres, "ParseWithlibpq", res, TRUE);
-		goto cleanup;
+		return FALSE;
 	}
 	cstatus = PQcmdStatus(pgres);
 	QLOG(0, "\tok: - 'C' - %s\n", cstatus);
@@ -2930,7 +3314,42 @@ MYLOG(0, "sta_pidx=%d end_pidx=%d num_p=%d\n", sta_pidx, end_pidx, num_params);
 	if (plan_name == NULL || plan_name[0] == '\0')
 		conn->unnamed_prepared_stmt = stmt;
 
-	retval = TRUE;
+	return TRUE;
+}
+
+/*
+ * Parse a query using libpq.
+ *
+ * 'res' is only passed here for error reporting purposes. If an error is
+ * encountered, it is set in 'res', and the function returns FALSE.
+ */
+static BOOL
+ParseWithLibpq(StatementClass *stmt, const char *plan_name,
+			   const char *query,
+			   Int2 num_params, const char *comment, QResultClass *res)
+{
+	CSTR	func = "ParseWithLibpq";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	Oid		   *paramTypes = NULL;
+	BOOL		retval = FALSE;
+	PGresult   *pgres = NULL;
+
+	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query);
+	if (!RequestStart(stmt, conn, func, NULL))
+		return FALSE;
+	/* the plan may be waiting to be DEALLOCATEd */
+	CC_discard_marked_objects(conn);
+
+	if (num_params = parse_param_types(stmt, num_params, &paramTypes), num_params < 0)
+		goto cleanup;
+
+	if (plan_name == NULL || plan_name[0] == '\0')
+		conn->unnamed_prepared_stmt = NULL;
+
+	/* Prepare */
+	QLOG(0, "PQprepare: %p '%s' plan=%s nParams=%d\n", conn->pqconn, query, plan_name, num_params);
+	pgres = PQprepare(conn->pqconn, plan_name, query, num_params, paramTypes);
+	retval = parse_result_with_libpq(stmt, plan_name, pgres, res);
 
 cleanup:
 	if (paramTypes)
@@ -2944,24 +3363,17 @@ cleanup:
 
 
 /*
- * Parse and describe a query using libpq.
- *
- * Returns an empty result set that has the column information, or error code
- * and message, filled in. If 'res' is not NULL, it is the result set
- * returned, otherwise a new one is allocated.
+ * Process the result of a Describe (PQdescribePrepared) request.
  *
- * NB: The caller must set stmt->current_exec_param before calling this
- * function!
+ * The parameter types are stored in the IPD and the column information
+ * in 'res'.
  */
-QResultClass *
-ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name,
-						  const char *query_param,
-						  Int2 num_params, const char *comment,
-						  QResultClass *res)
+static void
+describe_result_with_libpq(StatementClass *stmt, PGresult *pgres,
+						   QResultClass *res)
 {
 	CSTR	func = "ParseAndDescribeWithLibpq";
 	ConnectionClass	*conn = SC_get_conn(stmt);
-	PGresult   *pgres = NULL;
 	int			num_p;
 	Int2		num_discard_params;
 	IPDFields	*ipdopts;
@@ -2970,30 +3382,6 @@ ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name,
 	Oid			oid;
 	SQLSMALLINT paramType;
 
-	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query_param);
-	if (!RequestStart(stmt, conn, func))
-		return NULL;
-
-	if (!res)
-		res = QR_Constructor();
-	if (!res)
-	{
-		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for query", func);
-		return NULL;
-	}
-
-	/*
-	 * We need to do Prepare + Describe as two different round-trips to the
-	 * server, while before we switched to use libpq, we used to send a Parse
-	 * and Describe message followed by a single Sync.
-	 */
-	if (!ParseWithLibpq(stmt, plan_name, query_param, num_params, comment, res))
-		goto cleanup;
-
-	/* Describe */
-	QLOG(0, "\tPQdescribePrepared: %p plan_name=%s\n", conn->pqconn, plan_name);
-
-	pgres = PQdescribePrepared(conn->pqconn, plan_name);
 	switch (PQresultStatus(pgres))
 	{
 		case PGRES_COMMAND_OK:
@@ -3002,17 +3390,17 @@ ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name,
 			break;
 		case PGRES_NONFATAL_ERROR:
 			handle_pgres_error(conn, pgres, "ParseAndDescribeWithLibpq", res, FALSE);
-			goto cleanup;
+			return;
 		case PGRES_FATAL_ERROR:
 			handle_pgres_error(conn, pgres, "ParseAndDescribeWithLibpq", res, TRUE);
-			goto cleanup;
+			return;
 		default:
 			/* skip the unexpected response if possible */
 			CC_set_error(conn, CONNECTION_BACKEND_CRAZY, "Unexpected result from PQdescribePrepared", func);
 			CC_on_abort(conn, CONN_DEAD);
 
 			MYLOG(0, "PQdescribePrepared: error - %s\n", CC_get_errormsg(conn));
-			goto cleanup;
+			return;
 	}
 
 	/* Extract parameter information from the result set */
@@ -3104,6 +3492,54 @@ MYLOG(DETAIL_LOG_LEVEL, "num_params=%d info=%d\n", stmt->num_params, num_p);
 			QR_set_message(res, "Error reading field information");
 		}
 	}
+}
+
+/*
+ * Parse and describe a query using libpq.
+ *
+ * Returns an empty result set that has the column information, or error code
+ * and message, filled in. If 'res' is not NULL, it is the result set
+ * returned, otherwise a new one is allocated.
+ *
+ * NB: The caller must set stmt->current_exec_param before calling this
+ * function!
+ */
+QResultClass *
+ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name,
+						  const char *query_param,
+						  Int2 num_params, const char *comment,
+						  QResultClass *res)
+{
+	CSTR	func = "ParseAndDescribeWithLibpq";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	PGresult   *pgres = NULL;
+
+	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query_param);
+	if (!RequestStart(stmt, conn, func, NULL))
+		return NULL;
+
+	if (!res)
+		res = QR_Constructor();
+	if (!res)
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for query", func);
+		return NULL;
+	}
+
+	/*
+	 * We need to do Prepare + Describe as two different round-trips to the
+	 * server, while before we switched to use libpq, we used to send a Parse
+	 * and Describe message followed by a single Sync.
+	 * (see ExecPipelined() for the first execution though)
+	 */
+	if (!ParseWithLibpq(stmt, plan_name, query_param, num_params, comment, res))
+		goto cleanup;
+
+	/* Describe */
+	QLOG(0, "\tPQdescribePrepared: %p plan_name=%s\n", conn->pqconn, plan_name);
+
+	pgres = PQdescribePrepared(conn->pqconn, plan_name);
+	describe_result_with_libpq(stmt, pgres, res);
 
 cleanup:
 	if (pgres)
@@ -3112,6 +3548,271 @@ cleanup:
 	return res;
 }
 
+#ifdef	HAVE_PQENTERPIPELINEMODE
+/*
+ * The kinds of the requests sent by ExecPipelined()
+ */
+enum {
+	PIPE_DISCARD
+	,PIPE_SYNC
+	,PIPE_BEGIN
+	,PIPE_RELEASE
+	,PIPE_SAVEPOINT
+	,PIPE_PARSE
+	,PIPE_DESCRIBE
+	,PIPE_EXECUTE
+	,PIPE_MAX_REQUESTS
+};
+
+/*
+ * Execute a statement sending the requests which precede it together in
+ * libpq's pipeline mode, and process their results in order.
+ *
+ * The requests are
+ *   DEALLOCATE/CLOSE of the objects marked to be discarded, each followed
+ *   by a Sync, if no transaction is in progress,
+ *   BEGIN, if 'issue_begin' and no transaction is in progress,
+ *   [RELEASE and] SAVEPOINT, if SetStatementSvp() deferred it,
+ *   Parse and Describe of the plan, if 'parse_and_describe',
+ *   Bind and Execute of the plan, or of 'query' as an unnamed statement,
+ * followed by a single Sync, i.e. one round trip instead of up to five
+ * and more.
+ *
+ * Returns the result of the execution, or the error of the request which
+ * failed first.
+ */
+static PGresult *
+ExecPipelined(StatementClass *stmt, BOOL issue_begin,
+			  BOOL parse_and_describe, const char *query,
+			  int nParams, const Oid *paramTypes,
+			  const char * const *paramValues,
+			  const int *paramLengths, const int *paramFormats,
+			  int resultFormat)
+{
+	CSTR	func = "ExecPipelined";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	PGconn	   *pqconn = conn->pqconn;
+	ProcessedStmt *pstmt = stmt->processed_statements;
+	const char *plan_name = stmt->plan_name ? stmt->plan_name : NULL_STRING;
+	Oid		   *parseTypes = NULL;
+	Int2		num_p = 0;
+	QResultClass	*parsed = NULL;
+	PGresult   *pgres, *errres = NULL, *execres = NULL;
+	ExecStatusType	pgresstatus;
+	char		svpcmd[128], *rlscmd = NULL, *sep;
+	int			reqs_fixed[PIPE_MAX_REQUESTS], *reqs = reqs_fixed;
+	int			nreqs = 0, ireq, ndiscard;
+	BOOL		sent = TRUE;
+
+	if (issue_begin && CC_is_in_trans(conn))
+		issue_begin = FALSE;
+	svpcmd[0] = '\0';
+	if (PREPEND_IN_PROGRESS == conn->internal_op)
+	{
+		/* it may be "RELEASE ...;SAVEPOINT ..." */
+		GenerateSvpCommand(conn, INTERNAL_SAVEPOINT_OPERATION, svpcmd, sizeof(svpcmd));
+		if (sep = strchr(svpcmd, ';'), NULL != sep)
+		{
+			*sep = '\0';
+			rlscmd = svpcmd;
+			memmove(svpcmd + strlen(svpcmd) + 1, sep + 1, strlen(sep + 1) + 1);
+		}
+	}
+	if (parse_and_describe)
+	{
+		stmt->current_exec_param = 0;
+		if (num_p = parse_param_types(stmt, pstmt->num_params, &parseTypes), num_p < 0)
+			goto cleanup;
+		if (parsed = QR_Constructor(), NULL == parsed)
+		{
+			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for query", func);
+			goto cleanup;
+		}
+	}
+	if (!CC_is_in_trans(conn) && CC_discard_pending(conn))
+	{
+		if (reqs = malloc(sizeof(int) * (PIPE_MAX_REQUESTS + 2 * conn->num_discardp)), NULL == reqs)
+		{
+			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for query", func);
+			goto cleanup;
+		}
+	}
+	if (!PQenterPipelineMode(pqconn))
+	{
+		CC_set_error(conn, CONNECTION_COMMUNICATION_ERROR, PQerrorMessage(pqconn), func);
+		goto cleanup;
+	}
+
+	if (ndiscard = CC_pipeline_marked_objects(conn), ndiscard < 0)
+		sent = FALSE;
+	for (; ndiscard > 0; ndiscard--)
+	{
+		reqs[nreqs++] = PIPE_DISCARD;
+		reqs[nreqs++] = PIPE_SYNC;
+	}
+	if (issue_begin)
+	{
+		QLOG(0, "PQsendQueryParams: %p 'BEGIN' (pipelined)\n", pqconn);
+		sent = sent && PQsendQueryParams(pqconn, "BEGIN", 0, NULL, NULL, NULL, NULL, 0);
+		reqs[nreqs++] = PIPE_BEGIN;
+	}
+	if (svpcmd[0])
+	{
+		if (rlscmd)
+		{
+			QLOG(0, "PQsendQueryParams: %p '%s' (pipelined)\n", pqconn, rlscmd);
+			sent = sent && PQsendQueryParams(pqconn, rlscmd, 0, NULL, NULL, NULL, NULL, 0);
+			reqs[nreqs++] = PIPE_RELEASE;
+		}
+		sep = rlscmd ? rlscmd + strlen(rlscmd) + 1 : svpcmd;
+		QLOG(0, "PQsendQueryParams: %p '%s' (pipelined)\n", pqconn, sep);
+		sent = sent && PQsendQueryParams(pqconn, sep, 0, NULL, NULL, NULL, NULL, 0);
+		reqs[nreqs++] = PIPE_SAVEPOINT;
+		/* the savepoint is no longer pending whatever its result is */
+		conn->internal_op = 0;
+	}
+	if (parse_and_describe)
+	{
+		QLOG(0, "PQsendPrepare: %p '%s' plan=%s nParams=%d (pipelined)\n", pqconn, pstmt->query, plan_name, num_p);
+		sent = sent && PQsendPrepare(pqconn, plan_name, pstmt->query, num_p, parseTypes);
+		reqs[nreqs++] = PIPE_PARSE;
+		QLOG(0, "PQsendDescribePrepared: %p plan=%s (pipelined)\n", pqconn, plan_name);
+		sent = sent && PQsendDescribePrepared(pqconn, plan_name);
+		reqs[nreqs++] = PIPE_DESCRIBE;
+	}
+	if (query)
+	{
+		QLOG(0, "PQsendQueryParams: %p '%s' nParams=%d (pipelined)\n", pqconn, query, nParams);
+		sent = sent && PQsendQueryParams(pqconn, query, nParams, paramTypes,
+										 paramValues, paramLengths,
+										 paramFormats, resultFormat);
+	}
+	else
+	{
+		QLOG(0, "PQsendQueryPrepared: %p plan=%s nParams=%d (pipelined)\n", pqconn, plan_name, nParams);
+		sent = sent && PQsendQueryPrepared(pqconn, plan_name, nParams,
+										   paramValues, paramLengths,
+										   paramFormats, resultFormat);
+	}
+	reqs[nreqs++] = PIPE_EXECUTE;
+	if (!PQpipelineSync(pqconn) || !sent)
+	{
+		char *errmsg = PQerrorMessage(pqconn);
+
+		QLOG(0, "\nCommunication Error: %s\n", errmsg);
+		CC_set_error(conn, CONNECTION_COMMUNICATION_ERROR, errmsg, func);
+	}
+
+	/*
+	 * Each request returns its result followed by a NULL. A failure makes
+	 * the following requests return PGRES_PIPELINE_ABORTED.
+	 */
+	for (ireq = 0; ireq <= nreqs;)
+	{
+		if (pgres = PQgetResult(pqconn), NULL == pgres)
+		{
+			if (CONNECTION_BAD == PQstatus(pqconn))
+				break;
+			ireq++;
+			continue;
+		}
+		pgresstatus = PQresultStatus(pgres);
+		if (PGRES_PIPELINE_SYNC == pgresstatus)
+		{
+			PQclear(pgres);
+			/* the Sync after a discarded object isn't followed by a NULL */
+			if (ireq < nreqs && PIPE_SYNC == reqs[ireq])
+			{
+				ireq++;
+				continue;
+			}
+			break;
+		}
+		switch (pgresstatus)
+		{
+			case PGRES_FATAL_ERROR:
+			case PGRES_BAD_RESPONSE:
+				/* the object may have gone already */
+				if (ireq < nreqs && PIPE_DISCARD == reqs[ireq])
+				{
+					QLOG(0, "\tdiscarding an object failed: %s", PQresultErrorMessage(pgres));
+					break;
+				}
+				if (NULL == errres)
+				{
+					errres = pgres;
+					pgres = NULL;
+				}
+				break;
+			case PGRES_PIPELINE_ABORTED:
+				break;
+			default:
+				if (ireq >= nreqs)
+					break;
+				switch (reqs[ireq])
+				{
+					case PIPE_DISCARD:
+						QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+						break;
+					case PIPE_BEGIN:
+						QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+						CC_set_in_trans(conn);
+						break;
+					case PIPE_RELEASE:
+						QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+						conn->internal_svp = 0;
+						break;
+					case PIPE_SAVEPOINT:
+						QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+						CC_start_rbpoint(conn);
+						break;
+					case PIPE_PARSE:
+						parse_result_with_libpq(stmt, plan_name, pgres, parsed);
+						break;
+					case PIPE_DESCRIBE:
+						describe_result_with_libpq(stmt, pgres, parsed);
+						break;
+					case PIPE_EXECUTE:
+						if (NULL == execres)
+						{
+							execres = pgres;
+							pgres = NULL;
+						}
+						break;
+				}
+		}
+		if (pgres)
+			PQclear(pgres);
+	}
+	if (!PQexitPipelineMode(pqconn))
+		MYLOG(0, "PQexitPipelineMode failed: %s\n", PQerrorMessage(pqconn));
+
+	if (parsed && NULL == errres && NULL != execres)
+	{
+		QR_Destructor(stmt->parsed);
+		stmt->parsed = parsed;
+		parsed = NULL;
+	}
+cleanup:
+	if (parse_and_describe)
+		stmt->current_exec_param = -1;
+	if (reqs != reqs_fixed)
+		free(reqs);
+	if (parseTypes)
+		free(parseTypes);
+	if (parsed)
+		QR_Destructor(parsed);
+	if (errres)
+	{
+		if (execres)
+			PQclear(execres);
+		return errres;
+	}
+
+	return execres;
+}
+#endif /* HAVE_PQENTERPIPELINEMODE */
+
 enum {
 	CancelRequestSet	= 1L
 	,CancelRequestAccepted	= (1L << 1)
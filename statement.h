@@ -200,11 +200,31 @@ struct ProcessedStmt
 };
 typedef struct ProcessedStmt ProcessedStmt;
 
+/*
+ *	The state of an asynchronous execution (SQL_ATTR_ASYNC_ENABLE).
+ *	While the request is in flight SQLExecute()/SQLExecDirect() return
+ *	SQL_STILL_EXECUTING, see SC_execute() and libpq_bind_and_exec().
+ */
+typedef struct
+{
+	po_ind_t	allowed;	/* this execution may be asynchronous */
+	po_ind_t	pending;	/* the request is in flight */
+	po_ind_t	flushed;	/* the request has been sent completely */
+	po_ind_t	is_in_trans;	/* saved states of SC_execute() */
+	po_ind_t	is_select;
+	Int2		conn_status;
+	QResultClass	*res;		/* collects notices */
+	void		*pgres;		/* the result received so far */
+}	AsyncExecInfo;
+
 /********	Statement Handle	***********/
 struct StatementClass_
 {
 	ConnectionClass *hdbc;		/* pointer to ConnectionClass this
 								 * statement belongs to */
+	Int4		conn_index;	/* the index in hdbc->stmts */
+	StatementClass	*prev_cursor_stmt;	/* hdbc->cursor_stmts list */
+	StatementClass	*next_cursor_stmt;
 	QResultHold rhold;
 	QResultClass *curres;		/* the current result in the chain */
 	QResultClass *parsed;		/* parsed result before exec */
@@ -261,6 +281,8 @@ struct StatementClass_
 						 * SQLPutData */
 	UDWORD		iflag;		/* PGAPI_AllocStmt parameter */
 	PutDataInfo	pdata_info;
+	ExecParamsInfo	exec_params;	/* reused by libpq_bind_and_exec */
+	AsyncExecInfo	async;
 	po_ind_t	parse_status;
 	po_ind_t	proc_return;
 	po_ind_t	put_data;	/* Has SQLPutData been called ? */
@@ -320,6 +342,7 @@ struct StatementClass_
 };
 
 #define SC_get_conn(a)	  ((a)->hdbc)
+#define SC_is_async_pending(a)	(0 != (a)->async.pending)
 void SC_init_Result(StatementClass *self);
 void SC_set_Result(StatementClass *self, QResultClass *res);
 void SC_set_ResultHold(StatementClass *self, QResultHold rhold);
@@ -342,6 +365,7 @@ QResultClass *SC_get_lastres(StatementClass *stmt);
 #define SC_get_IPDi(a)  (&((a)->ipdi))
 #define SC_get_GDTI(a)  (&((a)->gdata_info))
 #define SC_get_PDTI(a)  (&((a)->pdata_info))
+#define SC_get_EPRM(a)  (&((a)->exec_params))
 
 #define	SC_get_errornumber(a) ((a)->__error_number)
 #define	SC_set_errornumber(a, n) ((a)->__error_number = n)
@@ -474,6 +498,17 @@ enum
 	(SC_get_APDF(a)->paramset_size <= 1 &&	\
 	 (STMT_TYPE_SELECT == (a)->statement_type || STMT_TYPE_WITH == (a)->statement_type) )
 #define SC_may_fetch_rows(a) (STMT_TYPE_SELECT == (a)->statement_type || STMT_TYPE_WITH == (a)->statement_type)
+#define SC_is_server_static(a, ci) \
+	((ci)->server_static_cursors && SQL_CURSOR_STATIC == (a)->options.cursor_type)
+/*
+ * only the cursor keeps SQL_ATTR_MAX_ROWS from reading all the rows,
+ * forward-only ones as they close, ending the transaction, at the end
+ */
+#define SC_is_max_rows_cursor(a, ci) \
+	((a)->options.maxRows > 0 && SQL_CURSOR_FORWARD_ONLY == (a)->options.cursor_type && \
+	 !(ci)->drivers.use_declarefetch && !SC_is_server_static(a, ci))
+#define SC_should_use_cursor(a, ci) \
+	((ci)->drivers.use_declarefetch || SC_is_server_static(a, ci) || SC_is_max_rows_cursor(a, ci))
 
 
 /* For Multi-thread */
@@ -501,6 +536,8 @@ StatementClass *SC_Constructor(ConnectionClass *);
 void		InitializeStatementOptions(StatementOptions *opt);
 char		SC_Destructor(StatementClass *self);
 BOOL		SC_opencheck(StatementClass *self, const char *func);
+BOOL		SC_async_busy(StatementClass *self, const char *func);
+void		SC_async_abandon(StatementClass *self);
 RETCODE		SC_initialize_and_recycle(StatementClass *self);
 void		SC_initialize_cols_info(StatementClass *self, BOOL DCdestroy, BOOL parseReset);
 void		SC_reset_result_for_rerun(StatementClass *self);
@@ -533,9 +570,12 @@ SQLLEN		SC_get_int4_bookmark(StatementClass *self);
 RETCODE		SC_pos_reload(StatementClass *self, SQLULEN index, UInt2 *, Int4);
 RETCODE		SC_pos_update(StatementClass *self, SQLSETPOSIROW irow, SQLULEN index, const KeySet *keyset);
 RETCODE		SC_pos_delete(StatementClass *self, SQLSETPOSIROW irow, SQLULEN index, const KeySet *keyset);
+RETCODE		SC_pos_update_delete_rows(StatementClass *self, UWORD fOption, SQLLEN nrows, const SQLSETPOSIROW *irows, const SQLULEN *indexes, const KeySet *keysets, BOOL *batched);
 RETCODE		SC_pos_refresh(StatementClass *self, SQLSETPOSIROW irow, SQLULEN index);
+RETCODE		SC_pos_refresh_rows(StatementClass *self, SQLLEN nrows, const SQLSETPOSIROW *irows, const SQLULEN *indexes, SQLLEN *nprocessed, BOOL *batched);
 RETCODE		SC_pos_fetch(StatementClass *self, const PG_BM *pg_bm);
 RETCODE		SC_pos_add(StatementClass *self, SQLSETPOSIROW irow);
+RETCODE		SC_pos_add_rows(StatementClass *self, SQLLEN nrows, const SQLSETPOSIROW *irows, BOOL *batched);
 RETCODE		SC_fetch_by_bookmark(StatementClass *self);
 int		SC_Create_bookmark(StatementClass *stmt, BindInfoClass *bookmark, Int4 row_pos, Int4 currTuple, const KeySet *keyset);
 PG_BM		SC_Resolve_bookmark(const ARDFields *opts, Int4 idx);
@@ -0,0 +1,167 @@
+/*
+ * Test the asynchronous connection functions
+ * (SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE). SQLConnect(), SQLDriverConnect(),
+ * SQLEndTran() and SQLDisconnect() are called again with the same
+ * arguments until they don't return SQL_STILL_EXECUTING.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#ifndef	SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE
+#define	SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE	117
+#define	SQL_ASYNC_DBC_ENABLE_ON		1UL
+#endif /* SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE */
+#ifndef	SQL_OV_ODBC3_80
+#define	SQL_OV_ODBC3_80	380UL
+#endif /* SQL_OV_ODBC3_80 */
+
+static void
+connect_async(char *extraparams)
+{
+	SQLRETURN	rc;
+	SQLCHAR		str[1024];
+	SQLSMALLINT	strl;
+	SQLCHAR		dsn[1024];
+
+	snprintf(dsn, sizeof(dsn), "DSN=%s;%s", get_test_dsn(), extraparams);
+	while (rc = SQLDriverConnect(conn, NULL, dsn, SQL_NTS,
+								 str, sizeof(str), &strl,
+								 SQL_DRIVER_NOPROMPT), SQL_STILL_EXECUTING == rc)
+		;
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("SQLDriverConnect failed.", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	printf("connected with SQLDriverConnect %s\n", extraparams);
+}
+
+static void
+disconnect_async(void)
+{
+	SQLRETURN	rc;
+
+	while (rc = SQLDisconnect(conn), SQL_STILL_EXECUTING == rc)
+		;
+	CHECK_CONN_RESULT(rc, "SQLDisconnect failed", conn);
+	printf("disconnected\n");
+}
+
+static void
+end_tran_async(SQLSMALLINT completion_type)
+{
+	SQLRETURN	rc;
+
+	while (rc = SQLEndTran(SQL_HANDLE_DBC, conn, completion_type), SQL_STILL_EXECUTING == rc)
+		;
+	CHECK_CONN_RESULT(rc, "SQLEndTran failed", conn);
+}
+
+static void
+exec_and_print(HSTMT hstmt, char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLUINTEGER	value;
+
+	SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &env);
+	SQLSetEnvAttr(env, SQL_ATTR_ODBC_VERSION, (void *) SQL_OV_ODBC3_80, 0);
+	SQLAllocHandle(SQL_HANDLE_DBC, env, &conn);
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE,
+						   (SQLPOINTER) SQL_ASYNC_DBC_ENABLE_ON, SQL_IS_UINTEGER);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr failed", conn);
+
+	/* SQLConnect() */
+	while (rc = SQLConnect(conn, (SQLCHAR *) get_test_dsn(), SQL_NTS, NULL, 0, NULL, 0), SQL_STILL_EXECUTING == rc)
+		;
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("SQLConnect failed.", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	printf("connected with SQLConnect\n");
+	value = 0;
+	rc = SQLGetConnectAttr(conn, SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE, &value, 0, NULL);
+	CHECK_CONN_RESULT(rc, "SQLGetConnectAttr failed", conn);
+	printf("async dbc functions: %s\n", SQL_ASYNC_DBC_ENABLE_ON == value ? "on" : "off");
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	exec_and_print(hstmt, "SELECT 'after SQLConnect'");
+	SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	disconnect_async();
+
+	/* SQLDriverConnect() */
+	connect_async("PoolSize=1;PoolReset=1");
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	exec_and_print(hstmt, "SELECT 'after SQLDriverConnect'");
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE async_dbc_test (t text)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	/* SQLEndTran() */
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_AUTOCOMMIT,
+						   (SQLPOINTER) SQL_AUTOCOMMIT_OFF, SQL_IS_UINTEGER);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr failed", conn);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO async_dbc_test VALUES ('committed')", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	end_tran_async(SQL_COMMIT);
+	printf("committed\n");
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO async_dbc_test VALUES ('rolled back')", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	end_tran_async(SQL_ROLLBACK);
+	printf("rolled back\n");
+	exec_and_print(hstmt, "SELECT t FROM async_dbc_test");
+
+	/*
+	 * SQLDisconnect() rolls back the open transaction and resets the
+	 * session before the connection goes into the pool. PoolReset=1
+	 * keeps the temporary table for the next connection.
+	 */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO async_dbc_test VALUES ('left open')", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	disconnect_async();
+
+	connect_async("PoolSize=1;PoolReset=1");
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	exec_and_print(hstmt, "SELECT t FROM async_dbc_test");
+	SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	disconnect_async();
+
+	/* Clean up */
+	rc = SQLFreeHandle(SQL_HANDLE_DBC, conn);
+	CHECK_CONN_RESULT(rc, "SQLFreeHandle failed", conn);
+	conn = NULL;
+	SQLFreeHandle(SQL_HANDLE_ENV, env);
+	env = NULL;
+
+	return 0;
+}
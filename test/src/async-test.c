@@ -0,0 +1,118 @@
+/*
+ * Test asynchronous execution (SQL_ATTR_ASYNC_ENABLE). The statement is
+ * executed by calling SQLExecDirect() again until it doesn't return
+ * SQL_STILL_EXECUTING. Meanwhile the connection can't be used by the
+ * other statements.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static void
+print_sqlstate(char *msg, SQLSMALLINT htype, SQLHANDLE handle)
+{
+	char		sqlstate[32];
+	char		message[1000];
+	SQLINTEGER	nativeerror;
+	SQLSMALLINT textlen;
+	SQLRETURN	ret;
+
+	ret = SQLGetDiagRec(htype, handle, 1, sqlstate, &nativeerror,
+						message, sizeof(message), &textlen);
+	if (SQL_SUCCEEDED(ret))
+		printf("%s: %s\n", msg, sqlstate);
+	else
+		printf("%s: no error information\n", msg);
+}
+
+static SQLRETURN
+exec_async(HSTMT hstmt, char *sql)
+{
+	SQLRETURN	rc;
+
+	while (rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS), SQL_STILL_EXECUTING == rc)
+		;
+	return rc;
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	HSTMT		hstmt2 = SQL_NULL_HSTMT;
+	char	   *sleepsql = "SELECT 'slept' FROM pg_sleep(2)";
+
+	test_connect();
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt2);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE, (SQLPOINTER) SQL_ASYNC_ENABLE_ON, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ASYNC_ENABLE failed", hstmt);
+
+	/* Poll until the result arrives */
+	rc = exec_async(hstmt, "SELECT 'foo', 1 UNION ALL SELECT 'bar', 2");
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* The other statements must wait for the pending one */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sleepsql, SQL_NTS);
+	if (SQL_STILL_EXECUTING != rc)
+	{
+		print_diag("SQLExecDirect didn't return SQL_STILL_EXECUTING", SQL_HANDLE_STMT, hstmt);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *) "SELECT 1", SQL_NTS);
+	if (SQL_ERROR == rc)
+		print_sqlstate("executing another statement", SQL_HANDLE_STMT, hstmt2);
+	else
+		printf("another statement could be executed\n");
+	rc = exec_async(hstmt, sleepsql);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* Cancel, the next call returns the error */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sleepsql, SQL_NTS);
+	if (SQL_STILL_EXECUTING != rc)
+	{
+		print_diag("SQLExecDirect didn't return SQL_STILL_EXECUTING", SQL_HANDLE_STMT, hstmt);
+		exit(1);
+	}
+	rc = SQLCancel(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLCancel failed", hstmt);
+	rc = exec_async(hstmt, sleepsql);
+	if (SQL_ERROR == rc)
+		print_sqlstate("cancelled", SQL_HANDLE_STMT, hstmt);
+	else
+		printf("the cancelled statement didn't fail\n");
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* The connection is usable again */
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *) "SELECT 'after'", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt2);
+	print_result(hstmt2);
+	rc = SQLFreeStmt(hstmt2, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt2);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
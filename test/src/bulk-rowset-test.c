@@ -0,0 +1,196 @@
+/*
+ * Test SQLSetPos() and SQLBulkOperations() on a whole rowset. The rows
+ * are processed together, so check that each row gets its own status
+ * and values.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define	ROWSET_SIZE		4
+#define	BOOKMARK_SIZE	14
+
+static SQLINTEGER	colvalues1[ROWSET_SIZE];
+static SQLINTEGER	colvalues2[ROWSET_SIZE];
+static SQLLEN		indColvalues1[ROWSET_SIZE];
+static SQLLEN		indColvalues2[ROWSET_SIZE];
+static char			bookmarks[ROWSET_SIZE][BOOKMARK_SIZE];
+static SQLLEN		bookmark_inds[ROWSET_SIZE];
+static SQLUSMALLINT	row_status[ROWSET_SIZE];
+
+static void
+print_rowset(char *msg, int nrows)
+{
+	int			i;
+
+	printf("%s\n", msg);
+	for (i = 0; i < nrows; i++)
+		printf("%d\t%d\n", (int) colvalues1[i], (int) colvalues2[i]);
+}
+
+static void
+print_row_status(char *msg, int nrows)
+{
+	int			i;
+
+	printf("%s:", msg);
+	for (i = 0; i < nrows; i++)
+		printf(" %d", row_status[i]);
+	printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	HSTMT		hstmt2 = SQL_NULL_HSTMT;
+	int			i;
+
+	test_connect_ext("UpdatableCursors=1");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt2);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE bulkrowset_test(i int4, orig int4)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO bulkrowset_test SELECT g, g FROM generate_series(1, 10) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CONCURRENCY,
+						(SQLPOINTER) SQL_CONCUR_ROWVER, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE,
+						(SQLPOINTER) SQL_CURSOR_KEYSET_DRIVEN, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_USE_BOOKMARKS,
+						(SQLPOINTER) SQL_UB_VARIABLE, SQL_IS_UINTEGER);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET_SIZE, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, (SQLPOINTER) row_status, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	rc = SQLBindCol(hstmt, 0, SQL_C_VARBOOKMARK, bookmarks, BOOKMARK_SIZE, bookmark_inds);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_LONG, colvalues1, 0, indColvalues1);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_LONG, colvalues2, 0, indColvalues2);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT i, orig FROM bulkrowset_test ORDER BY orig", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	/* Update all the rows of the first rowset */
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_NEXT, 0);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	print_rowset("first rowset", ROWSET_SIZE);
+	for (i = 0; i < ROWSET_SIZE; i++)
+		colvalues1[i] += 100;
+	rc = SQLSetPos(hstmt, 0, SQL_UPDATE, SQL_LOCK_NO_CHANGE);
+	CHECK_STMT_RESULT(rc, "SQLSetPos UPDATE failed", hstmt);
+	print_row_status("update status", ROWSET_SIZE);
+
+	/* Delete all the rows of the second rowset */
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_NEXT, 0);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	print_rowset("second rowset", ROWSET_SIZE);
+	rc = SQLSetPos(hstmt, 0, SQL_DELETE, SQL_LOCK_NO_CHANGE);
+	CHECK_STMT_RESULT(rc, "SQLSetPos DELETE failed", hstmt);
+	print_row_status("delete status", ROWSET_SIZE);
+
+	/* Insert a rowset of 3 rows */
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 3, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	for (i = 0; i < 3; i++)
+	{
+		colvalues1[i] = 1001 + i;
+		colvalues2[i] = 11 + i;
+		indColvalues1[i] = indColvalues2[i] = 0;
+	}
+	rc = SQLBulkOperations(hstmt, SQL_ADD);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations ADD failed", hstmt);
+	print_row_status("add status", 3);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET_SIZE, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	/* The updated rows are seen by the cursor */
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_ABSOLUTE, 1);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	print_rowset("first rowset again", ROWSET_SIZE);
+
+	/* Update the same rows twice more through their bookmarks */
+	for (i = 0; i < ROWSET_SIZE; i++)
+		colvalues1[i] += 100;
+	rc = SQLBulkOperations(hstmt, SQL_UPDATE_BY_BOOKMARK);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations UPDATE_BY_BOOKMARK failed", hstmt);
+	for (i = 0; i < ROWSET_SIZE; i++)
+		colvalues1[i] += 100;
+	rc = SQLBulkOperations(hstmt, SQL_UPDATE_BY_BOOKMARK);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations UPDATE_BY_BOOKMARK failed", hstmt);
+	print_row_status("update by bookmark status", ROWSET_SIZE);
+
+	/* Fetching by the bookmarks gives the last updated values */
+	memset(colvalues1, 0, sizeof(colvalues1));
+	memset(colvalues2, 0, sizeof(colvalues2));
+	rc = SQLBulkOperations(hstmt, SQL_FETCH_BY_BOOKMARK);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations FETCH_BY_BOOKMARK failed", hstmt);
+	print_rowset("fetched by bookmark", ROWSET_SIZE);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/*
+	 * Refresh a whole rowset after another statement has updated one
+	 * of its rows and deleted another.
+	 */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT i, orig FROM bulkrowset_test ORDER BY orig", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_NEXT, 0);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	print_rowset("rowset to refresh", ROWSET_SIZE);
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *) "UPDATE bulkrowset_test SET i = i + 1000 WHERE orig = 2", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt2);
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *) "DELETE FROM bulkrowset_test WHERE orig = 3", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt2);
+	memset(colvalues1, 0, sizeof(colvalues1));
+	memset(colvalues2, 0, sizeof(colvalues2));
+	rc = SQLSetPos(hstmt, 0, SQL_REFRESH, SQL_LOCK_NO_CHANGE);
+	CHECK_STMT_RESULT(rc, "SQLSetPos REFRESH failed", hstmt);
+	print_rowset("refreshed rowset", ROWSET_SIZE);
+	print_row_status("refresh status", ROWSET_SIZE);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 1, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, NULL, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	/* See if the changes really took effect */
+	printf("\nQuerying the table again\n");
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT i, orig FROM bulkrowset_test ORDER BY orig", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Test keyset driven cursors over a table spanning several pages, so
+ * that the keys (ctids) of the rows have multi-digit block numbers and
+ * offsets.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static SQLINTEGER	colvalue;
+static SQLLEN		indColvalue;
+
+static void
+fetch_and_print(HSTMT hstmt, SQLSMALLINT orientation, SQLLEN offset, char *msg)
+{
+	int			rc;
+
+	rc = SQLFetchScroll(hstmt, orientation, offset);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	printf("%s: %d\n", msg, (int) colvalue);
+}
+
+int main(int argc, char **argv)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLUSMALLINT	row_status;
+
+	test_connect_ext("UpdatableCursors=1");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE keyset_test(i int4, t text)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO keyset_test SELECT g, repeat('x', 20) FROM generate_series(1, 3000) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	/* leave the updated rows at the end of the table */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "UPDATE keyset_test SET t = 'updated' WHERE i % 100 = 0", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT count(DISTINCT (ctid::text::point)[0]) > 10 AS many_pages FROM keyset_test", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result_with_column_names(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CONCURRENCY,
+						(SQLPOINTER) SQL_CONCUR_ROWVER, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE,
+						(SQLPOINTER) SQL_CURSOR_KEYSET_DRIVEN, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, (SQLPOINTER) &row_status, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_LONG, &colvalue, 0, &indColvalue);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT i, t FROM keyset_test ORDER BY i", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 2500, "absolute 2500");
+	fetch_and_print(hstmt, SQL_FETCH_LAST, 0, "last");
+	fetch_and_print(hstmt, SQL_FETCH_PRIOR, 0, "prior");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 100, "absolute 100");
+	fetch_and_print(hstmt, SQL_FETCH_RELATIVE, 1234, "relative 1234");
+	fetch_and_print(hstmt, SQL_FETCH_FIRST, 0, "first");
+
+	/* A row updated through the cursor gets its new key */
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 2999, "absolute 2999");
+	colvalue = -2999;
+	rc = SQLSetPos(hstmt, 1, SQL_UPDATE, SQL_LOCK_NO_CHANGE);
+	CHECK_STMT_RESULT(rc, "SQLSetPos UPDATE failed", hstmt);
+	printf("update status: %d\n", row_status);
+	fetch_and_print(hstmt, SQL_FETCH_FIRST, 0, "first");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 2999, "absolute 2999");
+	colvalue = 2999;
+	rc = SQLSetPos(hstmt, 1, SQL_UPDATE, SQL_LOCK_NO_CHANGE);
+	CHECK_STMT_RESULT(rc, "SQLSetPos UPDATE failed", hstmt);
+	printf("update status: %d\n", row_status);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, NULL, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT i FROM keyset_test WHERE i > 2995 ORDER BY i", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
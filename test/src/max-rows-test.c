@@ -0,0 +1,170 @@
+/*
+ * Test SQL_ATTR_MAX_ROWS. Without server side prepare a forward-only
+ * SELECT is read through a cursor, so that the rows beyond the limit
+ * aren't transferred, and the cursor must not be left open or be closed
+ * too early. With server side prepare, the default, the limit is
+ * applied by the driver and all the rows are transferred.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static void
+print_in_transaction(void)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	/* now() is the start of the transaction */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT now() <> statement_timestamp() AS in_transaction", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result_with_column_names(hstmt);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+}
+
+static void
+set_max_rows(HSTMT hstmt, SQLULEN max_rows)
+{
+	int			rc;
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_MAX_ROWS, (SQLPOINTER) max_rows, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr MAX_ROWS failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	HSTMT		hstmt2 = SQL_NULL_HSTMT;
+	SQLLEN		rowcount;
+	unsigned char buf[20];
+	SQLLEN		ind;
+	SQLINTEGER	intval;
+	int			i;
+
+	test_connect_ext("UseServerSidePrepare=0");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	/* Forward-only cursor */
+	printf("forward-only, max rows 3\n");
+	set_max_rows(hstmt, 3);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 10) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLRowCount(hstmt, &rowcount);
+	CHECK_STMT_RESULT(rc, "SQLRowCount failed", hstmt);
+	printf("row count: %d\n", (int) rowcount);
+	print_result(hstmt);
+	print_in_transaction();
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/*
+	 * A statement which can't run in a transaction block succeeds while
+	 * the rows of a max rows cursor are being read.
+	 */
+	printf("VACUUM while reading, max rows 3\n");
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE maxrows_vacuum (id int4)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	set_max_rows(hstmt, 3);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 10) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_SLONG, &intval, 0, &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("first row: %d\n", (int) intval);
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt2);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *) "VACUUM maxrows_vacuum", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "VACUUM failed", hstmt2);
+	printf("vacuumed\n");
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt2);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt2);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* A scrollable cursor doesn't keep a transaction open */
+	printf("static, max rows 4\n");
+	set_max_rows(hstmt, 4);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE,
+						(SQLPOINTER) SQL_CURSOR_STATIC, SQL_IS_UINTEGER);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr CURSOR_TYPE failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 10) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_in_transaction();
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE,
+						(SQLPOINTER) SQL_CURSOR_FORWARD_ONLY, SQL_IS_UINTEGER);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr CURSOR_TYPE failed", hstmt);
+
+	/* The cursor is declared WITH HOLD, so it survives a commit */
+	printf("forward-only across commit, max rows 2\n");
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_OFF, SQL_IS_UINTEGER);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr AUTOCOMMIT failed", conn);
+	set_max_rows(hstmt, 2);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 10) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLEndTran(SQL_HANDLE_DBC, conn, SQL_COMMIT);
+	CHECK_CONN_RESULT(rc, "SQLEndTran failed", conn);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLEndTran(SQL_HANDLE_DBC, conn, SQL_COMMIT);
+	CHECK_CONN_RESULT(rc, "SQLEndTran failed", conn);
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_ON, SQL_IS_UINTEGER);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr AUTOCOMMIT failed", conn);
+
+	/* Reading a large object mustn't end the transaction of the cursor */
+	printf("large objects, max rows 2\n");
+	set_max_rows(hstmt, 0);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE maxrows_lo (id int4, large_data lo)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO maxrows_lo SELECT g, lo_from_bytea(0, int4send(g)) FROM generate_series(1, 3) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	set_max_rows(hstmt, 2);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT id, large_data FROM maxrows_lo ORDER BY id", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	for (i = 1; (rc = SQLFetch(hstmt)) != SQL_NO_DATA; i++)
+	{
+		int			j;
+
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+		rc = SQLGetData(hstmt, 2, SQL_C_BINARY, buf, sizeof(buf), &ind);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+		printf("row %d: hex: ", i);
+		for (j = 0; j < ind; j++)
+			printf("%02X", buf[j]);
+		printf("\n");
+	}
+	print_in_transaction();
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
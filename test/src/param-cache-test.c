@@ -0,0 +1,165 @@
+/*
+ * Test CacheParamValues and the parameters sent in binary format.
+ * One prepared statement is executed again and again with the same
+ * values (which are taken from the cache), with changed values, and
+ * with the parameters bound as other types.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static SQLINTEGER	intparam;
+static SQLDOUBLE	doubleparam;
+static DATE_STRUCT	dateparam;
+static TIMESTAMP_STRUCT	tsparam;
+static char			textparam[20];
+static char			charparam1[20], charparam3[20], charparam4[20];
+static SQLLEN		ind1, ind2, ind3, ind4, ind5;
+
+static void
+bind_typed_params(HSTMT hstmt)
+{
+	SQLRETURN	rc;
+
+	ind1 = ind2 = ind3 = ind4 = 0;
+	ind5 = SQL_NTS;
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT,
+						  SQL_C_LONG, SQL_INTEGER, 0, 0,
+						  &intparam, 0, &ind1);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT,
+						  SQL_C_DOUBLE, SQL_DOUBLE, 0, 0,
+						  &doubleparam, 0, &ind2);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 3, SQL_PARAM_INPUT,
+						  SQL_C_TYPE_DATE, SQL_TYPE_DATE, 0, 0,
+						  &dateparam, 0, &ind3);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 4, SQL_PARAM_INPUT,
+						  SQL_C_TYPE_TIMESTAMP, SQL_TYPE_TIMESTAMP, 19, 0,
+						  &tsparam, 0, &ind4);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 5, SQL_PARAM_INPUT,
+						  SQL_C_CHAR, SQL_VARCHAR, 20, 0,
+						  textparam, 0, &ind5);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+}
+
+/* bind the parameters 1, 3 and 4 as strings, and 2 as an integer */
+static void
+bind_other_params(HSTMT hstmt)
+{
+	SQLRETURN	rc;
+
+	ind1 = ind3 = ind4 = SQL_NTS;
+	ind2 = 0;
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT,
+						  SQL_C_CHAR, SQL_VARCHAR, 20, 0,
+						  charparam1, 0, &ind1);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT,
+						  SQL_C_LONG, SQL_INTEGER, 0, 0,
+						  &intparam, 0, &ind2);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 3, SQL_PARAM_INPUT,
+						  SQL_C_CHAR, SQL_VARCHAR, 20, 0,
+						  charparam3, 0, &ind3);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 4, SQL_PARAM_INPUT,
+						  SQL_C_CHAR, SQL_VARCHAR, 20, 0,
+						  charparam4, 0, &ind4);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+}
+
+static void
+set_typed_values(int i, double d, int year, int month, int day, char *t)
+{
+	intparam = i;
+	doubleparam = d;
+	dateparam.year = year;
+	dateparam.month = month;
+	dateparam.day = day;
+	memset(&tsparam, 0, sizeof(tsparam));
+	tsparam.year = year;
+	tsparam.month = month;
+	tsparam.day = day;
+	tsparam.hour = 12;
+	tsparam.minute = 30;
+	strcpy(textparam, t);
+}
+
+static void
+execute_and_print(HSTMT hstmt, char *msg)
+{
+	SQLRETURN	rc;
+
+	printf("%s\n", msg);
+	rc = SQLExecute(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	test_connect_ext("CacheParamValues=1");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "SELECT ?::int4 + 1, ?::float8 * 2, ?::date + 1, ?::timestamp + interval '1 hour', ?::text || 'x'", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+
+	/*
+	 * The first execution sends the values as text, the later ones
+	 * as the types the server has described.
+	 */
+	bind_typed_params(hstmt);
+	set_typed_values(1, 1.5, 2020, 2, 28, "a");
+	execute_and_print(hstmt, "first execution");
+	execute_and_print(hstmt, "same values");
+	execute_and_print(hstmt, "same values again");
+
+	set_typed_values(10, -0.25, 2020, 12, 31, "b");
+	execute_and_print(hstmt, "changed values");
+	execute_and_print(hstmt, "same values");
+
+	/* Only some of the values change */
+	intparam = 20;
+	strcpy(textparam, "c");
+	execute_and_print(hstmt, "changed int and text");
+
+	/* The same statement with the parameters bound as other types */
+	bind_other_params(hstmt);
+	strcpy(charparam1, "41");
+	intparam = 3;
+	strcpy(charparam3, "2000-01-01");
+	strcpy(charparam4, "1999-12-31 23:30:00");
+	execute_and_print(hstmt, "other types");
+	execute_and_print(hstmt, "same values");
+
+	/* And back */
+	bind_typed_params(hstmt);
+	set_typed_values(100, 1.5, 2020, 2, 28, "a");
+	execute_and_print(hstmt, "typed again");
+	execute_and_print(hstmt, "same values");
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -0,0 +1,130 @@
+/*
+ * Test connection pooling (PoolSize). A disconnected connection's libpq
+ * connection is kept in the environment and reused by the next connection
+ * with the same parameters, after its session has been reset.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static char	backend_pid[32];
+
+static void
+reconnect(char *extraparams)
+{
+	SQLRETURN	rc;
+	SQLCHAR		str[1024];
+	SQLSMALLINT strl;
+	SQLCHAR		dsn[1024];
+
+	rc = SQLDisconnect(conn);
+	CHECK_CONN_RESULT(rc, "SQLDisconnect failed", conn);
+
+	snprintf(dsn, sizeof(dsn), "DSN=%s;%s", get_test_dsn(), extraparams);
+	rc = SQLDriverConnect(conn, NULL, dsn, SQL_NTS,
+						  str, sizeof(str), &strl,
+						  SQL_DRIVER_NOPROMPT);
+	CHECK_CONN_RESULT(rc, "SQLDriverConnect failed", conn);
+	printf("reconnected with %s\n", extraparams);
+}
+
+static void
+exec_and_print(char *sql, char *label)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	char		buf[64];
+	SQLLEN		ind;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	if (label)
+	{
+		rc = SQLFetch(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+		rc = SQLGetData(hstmt, 1, SQL_C_CHAR, buf, sizeof(buf), &ind);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+		printf("%s: %s\n", label, buf);
+	}
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+}
+
+/* Is the session on the same backend as the last time ? */
+static void
+print_same_backend(void)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	char		buf[32];
+	SQLLEN		ind;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT pg_backend_pid()", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_CHAR, buf, sizeof(buf), &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	if (backend_pid[0])
+		printf("same backend: %d\n", strcmp(buf, backend_pid) == 0);
+	strcpy(backend_pid, buf);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	test_connect_ext("PoolSize=1");
+	print_same_backend();
+
+	/*
+	 * The session is reset when the connection goes into the pool,
+	 * according to the PoolReset of the disconnected connection.
+	 * DISCARD ALL by default.
+	 */
+	exec_and_print("SET application_name = 'pooling-test'", NULL);
+	exec_and_print("CREATE TEMPORARY TABLE pool_tmp (id int4)", NULL);
+	reconnect("PoolSize=1;PoolReset=1");
+	print_same_backend();
+	exec_and_print("SELECT current_setting('application_name') = 'pooling-test'", "application_name kept");
+	exec_and_print("SELECT to_regclass('pg_temp.pool_tmp') IS NOT NULL", "temporary table kept");
+
+	/* PoolReset=1 keeps the temporary tables */
+	exec_and_print("SET application_name = 'pooling-test'", NULL);
+	exec_and_print("CREATE TEMPORARY TABLE pool_tmp (id int4)", NULL);
+	reconnect("PoolSize=1;PoolReset=1");
+	print_same_backend();
+	exec_and_print("SELECT current_setting('application_name') = 'pooling-test'", "application_name kept");
+	exec_and_print("SELECT to_regclass('pg_temp.pool_tmp') IS NOT NULL", "temporary table kept");
+
+	/* An open transaction is rolled back */
+	exec_and_print("BEGIN", NULL);
+	exec_and_print("INSERT INTO pool_tmp VALUES (1)", NULL);
+	reconnect("PoolSize=1;PoolReset=1");
+	print_same_backend();
+	exec_and_print("SELECT count(*) FROM pool_tmp", "rows in the temporary table");
+
+	/* Without PoolSize the pool isn't used */
+	reconnect("PoolSize=0");
+	print_same_backend();
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Test ScrollCacheWindows with Use Declare/Fetch. Rowsets in the
+ * windows kept from earlier fetches are served from memory without
+ * moving the server side cursor, and later fetches must still find the
+ * right rows. The saved windows are checked to be fetched without a round
+ * trip after the cursor has been closed on the server.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define	ROWSET_SIZE		10
+
+static SQLINTEGER	colvalues[ROWSET_SIZE];
+static SQLLEN		indColvalues[ROWSET_SIZE];
+static SQLULEN		rows_fetched;
+
+static void
+fetch_and_print(HSTMT hstmt, SQLSMALLINT orientation, SQLLEN offset, char *msg)
+{
+	int			rc;
+
+	rc = SQLFetchScroll(hstmt, orientation, offset);
+	if (SQL_NO_DATA == rc)
+	{
+		printf("%s: no data\n", msg);
+		return;
+	}
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	printf("%s: %d rows %d - %d\n", msg, (int) rows_fetched,
+		   (int) colvalues[0], (int) colvalues[rows_fetched - 1]);
+}
+
+int main(int argc, char **argv)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	HSTMT		hstmt2 = SQL_NULL_HSTMT;
+	SQLCHAR		cursor_name[64];
+	SQLCHAR		sql[128];
+	SQLSMALLINT	len;
+
+	test_connect_ext("UseDeclareFetch=1;Fetch=10;ScrollCacheWindows=3");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt2);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE,
+						(SQLPOINTER) SQL_CURSOR_STATIC, SQL_IS_UINTEGER);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET_SIZE, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, (SQLPOINTER) &rows_fetched, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_LONG, colvalues, 0, indColvalues);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 100) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	/* from the saved windows */
+	fetch_and_print(hstmt, SQL_FETCH_FIRST, 0, "first");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	/* the cursor has to be moved back to where the rows continue */
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 5, "absolute 5");
+	fetch_and_print(hstmt, SQL_FETCH_LAST, 0, "last");
+	fetch_and_print(hstmt, SQL_FETCH_PRIOR, 0, "prior");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 21, "absolute 21");
+	fetch_and_print(hstmt, SQL_FETCH_RELATIVE, 50, "relative 50");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* Close the cursor behind the driver's back */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 100) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	rc = SQLGetCursorName(hstmt, cursor_name, sizeof(cursor_name), &len);
+	CHECK_STMT_RESULT(rc, "SQLGetCursorName failed", hstmt);
+	snprintf((char *) sql, sizeof(sql), "CLOSE \"%s\"", (char *) cursor_name);
+	rc = SQLExecDirect(hstmt2, sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt2);
+	printf("closed the cursor on the server\n");
+	fetch_and_print(hstmt, SQL_FETCH_FIRST, 0, "first");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	/* let the driver close a cursor of the same name */
+	snprintf((char *) sql, sizeof(sql), "DECLARE \"%s\" CURSOR FOR SELECT 1", (char *) cursor_name);
+	rc = SQLExecDirect(hstmt2, sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt2);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
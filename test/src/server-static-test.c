@@ -0,0 +1,120 @@
+/*
+ * Test ServerStaticCursors. A static cursor is backed by a server side
+ * scroll cursor, with only a window of the rows in memory, but behaves
+ * like one read into memory in full.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static SQLINTEGER	colvalue;
+static SQLLEN		indColvalue;
+
+/* nextval() is called for each row the cursor passes over */
+static int
+get_sequence_value(void)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLINTEGER	value;
+	SQLLEN		ind;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT last_value FROM server_static_seq", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_SLONG, &value, 0, &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+
+	return (int) value;
+}
+
+static void
+fetch_and_print(HSTMT hstmt, SQLSMALLINT orientation, SQLLEN offset, char *msg)
+{
+	int			rc;
+	SQLULEN		rownum;
+
+	rc = SQLFetchScroll(hstmt, orientation, offset);
+	if (SQL_NO_DATA == rc)
+	{
+		printf("%s: no data\n", msg);
+		return;
+	}
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	rc = SQLGetStmtAttr(hstmt, SQL_ATTR_ROW_NUMBER, &rownum, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetStmtAttr failed", hstmt);
+	printf("%s: %d (row number %d)\n", msg, (int) colvalue, (int) rownum);
+}
+
+int main(int argc, char **argv)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLLEN		rowcount;
+	int			seqval;
+
+	test_connect_ext("ServerStaticCursors=1;Fetch=10");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY SEQUENCE server_static_seq", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE,
+						(SQLPOINTER) SQL_CURSOR_STATIC, SQL_IS_UINTEGER);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_LONG, &colvalue, 0, &indColvalue);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g, nextval('server_static_seq') FROM generate_series(1, 55) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	/* The row count is known as with a static cursor read in full */
+	rc = SQLRowCount(hstmt, &rowcount);
+	CHECK_STMT_RESULT(rc, "SQLRowCount failed", hstmt);
+	printf("row count: %d\n", (int) rowcount);
+
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 42, "absolute 42");
+	fetch_and_print(hstmt, SQL_FETCH_PRIOR, 0, "prior");
+	fetch_and_print(hstmt, SQL_FETCH_LAST, 0, "last");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, -20, "absolute -20");
+	fetch_and_print(hstmt, SQL_FETCH_RELATIVE, -30, "relative -30");
+	fetch_and_print(hstmt, SQL_FETCH_FIRST, 0, "first");
+	fetch_and_print(hstmt, SQL_FETCH_PRIOR, 0, "prior");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 12, "absolute 12");
+
+	/* Counted already, so the cursor isn't moved to the end again */
+	seqval = get_sequence_value();
+	rc = SQLRowCount(hstmt, &rowcount);
+	CHECK_STMT_RESULT(rc, "SQLRowCount failed", hstmt);
+	printf("row count: %d\n", (int) rowcount);
+	printf("cursor moved: %d\n", get_sequence_value() != seqval);
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
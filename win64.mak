@@ -90,6 +90,9 @@ ADD_DEFINES = $(ADD_DEFINES) /D "DYNAMIC_LOAD"
 !IF "$(MSDTC)" != "no"
 ADD_DEFINES = $(ADD_DEFINES) /D "_HANDLE_ENLIST_IN_DTC_"
 !ENDIF
+!IF "$(PIPELINE_MODE)" == "no"
+ADD_DEFINES = $(ADD_DEFINES) /D "NO_PIPELINE_MODE"
+!ENDIF
 !IF "$(MEMORY_DEBUG)" == "yes"
 ADD_DEFINES = $(ADD_DEFINES) /D "_MEMORY_DEBUG_" /GS
 !ENDIF
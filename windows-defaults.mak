@@ -15,3 +15,8 @@ PG_LIB=$(PROGRAMFILES)\PostgreSQL\9.6\lib
 # Enable/disable features
 
 MSDTC = yes
+
+# The pipeline mode of libpq is used when PG_INC has the headers of
+# PostgreSQL 14 or later. Set this to "no" if the driver may be loaded
+# with an older libpq.dll than the headers.
+PIPELINE_MODE = yes